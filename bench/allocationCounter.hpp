@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+
+// replaces the global operator new and delete with ones that count, so include it from the one
+// source file of a bench and nowhere else
+namespace bench {
+// the texture cache decodes on worker threads, so these can be bumped from anywhere
+inline std::atomic<size_t> live_bytes{0};
+inline std::atomic<size_t> allocation_count{0};
+
+// every block carries its size in front of it so delete can take it off again
+inline constexpr size_t ALLOCATION_HEADER_SIZE = alignof(std::max_align_t);
+}  // namespace bench
+
+void* operator new(size_t size) {
+    void* block = std::malloc(size + bench::ALLOCATION_HEADER_SIZE);
+    if (!block) throw std::bad_alloc();
+
+    *static_cast<size_t*>(block) = size;
+    bench::live_bytes += size;
+    bench::allocation_count++;
+    return static_cast<char*>(block) + bench::ALLOCATION_HEADER_SIZE;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+
+    void* block = static_cast<char*>(pointer) - bench::ALLOCATION_HEADER_SIZE;
+    bench::live_bytes -= *static_cast<size_t*>(block);
+    std::free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "core/engine/audio.hpp"
+#include "core/utils.hpp"
+
+
+// small helpers shared by the benchmark harnesses, every bench is a plain executable that prints
+// its numbers to stdout
+namespace bench {
+using clock = std::chrono::steady_clock;
+
+inline double millisecondsSince(clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+}
+
+template <typename Fn>
+double timeMilliseconds(Fn&& fn) {
+    auto start = clock::now();
+    fn();
+    return millisecondsSince(start);
+}
+
+// best of a few runs, the minimum is the least noisy number on a busy machine
+template <typename Fn>
+double bestOf(int runs, Fn&& fn) {
+    double best = timeMilliseconds(fn);
+    for (int i = 1; i < runs; i++) best = std::min(best, timeMilliseconds(fn));
+    return best;
+}
+
+// sorted so every run walks the files in the same order
+inline std::vector<std::string> findFiles(const std::string& directory,
+                                          const std::string& extension) {
+    std::vector<std::string> files;
+
+    std::error_code ec;
+    auto options = std::filesystem::directory_options::skip_permission_denied;
+    for (auto it = std::filesystem::recursive_directory_iterator(directory, options, ec);
+         it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) break;
+        if (it->is_regular_file(ec) && it->path().extension() == extension)
+            files.push_back(it->path().string());
+    }
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// the asset dir next to the executable unless one is passed in
+inline std::string assetDir(int argc, char* argv[]) {
+    if (argc > 1) return argv[1];
+    return vsrg::joinPaths(vsrg::getExecutableDir(), "assets");
+}
+
+// a conductor needs a loaded song, this is a second of silence written to the temp dir. the
+// harnesses seek it to whatever time they want and never play it
+inline vsrg::Audio* loadSilentAudio(vsrg::AudioManager& audio_manager) {
+    const uint32_t sample_rate = 44100;
+    const uint32_t data_size = sample_rate * sizeof(int16_t);
+
+    std::string path = (std::filesystem::temp_directory_path() / "vsrg-bench-silence.wav").string();
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        auto write = [&file](auto value) {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+
+        // 16 bit mono pcm
+        file.write("RIFF", 4);
+        write(uint32_t(36 + data_size));
+        file.write("WAVEfmt ", 8);
+        write(uint32_t(16));
+        write(uint16_t(1));
+        write(uint16_t(1));
+        write(sample_rate);
+        write(uint32_t(sample_rate * sizeof(int16_t)));
+        write(uint16_t(sizeof(int16_t)));
+        write(uint16_t(16));
+        file.write("data", 4);
+        write(data_size);
+
+        std::vector<char> silence(data_size, 0);
+        file.write(silence.data(), silence.size());
+    }
+
+    return audio_manager.load_audio(path).audio;
+}
+}  // namespace bench
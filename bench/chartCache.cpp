@@ -0,0 +1,103 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "bench.hpp"
+#include "rhythm/charts/chartCache.hpp"
+#include "rhythm/charts/mania.hpp"
+
+using namespace mania;
+
+// cold text parsing vs warm text parsing vs loading the compiled cache through mmap, over every
+// chart in the asset folder
+// usage: vsrg-bench-chartCache [asset dir]
+
+namespace {
+const int RUNS = 20;
+
+// drops the file from the page cache so the next read has to hit the disk. only does something
+// on linux, elsewhere the cold numbers are really warm ones
+void evictFromPageCache(const std::string& path) {
+#ifdef __linux__
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+#else
+    (void)path;
+#endif
+}
+
+void printRow(const std::string& name, double total_ms, size_t chart_count) {
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(10) << total_ms << " ms total"
+              << std::setw(10) << total_ms / chart_count << " ms/chart" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> charts =
+        bench::findFiles(vsrg::joinPaths(bench::assetDir(argc, argv), "charts"), ".osu");
+    if (charts.empty()) {
+        std::cerr << "no charts found" << std::endl;
+        return 1;
+    }
+
+    ManiaLoader loader;
+    size_t note_count = 0;
+
+    double cold_parse = 0.0;
+    for (const auto& chart : charts) {
+        evictFromPageCache(chart);
+        ChartData data;
+        cold_parse += bench::timeMilliseconds([&] { loader.loadChart(chart, data); });
+        note_count += data.notes.size();
+
+        if (!writeChartCache(chart, data)) {
+            std::cerr << "could not write the cache for " << chart << std::endl;
+            return 1;
+        }
+    }
+
+    double warm_parse = 0.0;
+    for (const auto& chart : charts) {
+        warm_parse += bench::bestOf(RUNS, [&] {
+            ChartData data;
+            loader.loadChart(chart, data);
+        });
+    }
+
+    double cold_cache = 0.0;
+    for (const auto& chart : charts) {
+        evictFromPageCache(getChartCachePath(chart));
+        ChartData data;
+        cold_cache += bench::timeMilliseconds([&] { readChartCache(chart, data); });
+    }
+
+    double warm_cache = 0.0;
+    for (const auto& chart : charts) {
+        bool hit = true;
+        warm_cache += bench::bestOf(RUNS, [&] {
+            ChartData data;
+            hit &= readChartCache(chart, data);
+        });
+        if (!hit) {
+            std::cerr << "cache miss for " << chart << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << charts.size() << " charts, " << note_count << " notes" << std::endl;
+    printRow("cold parse", cold_parse, charts.size());
+    printRow("warm parse", warm_parse, charts.size());
+    printRow("cold cache", cold_cache, charts.size());
+    printRow("warm cache", warm_cache, charts.size());
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "core/mappedFile.hpp"
+#include "rhythm/charts/mania.hpp"
+
+using namespace mania;
+
+// parse throughput of ManiaLoader in MB/s and notes/s, with the files already in memory so only
+// the tokenizer is measured
+// usage: vsrg-bench-chartParse [asset dir]
+
+namespace {
+const int RUNS = 50;
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> charts =
+        bench::findFiles(vsrg::joinPaths(bench::assetDir(argc, argv), "charts"), ".osu");
+    if (charts.empty()) {
+        std::cerr << "no charts found" << std::endl;
+        return 1;
+    }
+
+    ManiaLoader loader;
+    double total_bytes = 0.0, total_notes = 0.0, total_ms = 0.0, metadata_ms = 0.0;
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& chart : charts) {
+        vsrg::MappedFile file(chart);
+        if (!file.isOpen()) continue;
+
+        ChartData data;
+        double ms = bench::bestOf(RUNS, [&] { loader.parseChart(file.getView(), data); });
+        metadata_ms += bench::bestOf(RUNS, [&] {
+            ChartMetadata metadata;
+            loader.parseMetadata(file.getView(), metadata);
+        });
+
+        double seconds = ms / 1000.0;
+        std::cout << std::setw(8) << file.getSize() / seconds / 1e6 << " MB/s "
+                  << std::setw(12) << data.notes.size() / seconds << " notes/s  "
+                  << data.metadata.title << " [" << data.metadata.difficulty << "]" << std::endl;
+
+        total_bytes += file.getSize();
+        total_notes += data.notes.size();
+        total_ms += ms;
+    }
+
+    double seconds = total_ms / 1000.0;
+    std::cout << std::setw(8) << total_bytes / seconds / 1e6 << " MB/s " << std::setw(12)
+              << total_notes / seconds << " notes/s  total" << std::endl;
+    std::cout << std::setprecision(3) << "metadata only: " << metadata_ms / charts.size()
+              << " ms/chart" << std::endl;
+    return 0;
+}
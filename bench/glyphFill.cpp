@@ -0,0 +1,151 @@
+#include <glad/glad.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "core/ui/font.hpp"
+#include "core/utils.hpp"
+#include "headless.hpp"
+
+// time to fill the glyph cache with every cjk charcode the font maps (kana, the unified
+// ideographs, full width forms), bitmap against sdf. preloadGlyphs renders the whole list on
+// worker threads and uploads it in one go, on demand is getCharacter for all of them and
+// processUploads once a frame until every glyph is in. each run gets a font of its own with
+// enough atlas pages that nothing is evicted
+// usage: vsrg-bench-glyphFill [font, a name in assets/fonts or a path]
+
+namespace {
+const size_t ATLAS_PAGES = 32;
+
+bool isCjk(vsrg::Charcode charcode) {
+    return (charcode >= 0x3000 && charcode <= 0x30FF) ||  // punctuation, kana
+           (charcode >= 0x4E00 && charcode <= 0x9FFF) ||  // unified ideographs
+           (charcode >= 0xFF00 && charcode <= 0xFFEF);    // full width forms
+}
+
+// the cjk charcodes of the face. a font without any gets every non ascii charcode it has, so the
+// harness still runs somewhere without a cjk font
+std::vector<vsrg::Charcode> collectCharcodes(FT_Library ft, const std::string& path, bool& cjk) {
+    std::vector<vsrg::Charcode> cjk_codes, other_codes;
+
+    FT_Face face;
+    if (FT_New_Face(ft, path.c_str(), 0, &face)) return {};
+
+    FT_UInt glyph_index;
+    for (FT_ULong charcode = FT_Get_First_Char(face, &glyph_index); glyph_index != 0;
+         charcode = FT_Get_Next_Char(face, charcode, &glyph_index)) {
+        if (isCjk(charcode)) {
+            cjk_codes.push_back(charcode);
+        } else if (charcode >= 128) {
+            other_codes.push_back(charcode);
+        }
+    }
+    FT_Done_Face(face);
+
+    cjk = !cjk_codes.empty();
+    return cjk ? cjk_codes : other_codes;
+}
+
+std::unique_ptr<vsrg::Font> makeFont(vsrg::EngineContext* ctx, FT_Library ft,
+                                     const std::string& path, vsrg::FontRenderMode mode) {
+    auto font = std::make_unique<vsrg::Font>(ctx, ft, path, vsrg::FONT_DEFAULT_SIZE_PT, mode);
+    font->setMaxAtlasPages(ATLAS_PAGES);
+    return font;
+}
+
+double fillPreload(vsrg::Font& font, const std::vector<vsrg::Charcode>& charcodes) {
+    return bench::timeMilliseconds([&] {
+        font.preloadGlyphs(charcodes);
+        glFinish();
+    });
+}
+
+// frames is how many processUploads it took
+double fillOnDemand(vsrg::Font& font, const std::vector<vsrg::Charcode>& charcodes, int& frames) {
+    frames = 0;
+    return bench::timeMilliseconds([&] {
+        for (auto charcode : charcodes) font.getCharacter(charcode);
+
+        size_t next = 0;  // everything before it has landed (or cant be rendered)
+        while (next < charcodes.size()) {
+            if (font.processUploads(vsrg::FONT_UPLOAD_BUDGET_BYTES) == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            frames++;
+
+            while (next < charcodes.size()) {
+                const vsrg::Character* character = font.getCharacter(charcodes[next]);
+                if (character && font.isPlaceholder(character)) break;
+                next++;
+            }
+        }
+        glFinish();
+    });
+}
+
+void printRow(const std::string& name, double ms, const vsrg::Font& font, int frames = 0) {
+    vsrg::FontAtlasStats stats = font.getAtlasStats();
+    std::cout << std::left << std::setw(18) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(9) << ms << " ms" << std::setw(7)
+              << stats.glyphs << " glyphs" << std::setw(4) << stats.pages << " pages";
+    if (frames > 0) std::cout << std::setw(6) << frames << " frames";
+    std::cout << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = vsrg::joinPaths(vsrg::getExecutableDir(), "assets/fonts",
+                                       argc > 1 ? argv[1] : "NotoSansJP-Regular.ttf");
+
+    auto client = bench::createHeadlessClient();
+    if (!client) {
+        std::cerr << "could not create a gl context" << std::endl;
+        return 1;
+    }
+    vsrg::EngineContext* ctx = client->get_engine_context();
+
+    FT_Library ft;
+    if (FT_Init_FreeType(&ft)) return 1;
+
+    bool cjk;
+    std::vector<vsrg::Charcode> charcodes = collectCharcodes(ft, path, cjk);
+    if (charcodes.empty()) {
+        std::cerr << "could not load " << path << std::endl;
+        FT_Done_FreeType(ft);
+        return 1;
+    }
+
+    std::cout << charcodes.size() << (cjk ? " cjk" : " non ascii (the font has no cjk)")
+              << " charcodes, " << std::thread::hardware_concurrency() << " hardware threads"
+              << std::endl;
+
+    {
+        auto font = makeFont(ctx, ft, path, vsrg::FontRenderMode::BITMAP);
+        printRow("bitmap preload", fillPreload(*font, charcodes), *font);
+    }
+    {
+        auto font = makeFont(ctx, ft, path, vsrg::FontRenderMode::SDF);
+        printRow("sdf preload", fillPreload(*font, charcodes), *font);
+    }
+    {
+        auto font = makeFont(ctx, ft, path, vsrg::FontRenderMode::BITMAP);
+        int frames;
+        double ms = fillOnDemand(*font, charcodes, frames);
+        printRow("bitmap on demand", ms, *font, frames);
+    }
+    {
+        auto font = makeFont(ctx, ft, path, vsrg::FontRenderMode::SDF);
+        int frames;
+        double ms = fillOnDemand(*font, charcodes, frames);
+        printRow("sdf on demand", ms, *font, frames);
+    }
+
+    FT_Done_FreeType(ft);
+    return 0;
+}
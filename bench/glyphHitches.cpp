@@ -0,0 +1,207 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "core/ui/font.hpp"
+#include "core/ui/textComponent.hpp"
+#include "core/utils.hpp"
+#include "headless.hpp"
+
+// frame times of a song list scrolling through titles nobody has drawn yet, every frame brings
+// one with 24 new cjk glyphs. cold is the glyphs being requested as the titles show up, prewarmed
+// is prewarmGlyphs over every title first the way the plugin does for the song library. frame
+// time is the gl thread's own work: processUploads, the new title and drawing the 30 on screen
+// usage: vsrg-bench-glyphHitches [font, a name in assets/fonts or a path]
+
+namespace {
+const int FRAME_COUNT = 150;
+const int GLYPHS_PER_TITLE = 24;
+const size_t VISIBLE_TITLES = 30;
+const double FRAME_MS = 1000.0 / 240.0;
+
+bool isCjk(vsrg::Charcode charcode) {
+    return (charcode >= 0x3000 && charcode <= 0x30FF) ||
+           (charcode >= 0x4E00 && charcode <= 0x9FFF) ||
+           (charcode >= 0xFF00 && charcode <= 0xFFEF);
+}
+
+void appendUTF8(std::string& text, vsrg::Charcode charcode) {
+    if (charcode < 0x80) {
+        text += static_cast<char>(charcode);
+    } else if (charcode < 0x800) {
+        text += static_cast<char>(0xC0 | (charcode >> 6));
+        text += static_cast<char>(0x80 | (charcode & 0x3F));
+    } else {
+        text += static_cast<char>(0xE0 | (charcode >> 12));
+        text += static_cast<char>(0x80 | ((charcode >> 6) & 0x3F));
+        text += static_cast<char>(0x80 | (charcode & 0x3F));
+    }
+}
+
+// titles from the cjk charcodes of the face, or any it has past latin-1 if there are none
+std::vector<std::string> makeTitles(FT_Library ft, const std::string& path, bool& cjk) {
+    std::vector<vsrg::Charcode> cjk_codes, other_codes;
+
+    FT_Face face;
+    if (FT_New_Face(ft, path.c_str(), 0, &face)) return {};
+
+    FT_UInt glyph_index;
+    for (FT_ULong charcode = FT_Get_First_Char(face, &glyph_index); glyph_index != 0;
+         charcode = FT_Get_Next_Char(face, charcode, &glyph_index)) {
+        if (isCjk(charcode)) {
+            cjk_codes.push_back(charcode);
+        } else if (charcode >= 0x100 && charcode < 0x10000) {
+            other_codes.push_back(charcode);
+        }
+    }
+    FT_Done_Face(face);
+
+    cjk = !cjk_codes.empty();
+    const std::vector<vsrg::Charcode>& codes = cjk ? cjk_codes : other_codes;
+    if (codes.empty()) return {};
+
+    std::vector<std::string> titles;
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        std::string title = "Title ";
+        for (int i = 0; i < GLYPHS_PER_TITLE; i++) {
+            appendUTF8(title, codes[(frame * GLYPHS_PER_TITLE + i) % codes.size()]);
+        }
+        titles.push_back(title);
+    }
+    return titles;
+}
+
+struct Result {
+    std::vector<double> frames;  // the gl thread's time per frame, sorted
+    size_t pending = 0;          // glyphs of the titles still not in when the scrolling stops
+    size_t missing = 0;          // and the ones the font gave up on
+};
+
+Result scroll(vsrg::EngineContext* ctx, FT_Library ft, const std::string& path,
+                           vsrg::FontRenderMode mode, const std::vector<std::string>& titles,
+                           bool prewarm) {
+    vsrg::Font font(ctx, ft, path, vsrg::FONT_DEFAULT_SIZE_PT, mode);
+
+    if (prewarm) {
+        std::vector<vsrg::Charcode> charcodes;
+        for (const auto& title : titles) {
+            std::vector<vsrg::Charcode> decoded = vsrg::TextComponent::decodeUTF8(title);
+            charcodes.insert(charcodes.end(), decoded.begin(), decoded.end());
+        }
+        font.prewarmGlyphs(charcodes);
+
+        // the list only opens once the worker is through, getCharacter would jump the queue
+        uint64_t generation = font.getGlyphGeneration();
+        for (int idle = 0; idle < 50; idle++) {
+            font.processUploads(vsrg::FONT_UPLOAD_BUDGET_BYTES);
+            if (font.getGlyphGeneration() != generation) idle = 0;
+            generation = font.getGlyphGeneration();
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+
+    std::vector<std::unique_ptr<vsrg::TextComponent>> texts;
+    Result result;
+    std::vector<double>& frames = result.frames;
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        double ms = bench::timeMilliseconds([&] {
+            font.processUploads(vsrg::FONT_UPLOAD_BUDGET_BYTES);
+
+            auto text = std::make_unique<vsrg::TextComponent>(
+                ctx, &font, titles[frame], vsrg::TextRenderOptions{glm::vec3(1.0f), 18.0f, 1.0f});
+            vsrg::ComponentProperties properties;
+            properties.position = glm::vec2(8.0f, 8.0f + (frame % VISIBLE_TITLES) * 22.0f);
+            text->setProperties(properties);
+            texts.push_back(std::move(text));
+            if (texts.size() > VISIBLE_TITLES) texts.erase(texts.begin());
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            for (auto& text : texts) text->render();
+        });
+        glFinish();
+        frames.push_back(ms);
+
+        // the rest of the frame is when the worker gets to run on a machine with few cores
+        if (ms < FRAME_MS) {
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(FRAME_MS - ms));
+        }
+    }
+
+    // a cheap frame can also mean its glyphs just never showed up
+    for (const auto& title : titles) {
+        for (vsrg::Charcode charcode : vsrg::TextComponent::decodeUTF8(title)) {
+            const vsrg::Character* character = font.getCharacter(charcode);
+            if (!character) {
+                result.missing++;
+            } else if (font.isPlaceholder(character)) {
+                result.pending++;
+            }
+        }
+    }
+
+    // cached layouts point at the font, which goes away with this run. nothing else in the
+    // harness draws text
+    texts.clear();
+    ctx->get_font_manager()->getLayoutCache().clear();
+
+    // the first frame compiles the text shader
+    frames.erase(frames.begin());
+    std::sort(frames.begin(), frames.end());
+    return result;
+}
+
+void printRow(const std::string& name, const Result& result) {
+    const std::vector<double>& frames = result.frames;
+    double total = 0.0;
+    for (double ms : frames) total += ms;
+
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed
+              << std::setprecision(2) << " mean " << std::setw(6) << total / frames.size()
+              << "  p50 " << std::setw(6) << frames[frames.size() / 2] << "  p99 " << std::setw(6)
+              << frames[frames.size() * 99 / 100] << "  worst " << std::setw(6) << frames.back()
+              << " ms" << std::setw(6) << result.pending << " pending" << std::setw(6)
+              << result.missing << " missing" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = vsrg::joinPaths(vsrg::getExecutableDir(), "assets/fonts",
+                                       argc > 1 ? argv[1] : "NotoSansJP-Regular.ttf");
+
+    auto client = bench::createHeadlessClient();
+    if (!client) {
+        std::cerr << "could not create a gl context" << std::endl;
+        return 1;
+    }
+    vsrg::EngineContext* ctx = client->get_engine_context();
+
+    FT_Library ft;
+    if (FT_Init_FreeType(&ft)) return 1;
+
+    bool cjk;
+    std::vector<std::string> titles = makeTitles(ft, path, cjk);
+    if (titles.empty()) {
+        std::cerr << "could not load " << path << std::endl;
+        FT_Done_FreeType(ft);
+        return 1;
+    }
+
+    std::cout << FRAME_COUNT << " titles of " << GLYPHS_PER_TITLE
+              << (cjk ? " cjk glyphs" : " non latin glyphs (the font has no cjk)")
+              << ", gl thread ms per frame" << std::endl;
+    printRow("bitmap cold", scroll(ctx, ft, path, vsrg::FontRenderMode::BITMAP, titles, false));
+    printRow("bitmap prewarmed", scroll(ctx, ft, path, vsrg::FontRenderMode::BITMAP, titles, true));
+    printRow("sdf cold", scroll(ctx, ft, path, vsrg::FontRenderMode::SDF, titles, false));
+    printRow("sdf prewarmed", scroll(ctx, ft, path, vsrg::FontRenderMode::SDF, titles, true));
+
+    FT_Done_FreeType(ft);
+    return 0;
+}
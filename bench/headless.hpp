@@ -0,0 +1,25 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <SDL3/SDL.h>
+
+#include <memory>
+
+#include "core/app.hpp"
+#include "offscreen.hpp"
+
+
+namespace bench {
+// a client on sdl's offscreen video driver, for harnesses that need gl and a full engine context.
+// nothing is shown and start() is never called, drawing goes to an offscreen framebuffer.
+// nullptr when there is no gl to be had
+inline std::unique_ptr<vsrg::Client> createHeadlessClient(int width = 1280, int height = 720) {
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+
+    auto client = std::make_unique<vsrg::Client>(width, height);
+    if (!client->is_initialized()) return nullptr;
+    if (!test::bindOffscreenFramebuffer(width, height)) return nullptr;
+
+    return client;
+}
+}  // namespace bench
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/ui/spriteComponent.hpp"
+#include "public/engineContext.hpp"
+#include "rhythm/charts/chartData.hpp"
+#include "rhythm/strum.hpp"
+
+
+// the per note object graph Playfield built before NoteStore, kept so noteMemory has something
+// to compare against. same members, sprites and construction as the old Note and HoldNote
+namespace legacy {
+class Note : public mania::Strum {
+public:
+    Note(vsrg::EngineContext* ctx, const std::string& sprite_path, int column, float time)
+        : Strum(ctx, sprite_path, column), time(time) {
+        properties.render_size = glm::vec2(64.0f, 64.0f);
+    }
+
+    float getTime() const { return time; }
+
+private:
+    float time;
+    int type = 0;
+
+    bool can_render = false;
+    float speed_mod = 1.0f;
+    bool despawned = false;
+};
+
+class HoldNote : public Note {
+public:
+    HoldNote(vsrg::EngineContext* ctx, const std::string& sprite_path, int column, float time,
+             float end_time)
+        : Note(ctx, sprite_path, column, time), end_time(end_time) {
+        hold_body_path = "holdBody" + std::to_string(column) + ".png";
+        hold_end_path = "holdEnd" + std::to_string(column) + ".png";
+
+        hold_body_sprite = std::make_unique<vsrg::SpriteComponent>(ctx, hold_body_path);
+        hold_body_sprite->setRenderMode(vsrg::RenderMode::Stretch);
+
+        hold_end_sprite = std::make_unique<vsrg::SpriteComponent>(ctx, hold_end_path);
+        hold_end_sprite->setRenderMode(vsrg::RenderMode::Stretch);
+    }
+
+private:
+    float end_time;
+    bool is_holding = false;
+    bool is_fading_out = false;
+
+    float end_y = 0.0f;
+    float hold_end_height = -1.0f;
+
+    std::string hold_body_path;
+    std::string hold_end_path;
+
+    std::unique_ptr<vsrg::SpriteComponent> hold_body_sprite;
+    std::unique_ptr<vsrg::SpriteComponent> hold_end_sprite;
+};
+
+// what Playfield::createNotesAsync used to do for every chart note
+inline std::vector<Note*> createNotes(vsrg::EngineContext* ctx, const mania::ChartData& chart,
+                                      int key_count) {
+    const float strum_width = 96.0f;
+    float start_x = (ctx->get_screen_width() - strum_width * key_count) / 2.0f;
+
+    std::vector<Note*> notes;
+    for (const auto& chart_note : chart.notes) {
+        if (chart_note.column >= key_count) continue;
+
+        std::string sprite_path = "note" + std::to_string(chart_note.column) + ".png";
+
+        Note* note;
+        if (chart_note.type == mania::VSRGNoteType::HOLD) {
+            note = new HoldNote(ctx, sprite_path, chart_note.column, chart_note.time,
+                                chart_note.end_time);
+        } else if (chart_note.type == mania::VSRGNoteType::MINE) {
+            note = new Note(ctx, "mine.png", chart_note.column, chart_note.time);
+        } else {
+            note = new Note(ctx, sprite_path, chart_note.column, chart_note.time);
+        }
+
+        note->setPosition(start_x + chart_note.column * strum_width, -100.0f);
+        note->setSize(strum_width, strum_width);
+        notes.push_back(note);
+    }
+
+    return notes;
+}
+}  // namespace legacy
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+
+#include "rhythm/math/scroll.hpp"
+#include "rhythm/timingMap.hpp"
+
+
+// the per call scroll math ScrollSpeedCalculator had before the position table, kept so the scroll
+// benches have something to compare against. the timing points stand in for the old conductor,
+// which handed them out by value and looked bpm up with a linear scan
+namespace legacy {
+class ScrollSpeedCalculator {
+public:
+    ScrollSpeedCalculator(std::vector<vsrg::TimingPoint> timing_points)
+        : timing_points(std::move(timing_points)) {}
+
+    void setXMod(float multiplier) {
+        mode = mania::ScrollSpeedMode::XMOD;
+        value = multiplier;
+    }
+    void setCMod(float constant_speed) {
+        mode = mania::ScrollSpeedMode::CMOD;
+        value = constant_speed;
+    }
+
+    float calculateNoteYPosition(float note_time, float current_time, float strum_line_y) const {
+        float time_diff = note_time - current_time;
+
+        if (mode == mania::ScrollSpeedMode::CMOD) {
+            return strum_line_y - time_diff * pixelsPerSecond(0.0f);
+        }
+
+        float distance;
+        if (note_time >= current_time) {
+            distance = calculateDistanceThroughSections(current_time, note_time);
+        } else {
+            distance = -calculateDistanceThroughSections(note_time, current_time);
+        }
+
+        return strum_line_y - distance;
+    }
+
+private:
+    mania::ScrollSpeedMode mode = mania::ScrollSpeedMode::XMOD;
+    float value = 1.0f;
+    std::vector<vsrg::TimingPoint> timing_points;
+
+    // Conductor::get_timing_points
+    std::vector<vsrg::TimingPoint> getTimingPoints() const { return timing_points; }
+
+    // Conductor::get_bpm_at_time
+    float getBPMAtTime(float time) const {
+        if (timing_points.empty()) return 120.0f;
+
+        size_t found_index = 0;
+        for (size_t i = 0; i < timing_points.size(); ++i) {
+            if (time >= timing_points[i].time) {
+                found_index = i;
+            } else {
+                break;
+            }
+        }
+
+        return timing_points[found_index].bpm;
+    }
+
+    float pixelsPerSecond(float bpm) const {
+        if (mode == mania::ScrollSpeedMode::CMOD) return (value / 60.0f) * 64.0f;
+        return bpm * value * (64.0f / 60.0f);
+    }
+
+    float calculateDistanceThroughSections(float from_time, float to_time) const {
+        const auto& all_points = getTimingPoints();
+
+        float total_distance = 0.0f;
+        float section_start = from_time;
+
+        for (const auto& point : all_points) {
+            if (point.time > from_time && point.time <= to_time) {
+                float section_end = point.time;
+                total_distance +=
+                    (section_end - section_start) * pixelsPerSecond(getBPMAtTime(section_start));
+                section_start = section_end;
+            }
+        }
+
+        if (section_start < to_time) {
+            total_distance +=
+                (to_time - section_start) * pixelsPerSecond(getBPMAtTime(section_start));
+        }
+
+        return total_distance;
+    }
+};
+}  // namespace legacy
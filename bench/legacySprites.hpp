@@ -0,0 +1,225 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <vector>
+
+#include "core/engine/shader.hpp"
+#include "public/engineContext.hpp"
+
+
+// the sprite batcher as it was before the stream buffer, packed vertices and sort keys, kept so
+// the sprite benches have something to compare against. a batch per texture and layer found by a
+// linear search, 6 full vertices per quad from a mat4, glBufferSubData into one vbo per draw.
+// it takes gl texture ids, the old texture lookup by path is left out of it
+namespace legacy {
+struct SpriteVertex {
+    glm::vec2 position;
+    glm::vec2 tex_coords;
+    float opacity;
+    float z_order;
+};
+
+struct SpriteBatch {
+    GLuint texture_id;
+    int layer;
+    std::vector<SpriteVertex> vertices;
+    size_t sprite_count = 0;
+};
+
+class SpriteRenderer {
+public:
+    static constexpr size_t MAX_BATCH_SIZE = 1000;
+
+    SpriteRenderer(vsrg::EngineContext* engine_context) : engine_context(engine_context) {
+        shader_program = vsrg::createShaderProgram(engine_context, VERTEX_SHADER, FRAGMENT_SHADER);
+        projection_uniform = glGetUniformLocation(shader_program, "projection");
+        texture_uniform = glGetUniformLocation(shader_program, "sprite_texture");
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteVertex) * 6 * MAX_BATCH_SIZE, nullptr,
+                     GL_DYNAMIC_DRAW);
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex),
+                              (void*)offsetof(SpriteVertex, position));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex),
+                              (void*)offsetof(SpriteVertex, tex_coords));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex),
+                              (void*)offsetof(SpriteVertex, opacity));
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex),
+                              (void*)offsetof(SpriteVertex, z_order));
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    }
+
+    ~SpriteRenderer() {
+        if (shader_program) glDeleteProgram(shader_program);
+        if (vao) glDeleteVertexArrays(1, &vao);
+        if (vbo) glDeleteBuffers(1, &vbo);
+    }
+
+    SpriteRenderer(const SpriteRenderer&) = delete;
+    SpriteRenderer& operator=(const SpriteRenderer&) = delete;
+
+    void begin() { batches.clear(); }
+
+    void drawSprite(GLuint texture_id, const glm::vec2& position, const glm::vec2& size,
+                    float rotation = 0.0f, const glm::vec2& anchor = glm::vec2(0.0f),
+                    const glm::vec2& scale = glm::vec2(1.0f), float opacity = 1.0f,
+                    int layer = 0) {
+        SpriteBatch* batch = getBatch(texture_id, layer);
+
+        if (batch->sprite_count >= MAX_BATCH_SIZE) {
+            flush();
+            batch = getBatch(texture_id, layer);
+        }
+
+        glm::vec2 scaled_size = size * scale;
+        glm::vec2 anchor_offset = scaled_size * anchor;
+
+        glm::mat4 transform = glm::mat4(1.0f);
+        transform = glm::translate(transform, glm::vec3(position, 0.0f));
+        transform = glm::translate(transform, glm::vec3(-anchor_offset, 0.0f));
+
+        if (rotation != 0.0f) {
+            transform =
+                glm::rotate(transform, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+        }
+
+        if (scale != glm::vec2(1.0f)) {
+            transform = glm::scale(transform, glm::vec3(scale, 1.0f));
+        }
+
+        glm::vec4 corners[4] = {transform * glm::vec4(0.0f, size.y, 0.0f, 1.0f),
+                                transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
+                                transform * glm::vec4(size.x, 0.0f, 0.0f, 1.0f),
+                                transform * glm::vec4(size.x, size.y, 0.0f, 1.0f)};
+
+        glm::vec2 tex_coords[4] = {{0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}};
+
+        float z_value = layer * 0.1f;
+
+        batch->vertices.push_back({glm::vec2(corners[0]), tex_coords[0], opacity, z_value});
+        batch->vertices.push_back({glm::vec2(corners[1]), tex_coords[1], opacity, z_value});
+        batch->vertices.push_back({glm::vec2(corners[2]), tex_coords[2], opacity, z_value});
+
+        batch->vertices.push_back({glm::vec2(corners[0]), tex_coords[0], opacity, z_value});
+        batch->vertices.push_back({glm::vec2(corners[2]), tex_coords[2], opacity, z_value});
+        batch->vertices.push_back({glm::vec2(corners[3]), tex_coords[3], opacity, z_value});
+
+        batch->sprite_count++;
+    }
+
+    void end() { flush(); }
+
+    void flush() {
+        if (batches.empty()) return;
+
+        std::sort(batches.begin(), batches.end(),
+                  [](const SpriteBatch& a, const SpriteBatch& b) { return a.layer < b.layer; });
+
+        glUseProgram(shader_program);
+
+        glm::mat4 projection = glm::ortho(0.0f, (float)engine_context->get_screen_width(),
+                                          (float)engine_context->get_screen_height(), 0.0f);
+        glUniformMatrix4fv(projection_uniform, 1, GL_FALSE, glm::value_ptr(projection));
+
+        glBindVertexArray(vao);
+        glActiveTexture(GL_TEXTURE0);
+        glUniform1i(texture_uniform, 0);
+
+        for (auto& batch : batches) {
+            if (batch.vertices.empty()) continue;
+
+            glBindTexture(GL_TEXTURE_2D, batch.texture_id);
+
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(SpriteVertex) * batch.vertices.size(),
+                            batch.vertices.data());
+
+            glDrawArrays(GL_TRIANGLES, 0, batch.vertices.size());
+        }
+
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glUseProgram(0);
+
+        batches.clear();
+    }
+
+private:
+    static constexpr const char* VERTEX_SHADER = R"glsl(
+        #version 330 core
+        layout (location = 0) in vec2 position;
+        layout (location = 1) in vec2 tex_coords;
+        layout (location = 2) in float opacity;
+        layout (location = 3) in float z_order;
+
+        out vec2 v_tex_coords;
+        out float v_opacity;
+
+        uniform mat4 projection;
+
+        void main() {
+            gl_Position = projection * vec4(position, z_order, 1.0);
+            v_tex_coords = tex_coords;
+            v_opacity = opacity;
+        }
+    )glsl";
+
+    static constexpr const char* FRAGMENT_SHADER = R"glsl(
+        #version 330 core
+        in vec2 v_tex_coords;
+        in float v_opacity;
+
+        out vec4 frag_color;
+
+        uniform sampler2D sprite_texture;
+
+        void main() {
+            vec4 sampled = texture(sprite_texture, v_tex_coords);
+            frag_color = vec4(sampled.rgb, sampled.a * v_opacity);
+        }
+    )glsl";
+
+    vsrg::EngineContext* engine_context;
+
+    GLuint shader_program = 0;
+    GLuint vao = 0;
+    GLuint vbo = 0;
+
+    GLint projection_uniform;
+    GLint texture_uniform;
+
+    std::vector<SpriteBatch> batches;
+
+    SpriteBatch* getBatch(GLuint texture_id, int layer) {
+        for (auto& batch : batches) {
+            if (batch.texture_id == texture_id && batch.layer == layer &&
+                batch.sprite_count < MAX_BATCH_SIZE) {
+                return &batch;
+            }
+        }
+
+        SpriteBatch new_batch;
+        new_batch.texture_id = texture_id;
+        new_batch.layer = layer;
+        batches.push_back(new_batch);
+        return &batches.back();
+    }
+};
+}  // namespace legacy
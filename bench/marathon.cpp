@@ -0,0 +1,111 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "headless.hpp"
+#include "rhythm/conductor.hpp"
+#include "rhythm/playfield.hpp"
+#include "syntheticChart.hpp"
+
+// cpu time of Playfield::update and render per frame on synthetic charts of growing length at the
+// same note density. with the per column window the numbers should stay flat as charts get longer
+// usage: vsrg-bench-marathon [longest note count]
+
+namespace {
+const float FRAME_TIME = 1.0f / 60.0f;
+const int WARMUP_FRAMES = 60;
+const int MEASURED_FRAMES = 600;
+// how far into the chart each measured stretch starts
+const float SECTIONS[] = {0.1f, 0.5f, 0.9f};
+
+struct FrameTimes {
+    std::vector<double> update;
+    std::vector<double> render;
+};
+
+double mean(const std::vector<double>& values) {
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    return values.empty() ? 0.0 : sum / values.size();
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+}
+
+void printRow(size_t note_count, const FrameTimes& times) {
+    std::cout << std::setw(8) << note_count << " notes" << std::fixed << std::setprecision(3)
+              << "  update " << std::setw(7) << mean(times.update) << " ms (p99 " << std::setw(7)
+              << percentile(times.update, 0.99) << ")"
+              << "  render " << std::setw(7) << mean(times.render) << " ms (p99 " << std::setw(7)
+              << percentile(times.render, 0.99) << ")" << std::endl;
+}
+
+FrameTimes run(vsrg::EngineContext* ctx, vsrg::Audio* audio, size_t note_count) {
+    bench::SyntheticChartOptions options;
+    options.note_count = note_count;
+    options.notes_per_second = 20.0f;
+    mania::ChartData chart = bench::makeSyntheticChart(options);
+
+    vsrg::Conductor conductor(ctx->get_audio_manager(), audio, chart.timing_points);
+    mania::Playfield playfield(ctx, &chart, &conductor, options.key_count);
+    while (playfield.isLoading()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    float length = note_count / options.notes_per_second;
+    FrameTimes times;
+
+    // the song is never played, every frame seeks the conductor to where it would be
+    for (float section : SECTIONS) {
+        float time = length * section;
+        for (int frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; frame++) {
+            conductor.seek(time);
+            time += FRAME_TIME;
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            double update = bench::timeMilliseconds([&] { playfield.update(FRAME_TIME); });
+            double render = bench::timeMilliseconds([&] { playfield.render(); });
+
+            // the first frames after a jump retire everything before it
+            if (frame < WARMUP_FRAMES) continue;
+            times.update.push_back(update);
+            times.render.push_back(render);
+        }
+        glFinish();
+    }
+
+    return times;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t longest = argc > 1 ? std::stoul(argv[1]) : 100000;
+
+    auto client = bench::createHeadlessClient();
+    if (!client) {
+        std::cerr << "could not create a gl context" << std::endl;
+        return 1;
+    }
+    vsrg::EngineContext* ctx = client->get_engine_context();
+
+    vsrg::Audio* audio = bench::loadSilentAudio(*ctx->get_audio_manager());
+    if (!audio) {
+        std::cerr << "could not load the silent song" << std::endl;
+        return 1;
+    }
+
+    std::cout << "per frame at 20 notes/s, 4 keys" << std::endl;
+    for (size_t note_count = std::max<size_t>(longest / 100, 1); note_count <= longest;
+         note_count *= 10) {
+        printRow(note_count, run(ctx, audio, note_count));
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "allocationCounter.hpp"
+#include "bench.hpp"
+#include "headless.hpp"
+#include "legacyNotes.hpp"
+#include "rhythm/math/scroll.hpp"
+#include "rhythm/noteStore.hpp"
+#include "syntheticChart.hpp"
+
+// heap footprint and construction time of the notes of a chart, the old object per note graph
+// against NoteStore. every allocation in the process goes through the counters of
+// allocationCounter.hpp
+// usage: vsrg-bench-noteMemory [note count]
+
+namespace {
+struct Measurement {
+    size_t bytes;
+    size_t allocations;
+    double ms;
+};
+
+template <typename Build>
+Measurement measure(Build&& build) {
+    size_t bytes = bench::live_bytes;
+    size_t allocations = bench::allocation_count;
+    double ms = bench::timeMilliseconds(build);
+    return {bench::live_bytes - bytes, bench::allocation_count - allocations, ms};
+}
+
+void printRow(const std::string& name, const Measurement& m, size_t note_count) {
+    std::cout << std::left << std::setw(10) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << m.bytes / 1024.0 << " KB"
+              << std::setw(8) << (double)m.bytes / note_count << " B/note" << std::setw(9)
+              << m.allocations << " allocs" << std::setprecision(2) << std::setw(9) << m.ms
+              << " ms" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    bench::SyntheticChartOptions options;
+    options.note_count = argc > 1 ? std::stoul(argv[1]) : 20000;
+
+    auto client = bench::createHeadlessClient();
+    if (!client) {
+        std::cerr << "could not create a gl context" << std::endl;
+        return 1;
+    }
+    vsrg::EngineContext* ctx = client->get_engine_context();
+
+    mania::ChartData chart = bench::makeSyntheticChart(options);
+    std::cout << chart.notes.size() << " notes, " << options.key_count << " keys" << std::endl;
+
+    // the skin textures are loaded once up front, neither side should pay for decoding them
+    for (auto* note : legacy::createNotes(ctx, chart, options.key_count)) delete note;
+
+    std::vector<legacy::Note*> notes;
+    Measurement objects =
+        measure([&] { notes = legacy::createNotes(ctx, chart, options.key_count); });
+
+    mania::NoteStore store;
+    mania::ScrollSpeedCalculator calculator;
+    Measurement soa = measure([&] {
+        store.build(&chart, options.key_count);
+        store.computePositions(calculator);
+    });
+
+    printRow("objects", objects, chart.notes.size());
+    printRow("notestore", soa, chart.notes.size());
+    std::cout << "NoteStore::getMemoryUsage: " << store.getMemoryUsage() / 1024 << " KB"
+              << std::endl;
+
+    for (auto* note : notes) delete note;
+    return 0;
+}
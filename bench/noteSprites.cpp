@@ -0,0 +1,133 @@
+#include <glad/glad.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "core/ui/sprite.hpp"
+#include "core/ui/texture.hpp"
+#include "headless.hpp"
+
+// cpu time to submit a playfield's worth of notes, 2000 on screen by default with every third one
+// a hold (end, body and head), drawn with the skin textures. handles resolved once up front
+// against interning the skin path on every draw, which is the string hash getTexture(path) used
+// to do per sprite. only drawSprite is timed, the flush is the same for both
+// usage: vsrg-bench-noteSprites [visible notes]
+
+namespace {
+const int RUNS = 200;
+const int WARMUP_FRAMES = 20;
+const int KEY_COUNT = 4;
+
+struct ColumnTextures {
+    std::string note, hold_body, hold_end;
+    vsrg::TextureHandle note_handle, hold_body_handle, hold_end_handle;
+};
+
+template <typename Resolve>
+void drawNotes(vsrg::SpriteRenderer& renderer, const std::vector<ColumnTextures>& columns,
+               int note_count, Resolve&& resolve) {
+    for (int i = 0; i < note_count; i++) {
+        const ColumnTextures& column = columns[i % KEY_COUNT];
+        glm::vec2 position((i % KEY_COUNT) * 64.0f, (i * 37) % 700);
+
+        if (i % 3 == 0) {
+            renderer.drawSprite(resolve(column.hold_end, column.hold_end_handle), position,
+                                glm::vec2(64.0f, 32.0f), glm::vec4(0.0f, 0.0f, 1.0f, 0.7f), 0.0f,
+                                glm::vec2(0.0f), glm::vec2(1.0f), 1.0f, 1);
+            renderer.drawSprite(resolve(column.hold_body, column.hold_body_handle),
+                                position + glm::vec2(0.0f, 32.0f), glm::vec2(64.0f, 100.0f),
+                                glm::vec4(0.0f, 0.0f, 1.0f, 0.6f), 0.0f, glm::vec2(0.0f),
+                                glm::vec2(1.0f), 1.0f, 1);
+        }
+        renderer.drawSprite(resolve(column.note, column.note_handle), position,
+                            glm::vec2(64.0f, 36.0f), 0.0f, glm::vec2(0.0f), glm::vec2(1.0f), 1.0f,
+                            2);
+    }
+}
+
+// mean and best drawSprite time of a frame, the gpu is finished between frames
+template <typename Draw>
+void measure(vsrg::SpriteRenderer& renderer, Draw&& draw, double& mean_ms, double& best_ms) {
+    for (int frame = 0; frame < WARMUP_FRAMES; frame++) {
+        renderer.begin();
+        draw();
+        renderer.end();
+        glFinish();
+    }
+
+    double total = 0.0;
+    best_ms = 0.0;
+    for (int frame = 0; frame < RUNS; frame++) {
+        renderer.begin();
+        double ms = bench::timeMilliseconds(draw);
+        renderer.end();
+        glFinish();
+
+        total += ms;
+        if (frame == 0 || ms < best_ms) best_ms = ms;
+    }
+    mean_ms = total / RUNS;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int note_count = argc > 1 ? std::stoi(argv[1]) : 2000;
+
+    auto client = bench::createHeadlessClient();
+    if (!client) {
+        std::cerr << "could not create a gl context" << std::endl;
+        return 1;
+    }
+    vsrg::EngineContext* ctx = client->get_engine_context();
+    vsrg::TextureCache* cache = ctx->get_texture_cache();
+    vsrg::SpriteRenderer* renderer = ctx->get_sprite_renderer();
+    renderer->setBackend(vsrg::SpriteBackend::BATCHED);
+
+    std::vector<ColumnTextures> columns(KEY_COUNT);
+    for (int key = 0; key < KEY_COUNT; key++) {
+        ColumnTextures& column = columns[key];
+        column.note = "note" + std::to_string(key) + ".png";
+        column.hold_body = "holdBody" + std::to_string(key) + ".png";
+        column.hold_end = "holdEnd" + std::to_string(key) + ".png";
+
+        column.note_handle = cache->getHandle(column.note);
+        column.hold_body_handle = cache->getHandle(column.hold_body);
+        column.hold_end_handle = cache->getHandle(column.hold_end);
+        for (auto handle : {column.note_handle, column.hold_body_handle, column.hold_end_handle}) {
+            if (!cache->getTexture(handle)) {
+                std::cerr << "missing skin texture " << cache->getPath(handle) << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    double path_mean, path_best, handle_mean, handle_best;
+    measure(
+        *renderer,
+        [&] {
+            drawNotes(*renderer, columns, note_count,
+                      [&](const std::string& path, vsrg::TextureHandle) {
+                          return cache->getHandle(path);
+                      });
+        },
+        path_mean, path_best);
+    measure(
+        *renderer,
+        [&] {
+            drawNotes(*renderer, columns, note_count,
+                      [](const std::string&, vsrg::TextureHandle handle) { return handle; });
+        },
+        handle_mean, handle_best);
+
+    int sprite_count = note_count + 2 * ((note_count + 2) / 3);
+    std::cout << note_count << " notes (" << sprite_count << " sprites), drawSprite per frame"
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(3) << "  path per draw  " << std::setw(8)
+              << path_mean << " ms mean" << std::setw(8) << path_best << " ms best" << std::endl;
+    std::cout << "  handles        " << std::setw(8) << handle_mean << " ms mean" << std::setw(8)
+              << handle_best << " ms best" << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "legacyScroll.hpp"
+#include "rhythm/conductor.hpp"
+#include "rhythm/math/scroll.hpp"
+#include "syntheticChart.hpp"
+
+// note y positions on a chart full of bpm changes, the old walk over every timing point per note
+// against the position table one note at a time, and against what the playfield does: positions
+// for the whole chart once at load, then one multiply per note and frame
+// usage: vsrg-bench-scrollTable [timing point count]
+
+namespace {
+const int RUNS = 20;
+const float STRUM_LINE_Y = 800.0f;
+const float XMOD = 0.8f;
+// the old path is slow enough that it only gets a sample of the notes
+const size_t LEGACY_SAMPLE = 2000;
+
+void printRow(const std::string& name, double ms, size_t count) {
+    std::cout << std::left << std::setw(14) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << ms * 1e6 / count << " ns/note"
+              << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    bench::SyntheticChartOptions options;
+    options.note_count = 20000;
+    options.timing_point_count = argc > 1 ? std::stoul(argv[1]) : 500;
+    mania::ChartData chart = bench::makeSyntheticChart(options);
+
+    std::vector<float> times;
+    times.reserve(chart.notes.size());
+    for (const auto& note : chart.notes) times.push_back(note.time);
+    std::sort(times.begin(), times.end());
+
+    float current_time = times[times.size() / 2];
+
+    // no audio, the conductor is only there for its timing points
+    vsrg::AudioManager audio_manager(nullptr);
+    vsrg::Conductor conductor(&audio_manager, nullptr, chart.timing_points);
+
+    mania::ScrollSpeedCalculator table;
+    double build = bench::bestOf(RUNS, [&] { table.setConductor(&conductor); });
+    table.setXMod(XMOD);
+
+    legacy::ScrollSpeedCalculator old(chart.timing_points);
+    old.setXMod(XMOD);
+
+    std::vector<float> sample;
+    for (size_t i = 0; i < LEGACY_SAMPLE; i++) {
+        sample.push_back(times[i * times.size() / LEGACY_SAMPLE]);
+    }
+
+    // the two have to agree before their times mean anything. far off screen the old float sums
+    // drift, so only positions a screen or two away are compared
+    std::vector<float> positions(times.size());
+    table.calculateNotePositions(times.data(), positions.data(), times.size());
+    double current_position = table.getPositionAt(current_time);
+    double max_error = 0.0;
+    for (size_t i = 0; i < LEGACY_SAMPLE; i++) {
+        float expected = old.calculateNoteYPosition(sample[i], current_time, STRUM_LINE_Y);
+        if (std::abs(expected) > 3000.0f) continue;
+
+        float single = table.calculateNoteYPosition(sample[i], current_time, STRUM_LINE_Y);
+        size_t index = i * times.size() / LEGACY_SAMPLE;
+        max_error = std::max<double>(max_error, std::abs(expected - single));
+        float precomputed =
+            table.calculateYFromPosition(positions[index], current_position, STRUM_LINE_Y);
+        max_error = std::max<double>(max_error, std::abs(expected - precomputed));
+    }
+
+    volatile float sink = 0.0f;
+    double legacy_ms = bench::bestOf(3, [&] {
+        for (float time : sample) {
+            sink = sink + old.calculateNoteYPosition(time, current_time, STRUM_LINE_Y);
+        }
+    });
+    double single_ms = bench::bestOf(RUNS, [&] {
+        for (float time : times) {
+            sink = sink + table.calculateNoteYPosition(time, current_time, STRUM_LINE_Y);
+        }
+    });
+    double load_ms = bench::bestOf(RUNS, [&] {
+        table.calculateNotePositions(times.data(), positions.data(), times.size());
+    });
+    double frame_ms = bench::bestOf(RUNS, [&] {
+        double now = table.getPositionAt(current_time);
+        for (float position : positions) {
+            sink = sink + table.calculateYFromPosition(position, now, STRUM_LINE_Y);
+        }
+    });
+
+    std::cout << chart.timing_points.size() << " timing points, " << times.size() << " notes"
+              << std::endl;
+    std::cout << "table build " << std::fixed << std::setprecision(3) << build << " ms"
+              << std::endl;
+    printRow("old per note", legacy_ms, sample.size());
+    printRow("table", single_ms, times.size());
+    printRow("load batch", load_ms, times.size());
+    printRow("per frame", frame_ms, times.size());
+    std::cout << "max difference " << std::setprecision(4) << max_error << " px" << std::endl;
+
+    return max_error < 1.0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+#include <glad/glad.h>
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "allocationCounter.hpp"
+#include "bench.hpp"
+#include "core/ui/sprite.hpp"
+#include "headless.hpp"
+#include "legacySprites.hpp"
+#include "spriteScene.hpp"
+
+// cpu cost of batching a frame, drawSprite for every sprite plus the sort and submission in end,
+// and the heap allocations a frame makes once the renderer is warm. the old per texture batch
+// list against both backends of the sort key renderer. nothing reaches the framebuffer
+// usage: vsrg-bench-spriteBatching [sprite count]
+
+namespace {
+const int RUNS = 20;
+const int TEXTURE_COUNT = 16;
+const int LAYER_COUNT = 8;
+
+struct Measurement {
+    double ms;
+    size_t allocations;
+};
+
+template <typename Renderer, typename Texture>
+Measurement measure(Renderer& renderer, const std::vector<Texture>& textures,
+                    const std::vector<bench::SceneSprite>& scene) {
+    auto frame = [&] {
+        renderer.begin();
+        bench::drawScene(renderer, textures, scene);
+        renderer.end();
+    };
+
+    // the first frames grow the buffers, after that a frame shouldnt need the heap
+    frame();
+    frame();
+    glFinish();
+
+    size_t allocations = bench::allocation_count;
+    frame();
+    allocations = bench::allocation_count - allocations;
+    glFinish();
+
+    // the driver runs behind, glFinish between runs keeps its backlog out of the next one
+    double best = 0.0;
+    for (int run = 0; run < RUNS; run++) {
+        double ms = bench::timeMilliseconds(frame);
+        glFinish();
+        if (run == 0 || ms < best) best = ms;
+    }
+    return {best, allocations};
+}
+
+void printRow(const std::string& name, const Measurement& m, const Measurement& old) {
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << m.ms << " ms (" << std::setw(4)
+              << (int)std::lround(100.0 - 100.0 * m.ms / old.ms) << "% less)" << std::setw(7)
+              << m.allocations << " allocs/frame" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t sprite_count = argc > 1 ? std::stoul(argv[1]) : 10000;
+
+    auto client = bench::createHeadlessClient();
+    if (!client) {
+        std::cerr << "could not create a gl context" << std::endl;
+        return 1;
+    }
+    vsrg::EngineContext* ctx = client->get_engine_context();
+    glm::vec2 screen_size(ctx->get_screen_width(), ctx->get_screen_height());
+
+    std::vector<vsrg::TextureHandle> handles =
+        bench::loadTextures(ctx, bench::writeStandaloneTextures(TEXTURE_COUNT));
+    std::vector<GLuint> texture_ids;
+    for (auto handle : handles) {
+        texture_ids.push_back(ctx->get_texture_cache()->getTexture(handle)->texture_id);
+    }
+
+    std::vector<bench::SceneSprite> scene =
+        bench::makeSpriteScene(sprite_count, TEXTURE_COUNT, LAYER_COUNT, 0.0f, screen_size);
+
+    legacy::SpriteRenderer old_renderer(ctx);
+    vsrg::SpriteRenderer* renderer = ctx->get_sprite_renderer();
+
+    // this is about batching, not fill rate. with an empty scissor nothing is rasterised, so a
+    // software driver sharing the cores doesnt end up in the numbers. vertices are still
+    // uploaded and drawn
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(0, 0, 0, 0);
+
+    Measurement old = measure(old_renderer, texture_ids, scene);
+
+    renderer->setBackend(vsrg::SpriteBackend::BATCHED);
+    Measurement batched = measure(*renderer, handles, scene);
+
+    renderer->setBackend(vsrg::SpriteBackend::INSTANCED);
+    Measurement instanced = measure(*renderer, handles, scene);
+
+    std::cout << sprite_count << " sprites, " << TEXTURE_COUNT << " textures, " << LAYER_COUNT
+              << " layers, drawSprite + end per frame" << std::endl;
+    printRow("old", old, old);
+    printRow("batched", batched, old);
+    printRow("instanced", instanced, old);
+    return 0;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <glm/glm.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/ui/sprite.hpp"
+#include "core/ui/texture.hpp"
+#include "public/engineContext.hpp"
+
+
+namespace bench {
+struct SceneSprite {
+    size_t texture;  // index into the texture list the scene is drawn with
+    glm::vec2 position;
+    glm::vec2 size;
+    float rotation;  // degrees
+    int layer;
+};
+
+// solid color images too big for the atlas, so each one is its own gl texture and the old
+// renderer gets the same textures as the new one. written once to the temp dir, the paths are
+// absolute
+inline std::vector<std::string> writeStandaloneTextures(int count) {
+    const int size = vsrg::TEXTURE_ATLAS_MAX_ENTRY_SIZE + 64;
+
+    std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / "vsrg-bench-textures";
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < count; i++) {
+        std::filesystem::path path = directory / ("texture" + std::to_string(i) + ".ppm");
+        paths.push_back(path.string());
+        if (std::filesystem::exists(path, ec)) continue;
+
+        std::ofstream file(path, std::ios::binary);
+        file << "P6\n" << size << " " << size << "\n255\n";
+
+        unsigned char color[3] = {static_cast<unsigned char>(40 + i * 53 % 200),
+                                  static_cast<unsigned char>(40 + i * 97 % 200),
+                                  static_cast<unsigned char>(40 + i * 151 % 200)};
+        for (int pixel = 0; pixel < size * size; pixel++) {
+            file.write(reinterpret_cast<const char*>(color), 3);
+        }
+    }
+
+    return paths;
+}
+
+// loads every texture up front so no frame pays for a decode
+inline std::vector<vsrg::TextureHandle> loadTextures(vsrg::EngineContext* ctx,
+                                                     const std::vector<std::string>& paths) {
+    vsrg::TextureCache* cache = ctx->get_texture_cache();
+
+    std::vector<vsrg::TextureHandle> handles;
+    for (const auto& path : paths) {
+        cache->getTexture(path);
+        handles.push_back(cache->getHandle(path));
+    }
+    return handles;
+}
+
+// sprites scattered over the screen with random textures and layers, the same seed always gives
+// the same scene
+inline std::vector<SceneSprite> makeSpriteScene(size_t count, size_t texture_count,
+                                                int layer_count, float rotated_fraction,
+                                                glm::vec2 screen_size, uint32_t seed = 1) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<SceneSprite> sprites;
+    sprites.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        SceneSprite sprite;
+        sprite.texture = rng() % texture_count;
+        sprite.position = glm::vec2(unit(rng), unit(rng)) * screen_size;
+        sprite.size = glm::vec2(24.0f + 24.0f * unit(rng));
+        sprite.rotation = unit(rng) < rotated_fraction ? 360.0f * unit(rng) : 0.0f;
+        sprite.layer = static_cast<int>(rng() % layer_count);
+        sprites.push_back(sprite);
+    }
+    return sprites;
+}
+
+// the first count sprites, centered on their position. every renderer in the benches gets the
+// same calls
+template <typename Renderer, typename Texture>
+void drawScene(Renderer& renderer, const std::vector<Texture>& textures,
+               const std::vector<SceneSprite>& sprites, size_t count = SIZE_MAX) {
+    count = std::min(count, sprites.size());
+    for (size_t i = 0; i < count; i++) {
+        const SceneSprite& sprite = sprites[i];
+        renderer.drawSprite(textures[sprite.texture], sprite.position, sprite.size,
+                            sprite.rotation, glm::vec2(0.5f), glm::vec2(1.0f), 1.0f, sprite.layer);
+    }
+}
+}  // namespace bench
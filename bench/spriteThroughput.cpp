@@ -0,0 +1,119 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "core/ui/sprite.hpp"
+#include "headless.hpp"
+#include "legacySprites.hpp"
+#include "spriteScene.hpp"
+
+// how many sprites fit in a 60 fps frame, submission and the gpu finishing included, for the old
+// glBufferSubData batcher and both backends of the stream buffer renderer. meant for mesa's
+// llvmpipe so it runs anywhere, the numbers are about the cpu side of the driver
+// usage: vsrg-bench-spriteThroughput [frame budget ms]
+
+namespace {
+const int TEXTURE_COUNT = 8;
+const int LAYER_COUNT = 4;
+const int WARMUP_FRAMES = 2;
+const int MEASURED_FRAMES = 7;
+const size_t MAX_SPRITES = 1 << 20;
+
+// median frame time for count sprites
+double frameMilliseconds(const std::function<void(size_t)>& draw, size_t count) {
+    std::vector<double> times;
+    for (int frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; frame++) {
+        double ms = bench::timeMilliseconds([&] {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            draw(count);
+            glFinish();
+        });
+        if (frame >= WARMUP_FRAMES) times.push_back(ms);
+    }
+
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+// doubles until a frame goes over budget, then bisects down to a few percent
+size_t spritesWithinBudget(const std::function<void(size_t)>& draw, double budget_ms) {
+    size_t low = 0;
+    size_t high = 256;
+    while (high < MAX_SPRITES && frameMilliseconds(draw, high) <= budget_ms) {
+        low = high;
+        high *= 2;
+    }
+
+    while (high - low > std::max<size_t>(low / 50, 16)) {
+        size_t middle = (low + high) / 2;
+        if (frameMilliseconds(draw, middle) <= budget_ms) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    double budget_ms = argc > 1 ? std::stod(argv[1]) : 1000.0 / 60.0;
+
+    auto client = bench::createHeadlessClient();
+    if (!client) {
+        std::cerr << "could not create a gl context" << std::endl;
+        return 1;
+    }
+    vsrg::EngineContext* ctx = client->get_engine_context();
+    glm::vec2 screen_size(ctx->get_screen_width(), ctx->get_screen_height());
+
+    std::vector<vsrg::TextureHandle> handles =
+        bench::loadTextures(ctx, bench::writeStandaloneTextures(TEXTURE_COUNT));
+    std::vector<GLuint> texture_ids;
+    for (auto handle : handles) {
+        texture_ids.push_back(ctx->get_texture_cache()->getTexture(handle)->texture_id);
+    }
+
+    std::vector<bench::SceneSprite> scene =
+        bench::makeSpriteScene(MAX_SPRITES, TEXTURE_COUNT, LAYER_COUNT, 0.25f, screen_size);
+
+    legacy::SpriteRenderer old_renderer(ctx);
+    vsrg::SpriteRenderer* renderer = ctx->get_sprite_renderer();
+
+    auto drawLegacy = [&](size_t count) {
+        old_renderer.begin();
+        bench::drawScene(old_renderer, texture_ids, scene, count);
+        old_renderer.end();
+    };
+    auto drawCurrent = [&](size_t count) {
+        renderer->begin();
+        bench::drawScene(*renderer, handles, scene, count);
+        renderer->end();
+    };
+
+    std::cout << "renderer: " << glGetString(GL_RENDERER) << std::endl;
+    std::cout << "buffer storage: " << (GLAD_GL_ARB_buffer_storage ? "persistent" : "orphaning")
+              << std::endl;
+    std::cout << "sprites per " << std::fixed << std::setprecision(2) << budget_ms
+              << " ms frame, " << TEXTURE_COUNT << " textures, " << LAYER_COUNT << " layers"
+              << std::endl;
+
+    std::cout << "  old batcher  " << std::setw(9) << spritesWithinBudget(drawLegacy, budget_ms)
+              << std::endl;
+
+    renderer->setBackend(vsrg::SpriteBackend::BATCHED);
+    std::cout << "  batched      " << std::setw(9) << spritesWithinBudget(drawCurrent, budget_ms)
+              << std::endl;
+
+    renderer->setBackend(vsrg::SpriteBackend::INSTANCED);
+    std::cout << "  instanced    " << std::setw(9) << spritesWithinBudget(drawCurrent, budget_ms)
+              << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <glad/glad.h>
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "core/ui/sprite.hpp"
+#include "headless.hpp"
+#include "legacySprites.hpp"
+#include "spriteScene.hpp"
+
+// vertex bytes uploaded per sprite and cpu time per drawSprite call, old batcher against both
+// backends, for axis aligned sprites (the fast path) and rotated ones. only the drawSprite calls
+// are timed, the flush after them is not
+// usage: vsrg-bench-spriteVertices [sprite count]
+
+namespace {
+const int RUNS = 20;
+const int TEXTURE_COUNT = 8;
+const int LAYER_COUNT = 4;
+
+void printRow(const std::string& name, size_t bytes, size_t old_bytes, double aligned_ns,
+              double rotated_ns, double old_aligned_ns) {
+    std::cout << std::left << std::setw(12) << name << std::right << std::setw(5) << bytes
+              << " B/sprite (" << std::setw(3)
+              << (int)std::lround(100.0 - 100.0 * bytes / old_bytes) << "% less)" << std::fixed
+              << std::setprecision(1) << std::setw(9) << aligned_ns << " ns aligned ("
+              << std::setw(3) << (int)std::lround(100.0 - 100.0 * aligned_ns / old_aligned_ns)
+              << "% less)" << std::setw(9) << rotated_ns << " ns rotated" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t sprite_count = argc > 1 ? std::stoul(argv[1]) : 10000;
+
+    auto client = bench::createHeadlessClient();
+    if (!client) {
+        std::cerr << "could not create a gl context" << std::endl;
+        return 1;
+    }
+    vsrg::EngineContext* ctx = client->get_engine_context();
+    glm::vec2 screen_size(ctx->get_screen_width(), ctx->get_screen_height());
+
+    std::vector<vsrg::TextureHandle> handles =
+        bench::loadTextures(ctx, bench::writeStandaloneTextures(TEXTURE_COUNT));
+    std::vector<GLuint> texture_ids;
+    for (auto handle : handles) {
+        texture_ids.push_back(ctx->get_texture_cache()->getTexture(handle)->texture_id);
+    }
+
+    std::vector<bench::SceneSprite> aligned =
+        bench::makeSpriteScene(sprite_count, TEXTURE_COUNT, LAYER_COUNT, 0.0f, screen_size);
+    std::vector<bench::SceneSprite> rotated =
+        bench::makeSpriteScene(sprite_count, TEXTURE_COUNT, LAYER_COUNT, 1.0f, screen_size);
+
+    legacy::SpriteRenderer old_renderer(ctx);
+    vsrg::SpriteRenderer* renderer = ctx->get_sprite_renderer();
+
+    auto nanosecondsPerSprite = [&](auto& target, const auto& textures,
+                                    const std::vector<bench::SceneSprite>& scene) {
+        double ms = bench::bestOf(RUNS, [&] {
+            target.begin();
+            bench::drawScene(target, textures, scene);
+        });
+        target.end();
+        return ms * 1e6 / scene.size();
+    };
+
+    // the old batcher flushes once a batch has this many sprites, that would time gl as well
+    if (sprite_count / (TEXTURE_COUNT * LAYER_COUNT) >= legacy::SpriteRenderer::MAX_BATCH_SIZE) {
+        std::cerr << "too many sprites, the old batcher would flush in the middle" << std::endl;
+        return 1;
+    }
+
+    double old_aligned = nanosecondsPerSprite(old_renderer, texture_ids, aligned);
+    double old_rotated = nanosecondsPerSprite(old_renderer, texture_ids, rotated);
+
+    renderer->setBackend(vsrg::SpriteBackend::BATCHED);
+    double batched_aligned = nanosecondsPerSprite(*renderer, handles, aligned);
+    double batched_rotated = nanosecondsPerSprite(*renderer, handles, rotated);
+
+    renderer->setBackend(vsrg::SpriteBackend::INSTANCED);
+    double instanced_aligned = nanosecondsPerSprite(*renderer, handles, aligned);
+    double instanced_rotated = nanosecondsPerSprite(*renderer, handles, rotated);
+
+    size_t old_bytes = sizeof(legacy::SpriteVertex) * 6;
+
+    std::cout << sprite_count << " sprites" << std::endl;
+    printRow("old", old_bytes, old_bytes, old_aligned, old_rotated, old_aligned);
+    printRow("batched", sizeof(vsrg::SpriteVertex) * 4, old_bytes, batched_aligned,
+             batched_rotated, old_aligned);
+    printRow("instanced", sizeof(vsrg::SpriteInstance), old_bytes, instanced_aligned,
+             instanced_rotated, old_aligned);
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "rhythm/conductor.hpp"
+#include "rhythm/math/scroll.hpp"
+#include "rhythm/noteStore.hpp"
+#include "syntheticChart.hpp"
+
+// scroll velocity heavy charts: building the position curve, computing every note's position at
+// load, and the per frame work of one getPositionAt plus a y per visible note. the per frame
+// numbers should barely move as the velocity count grows
+// usage: vsrg-bench-svScroll [most scroll velocities]
+
+namespace {
+const int RUNS = 20;
+const int FRAMES = 10000;
+const size_t VISIBLE_NOTES = 200;
+const float STRUM_LINE_Y = 800.0f;
+
+struct Result {
+    double build_ms;
+    double positions_ms;
+    double frame_ns;
+};
+
+Result run(size_t velocity_count) {
+    bench::SyntheticChartOptions options;
+    options.note_count = 10000;
+    options.timing_point_count = 50;
+    options.scroll_velocity_count = velocity_count;
+    mania::ChartData chart = bench::makeSyntheticChart(options);
+
+    // no audio, the conductor is only there for its timing points
+    vsrg::AudioManager audio_manager(nullptr);
+    vsrg::Conductor conductor(&audio_manager, nullptr, chart.timing_points);
+
+    mania::ScrollSpeedCalculator calculator(&conductor);
+    calculator.setXMod(0.8f);
+
+    Result result;
+    result.build_ms =
+        bench::bestOf(RUNS, [&] { calculator.setScrollVelocities(chart.scroll_velocities); });
+
+    mania::NoteStore store;
+    store.build(&chart, options.key_count);
+    result.positions_ms = bench::bestOf(RUNS, [&] { store.computePositions(calculator); });
+
+    // the visible notes are the ones coming up next, their positions never change
+    const mania::NoteColumn& column = store.getColumn(0);
+    float length = options.note_count / options.notes_per_second;
+
+    volatile float sink = 0.0f;
+    double frames_ms = bench::bestOf(3, [&] {
+        for (int frame = 0; frame < FRAMES; frame++) {
+            float now = length * frame / FRAMES;
+            double current_position = calculator.getPositionAt(now);
+
+            size_t first = column.size() * frame / FRAMES;
+            size_t last = std::min(column.size(), first + VISIBLE_NOTES);
+            for (size_t i = first; i < last; i++) {
+                sink = sink + calculator.calculateYFromPosition(column.positions[i],
+                                                                current_position, STRUM_LINE_Y);
+            }
+        }
+    });
+    result.frame_ns = frames_ms * 1e6 / FRAMES;
+
+    return result;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t most = argc > 1 ? std::stoul(argv[1]) : 100000;
+
+    std::cout << "10000 notes, 50 bpm changes, " << VISIBLE_NOTES << " notes per frame"
+              << std::endl;
+    for (size_t count = std::max<size_t>(most / 1000, 1); count <= most; count *= 10) {
+        Result result = run(count);
+        std::cout << std::setw(8) << count << " svs" << std::fixed << std::setprecision(3)
+                  << "  curve " << std::setw(8) << result.build_ms << " ms"
+                  << "  note positions " << std::setw(8) << result.positions_ms << " ms"
+                  << std::setprecision(1) << "  frame " << std::setw(8) << result.frame_ns
+                  << " ns" << std::endl;
+    }
+    return 0;
+}
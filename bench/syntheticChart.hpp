@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+#include "rhythm/charts/chartData.hpp"
+
+
+namespace bench {
+struct SyntheticChartOptions {
+    size_t note_count = 10000;
+    int key_count = 4;
+    float notes_per_second = 10.0f;
+    float hold_fraction = 0.25f;
+    size_t timing_point_count = 1;
+    size_t scroll_velocity_count = 0;
+    uint32_t seed = 1;
+};
+
+// a chart with notes spread over every column at a steady density, bpm changes and scroll
+// velocities are spread evenly over its length
+inline mania::ChartData makeSyntheticChart(const SyntheticChartOptions& options) {
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    mania::ChartData chart;
+    chart.metadata.title = "synthetic";
+    chart.metadata.key_count = options.key_count;
+
+    float length = options.note_count / options.notes_per_second;
+    float spacing = 1.0f / options.notes_per_second;
+
+    chart.notes.reserve(options.note_count);
+    for (size_t i = 0; i < options.note_count; i++) {
+        int column = static_cast<int>(rng() % options.key_count);
+        float time = i * spacing;
+
+        if (unit(rng) < options.hold_fraction) {
+            float end_time = time + spacing * (1.0f + 4.0f * unit(rng));
+            chart.notes.emplace_back(column, time, end_time, mania::VSRGNoteType::HOLD);
+        } else {
+            chart.notes.emplace_back(column, time, mania::VSRGNoteType::TAP);
+        }
+    }
+
+    for (size_t i = 0; i < options.timing_point_count; i++) {
+        vsrg::TimingPoint point;
+        point.time = length * i / options.timing_point_count;
+        point.bpm = 60.0 + 300.0 * unit(rng);
+        point.nominator = 4;
+        point.denominator = 4;
+        chart.timing_points.push_back(point);
+    }
+
+    for (size_t i = 0; i < options.scroll_velocity_count; i++) {
+        float time = length * i / options.scroll_velocity_count;
+        chart.scroll_velocities.push_back({time, 0.1f + 9.9f * unit(rng)});
+    }
+
+    chart.sortNotes();
+    return chart;
+}
+}  // namespace bench
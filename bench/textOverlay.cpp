@@ -0,0 +1,92 @@
+#include <glad/glad.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "core/ui/font.hpp"
+#include "core/ui/textComponent.hpp"
+#include "headless.hpp"
+
+// cpu time per frame of a 100 line debug overlay in one TextComponent, once with the text left
+// alone and once with new text every frame so it is laid out again each time
+// usage: vsrg-bench-textOverlay [font, a name in assets/fonts or a path]
+
+namespace {
+const int LINE_COUNT = 100;
+const int RUNS = 200;
+const int WARMUP_FRAMES = 60;
+
+// every frame gets text it hasnt seen, so the layout cache cant help
+std::string makeOverlay(int frame) {
+    std::string text;
+    for (int line = 0; line < LINE_COUNT; line++) {
+        text += "line " + std::to_string(line) + ": FPS " +
+                std::to_string(144 + (frame + line) % 7) + "  Memory: 123." +
+                std::to_string(frame % 10) + " MB  frame " + std::to_string(frame) + "\n";
+    }
+    return text;
+}
+
+template <typename Frame>
+double meanMilliseconds(Frame&& frame) {
+    double total = 0.0;
+    for (int i = 0; i < RUNS; i++) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        total += bench::timeMilliseconds([&] { frame(i); });
+        glFinish();
+    }
+    return total / RUNS;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string font_name = argc > 1 ? argv[1] : "NotoSansJP-Regular.ttf";
+
+    auto client = bench::createHeadlessClient();
+    if (!client) {
+        std::cerr << "could not create a gl context" << std::endl;
+        return 1;
+    }
+    vsrg::EngineContext* ctx = client->get_engine_context();
+    vsrg::FontManager* font_manager = ctx->get_font_manager();
+
+    vsrg::Font* font = font_manager->getFont(font_name);
+    if (!font || !font->isLoaded()) {
+        std::cerr << "could not load " << font_name << std::endl;
+        return 1;
+    }
+
+    vsrg::TextComponent text(ctx, font, makeOverlay(0), {glm::vec3(1.0f), 6.0f, 1.0f});
+    vsrg::ComponentProperties properties;
+    properties.position = glm::vec2(16.0f);
+    text.setProperties(properties);
+
+    // glyphs come in from the font's worker, give them time to land before anything is timed
+    for (int frame = 0; frame < WARMUP_FRAMES; frame++) {
+        font_manager->processUploads();
+        text.setText(makeOverlay(frame));
+        text.render();
+        glFinish();
+    }
+
+    double static_ms = meanMilliseconds([&](int) { text.render(); });
+    // built up front, only setText and render are timed
+    std::vector<std::string> overlays;
+    for (int frame = 0; frame < RUNS; frame++) {
+        overlays.push_back(makeOverlay(WARMUP_FRAMES + frame));
+    }
+
+    double changing_ms = meanMilliseconds([&](int frame) {
+        text.setText(overlays[frame]);
+        text.render();
+    });
+
+    std::cout << LINE_COUNT << " line overlay, cpu per frame" << std::endl;
+    std::cout << std::fixed << std::setprecision(3) << "  static text      " << std::setw(8)
+              << static_ms << " ms" << std::endl;
+    std::cout << "  new text a frame " << std::setw(8) << changing_ms << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "core/ui/texture.hpp"
+#include "headless.hpp"
+
+// startup latency of every image in the asset folder, getTexture one after the other against
+// loadTextureAsync with processUploads once per 60 fps frame. the number that matters for the
+// async path is the longest stretch the gl thread spends in a frame, not the total
+// usage: vsrg-bench-textureStartup [asset dir]
+
+namespace {
+const int RUNS = 5;
+const double FRAME_MS = 1000.0 / 60.0;
+
+struct Measurement {
+    double total_ms = 0.0;          // until every texture is usable
+    double longest_frame_ms = 0.0;  // main thread time of the worst frame
+    int frames = 0;
+};
+
+Measurement loadSync(vsrg::EngineContext* ctx, const std::vector<std::string>& images) {
+    vsrg::TextureCache cache(ctx);
+
+    Measurement m;
+    m.total_ms = bench::timeMilliseconds([&] {
+        for (const auto& image : images) cache.getTexture(image);
+        glFinish();
+    });
+    m.longest_frame_ms = m.total_ms;
+    m.frames = 1;
+    return m;
+}
+
+Measurement loadAsync(vsrg::EngineContext* ctx, const std::vector<std::string>& images) {
+    vsrg::TextureCache cache(ctx);
+    std::vector<vsrg::TextureRequest> requests;
+
+    Measurement m;
+    auto start = bench::clock::now();
+    bool done = false;
+    while (!done) {
+        auto frame_start = bench::clock::now();
+
+        if (requests.empty()) {
+            for (const auto& image : images) requests.push_back(cache.loadTextureAsync(image));
+        }
+        cache.processUploads();
+        glFinish();
+
+        done = std::all_of(requests.begin(), requests.end(), [](const auto& request) {
+            return request.isReady() || request.failed();
+        });
+
+        double frame_ms = bench::millisecondsSince(frame_start);
+        m.longest_frame_ms = std::max(m.longest_frame_ms, frame_ms);
+        m.frames++;
+
+        // the rest of the frame is what the workers get on a machine with few cores
+        if (!done && frame_ms < FRAME_MS) {
+            std::this_thread::sleep_for(
+                std::chrono::duration<double, std::milli>(FRAME_MS - frame_ms));
+        }
+    }
+    m.total_ms = bench::millisecondsSince(start);
+    return m;
+}
+
+void printRow(const std::string& name, const Measurement& m) {
+    std::cout << std::left << std::setw(8) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << m.total_ms << " ms until ready"
+              << std::setw(10) << m.longest_frame_ms << " ms longest frame" << std::setw(5)
+              << m.frames << " frames" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string assets = bench::assetDir(argc, argv);
+    std::vector<std::string> images = bench::findFiles(assets, ".png");
+    for (const auto& jpg : bench::findFiles(assets, ".jpg")) images.push_back(jpg);
+    if (images.empty()) {
+        std::cerr << "no images found" << std::endl;
+        return 1;
+    }
+
+    auto client = bench::createHeadlessClient();
+    if (!client) {
+        std::cerr << "could not create a gl context" << std::endl;
+        return 1;
+    }
+    vsrg::EngineContext* ctx = client->get_engine_context();
+
+    // a fresh cache every run, the best run of each so the page cache is warm for both
+    Measurement sync, async;
+    for (int run = 0; run < RUNS; run++) {
+        Measurement s = loadSync(ctx, images);
+        Measurement a = loadAsync(ctx, images);
+        if (run == 0 || s.total_ms < sync.total_ms) sync = s;
+        if (run == 0 || a.longest_frame_ms < async.longest_frame_ms) async = a;
+    }
+
+    std::cout << images.size() << " images, " << std::thread::hardware_concurrency()
+              << " hardware threads" << std::endl;
+    printRow("sync", sync);
+    printRow("async", async);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "rhythm/timingMap.hpp"
+
+// timing map lookups at 10, 1k and 100k timing points against what the conductor did before it:
+// copy the points out and scan them from the front
+// usage: vsrg-bench-timingMap
+
+using namespace vsrg;
+
+namespace {
+const int LOOKUPS = 100000;
+// spread over the whole song but never in order, so nothing stays in a cache line by luck
+const int TIME_STEPS = 997;
+
+std::vector<TimingPoint> makeTimingPoints(int count) {
+    std::mt19937 rng(count);
+    std::vector<TimingPoint> points;
+    float time = 0.0f;
+    for (int i = 0; i < count; i++) {
+        points.push_back({time, 60.0 + rng() % 300, 4, 4});
+        time += 0.01f + (rng() % 100) / 1000.0f;
+    }
+    return points;
+}
+
+// Conductor::get_bpm_at_time before the timing map, called through the by value getter the way
+// the scroll code did
+double linearBPMAt(std::vector<TimingPoint> points, float time) {
+    size_t found_index = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (time >= points[i].time) {
+            found_index = i;
+        } else {
+            break;
+        }
+    }
+    return points[found_index].bpm;
+}
+
+template <typename Lookup>
+double nanosecondsPerLookup(int lookups, float length, Lookup&& lookup) {
+    volatile double sink = 0.0;
+    double ms = bench::bestOf(3, [&] {
+        for (int i = 0; i < lookups; i++) {
+            sink = sink + lookup(length * (i * 31 % TIME_STEPS) / TIME_STEPS);
+        }
+    });
+    return ms * 1e6 / lookups;
+}
+}  // namespace
+
+int main() {
+    std::cout << "ns per lookup" << std::endl;
+    std::cout << std::setw(8) << "points" << std::setw(10) << "bpm" << std::setw(10) << "index"
+              << std::setw(10) << "beat" << std::setw(10) << "time" << std::setw(10) << "linear"
+              << std::setw(12) << "roundtrip" << std::endl;
+
+    for (int count : {10, 1000, 100000}) {
+        std::vector<TimingPoint> points = makeTimingPoints(count);
+        float length = points.back().time + 1.0f;
+        TimingMap map(points);
+
+        double bpm =
+            nanosecondsPerLookup(LOOKUPS, length, [&](float t) { return map.get_bpm_at(t); });
+        double index = nanosecondsPerLookup(
+            LOOKUPS, length, [&](float t) { return (double)map.get_point_index_at(t); });
+        double beat =
+            nanosecondsPerLookup(LOOKUPS, length, [&](float t) { return map.beat_at_time(t); });
+        double last_beat = map.beat_at_time(length);
+        double time = nanosecondsPerLookup(
+            LOOKUPS, length, [&](float t) { return map.time_at_beat(last_beat * t / length); });
+
+        // the old scan copies every point each call, at 100k points a hundred calls are plenty
+        int linear_lookups = std::max(100, LOOKUPS / count);
+        double linear = nanosecondsPerLookup(linear_lookups, length,
+                                             [&](float t) { return linearBPMAt(points, t); });
+
+        double roundtrip_error = 0.0;
+        for (int i = 0; i < 5000; i++) {
+            double t = -5.0 + (length + 10.0) * i / 5000;
+            double error = std::abs(map.time_at_beat(map.beat_at_time(t)) - t);
+            roundtrip_error = std::max(roundtrip_error, error);
+        }
+
+        std::cout << std::setw(8) << count << std::fixed << std::setprecision(1) << std::setw(10)
+                  << bpm << std::setw(10) << index << std::setw(10) << beat << std::setw(10)
+                  << time << std::setw(10) << linear << std::scientific << std::setprecision(1)
+                  << std::setw(12) << roundtrip_error << std::endl;
+    }
+    return 0;
+}
@@ -98,6 +98,24 @@ public:
 
         return (float)cursorInFrames / (float)sampleRate;
     }
+    // same as get_position, but without losing precision to float late into long songs
+    double get_precise_position() {
+        if (!initialized)
+            return 0.0;
+
+        ma_uint64 cursorInFrames;
+        ma_uint32 sampleRate;
+
+        if (ma_sound_get_cursor_in_pcm_frames(&sound, &cursorInFrames) != MA_SUCCESS) {
+            return 0.0;
+        }
+
+        ma_sound_get_data_format(&sound, NULL, NULL, &sampleRate, NULL, 0);
+        if (sampleRate == 0)
+            return 0.0;
+
+        return (double)cursorInFrames / (double)sampleRate;
+    }
     void set_position(float time_in_seconds) {
         if (!initialized)
             return;
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "core/spscQueue.hpp"
+#include "public/IGamePlugin.hpp"
+
+
+namespace vsrg {
+class EngineContext;
+class Conductor;
+
+// collects key events as sdl receives them, with the os timestamp converted to steady_clock,
+// and hands them to the gameplay side in batches. the sdl event watch is the only producer and
+// whoever drains is the only consumer, so a lock free spsc queue sits between them
+class InputManager {
+public:
+    InputManager(EngineContext* engine_context);
+    ~InputManager();
+
+    InputManager(const InputManager&) = delete;
+    InputManager& operator=(const InputManager&) = delete;
+
+    // events get their song time from this conductor, set it to nullptr when it goes away.
+    // anything still queued is dropped, it happened before this conductor's song
+    void set_conductor(Conductor* conductor);
+    Conductor* get_conductor() const { return conductor; }
+
+    // appends every queued event to out_events (oldest first) and returns how many were added
+    size_t drain(std::vector<InputEvent>& out_events);
+    void clear();
+
+    // total events lost because the queue was full
+    uint64_t get_dropped_count() const { return dropped_events.load(std::memory_order_relaxed); }
+
+private:
+    static const size_t QUEUE_CAPACITY = 1024;
+
+    EngineContext* engine_context;
+    Conductor* conductor = nullptr;
+
+    SPSCQueue<InputEvent, QUEUE_CAPACITY> queue;
+    std::atomic<uint64_t> dropped_events{0};
+    uint64_t reported_dropped_events = 0;
+
+    // steady_clock ns minus SDL_GetTicksNS, both are monotonic so this only has to be taken once
+    int64_t ticks_to_steady_ns = 0;
+
+    static bool SDLCALL on_sdl_event(void* userdata, SDL_Event* event);
+};
+}  // namespace vsrg
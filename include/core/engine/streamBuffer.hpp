@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+
+#include "public/engineContext.hpp"
+
+
+namespace vsrg {
+// streaming vertex/index storage that the cpu writes into every frame without stalling on draws
+// that still read the old contents.
+//
+// with ARB_buffer_storage the whole buffer is mapped once (persistent + coherent) and split into
+// chunks, each chunk gets a fence when it is left and is only written again once that fence has
+// signalled. without it (plain gl 3.3) the buffer is orphaned whenever it runs out of space and
+// each write is an unsynchronized map of a range nobody is using yet
+class StreamBuffer {
+public:
+    StreamBuffer(EngineContext* engine_context, GLenum target, size_t chunk_size,
+                 int chunk_count = 3);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // reserves size bytes (at most the chunk size) and returns where to write them,
+    // out_offset is the byte offset of that memory inside the gl buffer. call unmap when done.
+    // on nullptr the buffer is left unbound and there is nothing to unmap
+    void* map(size_t size, size_t& out_offset);
+    void unmap();
+
+    GLuint getBuffer() const { return buffer; }
+    size_t getChunkSize() const { return chunk_size; }
+    bool isPersistent() const { return persistent; }
+
+private:
+    void advanceChunk();
+
+    EngineContext* engine_context;
+
+    GLenum target;
+    GLuint buffer = 0;
+
+    size_t chunk_size;
+    int chunk_count;
+
+    bool persistent = false;
+    unsigned char* mapped_data = nullptr;  // whole buffer, persistent path only
+
+    int current_chunk = 0;
+    size_t chunk_offset = 0;
+    GLsync chunk_fences[8] = {};
+};
+}  // namespace vsrg
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace vsrg {
+// read-only view of an entire file, backed by mmap (or MapViewOfFile on windows)
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return is_open; }
+    const unsigned char* getData() const { return data; }
+    size_t getSize() const { return size; }
+
+    std::string_view getView() const {
+        return std::string_view(reinterpret_cast<const char*>(data), size);
+    }
+
+private:
+    bool is_open = false;
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#endif
+};
+}  // namespace vsrg
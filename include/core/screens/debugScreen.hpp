@@ -13,8 +13,6 @@
 
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
-#include <iomanip>
-#include <sstream>
 #include <string>
 
 namespace vsrg {
@@ -34,5 +32,13 @@ private:
 
     TextComponent text_component;
     IGamePlugin* gameplay_plugin;
+    std::vector<InputEvent> input_events;  // reused every frame
+
+    TextBuffer text_data;  // rebuilt every frame
+    std::string memory;
+    FontAtlasStats glyph_stats;
+    uint64_t last_glyph_evictions = 0;
+    float stats_timer = 0.0f;
+    float glyph_eviction_rate = 0.0f;
 };
 }  // namespace vsrg
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vsrg {
+// shared by the on-disk caches (compiled charts, baked textures). a cache stores the size, mtime
+// and hash of the file it was built from, and only hashes the source again when the mtime moved
+
+const uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ull;
+
+// 64 bit fnv-1a, good enough to catch edits that keep the same size. pass the previous result as
+// hash to carry on over more data
+inline uint64_t hashFNV1a(const void* data, size_t size, uint64_t hash = FNV1A_OFFSET_BASIS) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// false if the file cant be stat'ed
+bool getSourceStamp(const std::string& path, uint64_t& size, int64_t& mtime);
+
+// a touched source whose hash still matched gets its new mtime written into the cache header at
+// mtime_offset, so the next load doesnt hash it again. if this fails the next load just hashes
+// once more. the cache file must not be mapped anymore, windows wont write to it otherwise
+void refreshSourceStamp(const std::string& cache_path, size_t mtime_offset, int64_t mtime);
+}  // namespace vsrg
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+
+namespace vsrg {
+// fixed size lock free queue for exactly one producer thread and one consumer thread
+// capacity has to be a power of two, one slot is always left empty to tell full from empty
+template <typename T, size_t Capacity>
+class SPSCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SPSCQueue capacity must be a power of two");
+
+public:
+    // producer side, returns false (and drops the item) when the queue is full
+    bool try_push(const T& item) {
+        size_t head = write_index.load(std::memory_order_relaxed);
+        size_t next = (head + 1) & (Capacity - 1);
+        if (next == read_index.load(std::memory_order_acquire)) return false;
+
+        buffer[head] = item;
+        write_index.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side
+    bool try_pop(T& out_item) {
+        size_t tail = read_index.load(std::memory_order_relaxed);
+        if (tail == write_index.load(std::memory_order_acquire)) return false;
+
+        out_item = buffer[tail];
+        read_index.store((tail + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return read_index.load(std::memory_order_acquire) ==
+               write_index.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return Capacity - 1; }
+
+private:
+    std::array<T, Capacity> buffer;
+
+    // kept on separate cache lines so the two threads dont keep stealing the line from each other
+    alignas(64) std::atomic<size_t> write_index{0};
+    alignas(64) std::atomic<size_t> read_index{0};
+};
+}  // namespace vsrg
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+
+namespace vsrg {
+// skyline bottom-left rectangle packer. the top edge of everything packed so far is kept as a
+// list of horizontal segments and each rect goes wherever it ends up lowest, which is close to
+// maxrects for the mostly similar sized skin textures while staying O(segments) per insert
+class SkylinePacker {
+public:
+    SkylinePacker(int width = 0, int height = 0) { reset(width, height); }
+
+    void reset(int width, int height);
+
+    // finds room for a width x height rect, returns false if the page is full
+    bool pack(int width, int height, glm::ivec2& out_position);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // fraction of the page covered by packed rects
+    float getOccupancy() const;
+
+private:
+    struct Segment {
+        int x;
+        int y;
+        int width;
+    };
+
+    // lowest y a rect of this width can sit at when its left edge is on segment index, -1 if it
+    // doesnt fit there
+    int fitAt(size_t index, int rect_width, int rect_height) const;
+
+    int width = 0;
+    int height = 0;
+    long long used_area = 0;
+
+    std::vector<Segment> skyline;
+};
+
+// shelf packer that can give space back, for caches where entries come and go. rects go on
+// horizontal shelves whose height is rounded up to SHELF_PACKER_HEIGHT_STEP, so similar heights
+// share a shelf and a freed rect is reused by the next one of about the same size. empty shelves,
+// and every shelf once the page has no room for new ones, take any rect short enough for them
+const int SHELF_PACKER_HEIGHT_STEP = 8;
+
+class ShelfPacker {
+public:
+    ShelfPacker(int width = 0, int height = 0) { reset(width, height); }
+
+    void reset(int width, int height);
+
+    // finds room for a width x height rect, returns false if the page is full
+    bool pack(int width, int height, glm::ivec2& out_position);
+    // gives back a rect returned by pack, with the same size it was packed with
+    void release(glm::ivec2 position, int width, int height);
+
+    // height of the shelf a packed rect sits on, 0 if there is none at that y
+    int getShelfHeight(int y) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // fraction of the page covered by packed rects
+    float getOccupancy() const;
+
+private:
+    struct Span {
+        int x;
+        int width;
+    };
+
+    struct Shelf {
+        int y;
+        int height;
+        int used = 0;              // rects on the shelf
+        std::vector<Span> spans;  // free, sorted by x
+    };
+
+    int width = 0;
+    int height = 0;
+    int shelves_end = 0;  // y where the next new shelf starts
+    long long used_area = 0;
+
+    std::vector<Shelf> shelves;  // sorted by y
+};
+}  // namespace vsrg
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace vsrg {
+// decoded images are stored next to the source file as "<image>.vtx" so later runs skip the
+// png/jpg decode. bump BAKED_TEXTURE_VERSION whenever the layout or the conversion changes
+const uint32_t BAKED_TEXTURE_MAGIC = 0x58545356;  // "VSTX"
+const uint32_t BAKED_TEXTURE_VERSION = 1;
+
+struct BakedTextureHeader {
+    uint32_t magic;
+    uint32_t version;
+
+    // used to invalidate the cache when the source image changes
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t source_hash;
+
+    int32_t width;
+    int32_t height;
+    int32_t channels;  // of the source image, the pixels are always rgba
+    uint32_t level_count;
+    uint64_t data_size;
+};
+
+// rgba8 with premultiplied alpha, the mip levels follow each other in pixels starting at the
+// full size one. each level is half the one before (rounded down, at least 1)
+struct BakedTexture {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    int level_count = 0;
+    std::vector<unsigned char> pixels;
+
+    int getLevelWidth(int level) const { return width >> level > 0 ? width >> level : 1; }
+    int getLevelHeight(int level) const { return height >> level > 0 ? height >> level : 1; }
+    size_t getLevelOffset(int level) const;
+};
+
+std::string getBakedTexturePath(const std::string& image_path);
+
+// small images end up in the atlas where mips would bleed into neighbours, only bigger ones
+// get a chain
+bool shouldBakeMipmaps(int width, int height);
+
+// decodes the source image and converts it, doesnt touch the cache
+bool decodeTextureSource(const std::string& image_path, BakedTexture& out_texture);
+
+// returns false if there is no cache or it is stale, out_texture is left untouched in that case
+bool readBakedTexture(const std::string& image_path, BakedTexture& out_texture);
+bool writeBakedTexture(const std::string& image_path, const BakedTexture& texture);
+
+// reads the cache, or decodes the source and writes the cache for next time. safe to call
+// from several threads as long as they load different images
+bool loadBakedTexture(const std::string& image_path, BakedTexture& out_texture);
+}  // namespace vsrg
@@ -3,14 +3,23 @@
 #include <glad/glad.h>
 #include <ft2build.h>
 
+#include "core/ui/atlasPacker.hpp"
+#include "core/ui/textLayout.hpp"
 #include "public/engineContext.hpp"
 
 #include FT_FREETYPE_H
 #define GLM_FORCE_RADIANS
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <glm/glm.hpp>
-#include <optional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace vsrg {
@@ -18,7 +27,31 @@ namespace vsrg {
 using Charcode = FT_ULong;
 
 const unsigned int FONT_ATLAS_DEFAULT_SIZE = 2048;
+const size_t FONT_ATLAS_DEFAULT_MAX_PAGES = 4;  // per font, then old glyphs get evicted
 const int FONT_DEFAULT_SIZE_PT = 32;
+const size_t FONT_UPLOAD_BUDGET_BYTES = 256 * 1024;  // glyph pixels per frame, all fonts together
+
+// sdf fonts always rasterise at this size, any draw size is scaled from it
+const int FONT_SDF_SIZE_PT = 32;
+// distance in pixels stored on each side of the outline, also the padding around every sdf
+// glyph. enough for smooth edges when scaling down to about a quarter
+const int FONT_SDF_SPREAD = 8;
+
+enum class FontRenderMode {
+    BITMAP,  // coverage, crisp at size_pt but blurry when scaled
+    SDF,     // signed distance field, one atlas serves every size
+};
+
+// one program for all text, owned by FontManager
+struct TextProgram {
+    GLuint program = 0;
+    GLint projection_uniform = -1;
+    GLint atlas_uniform = -1;
+    GLint color_uniform = -1;
+    GLint opacity_uniform = -1;
+    GLint z_order_uniform = -1;
+    GLint sdf_uniform = -1;
+};
 
 struct Character {
     GLuint texture_id;
@@ -27,11 +60,26 @@ struct Character {
     GLuint advance;
     glm::vec2 atlas_offset;
     glm::vec2 atlas_size_norm;
+
+    // atlas bookkeeping, text doesnt need these to draw
+    int page = 0;
+    glm::ivec2 atlas_position = glm::ivec2(0);  // pixels
+    mutable int reference_count = 0;
+    mutable uint64_t last_used = 0;  // font frame of the last lookup or release
+};
+
+struct FontAtlasStats {
+    size_t pages = 0;
+    size_t max_pages = 0;
+    size_t glyphs = 0;
+    float occupancy = 0.0f;  // of the allocated pages
+    uint64_t evictions = 0;
 };
 
 class Font {
 public:
-    Font(EngineContext* engine_context, FT_Library ft, const std::string& path, int size_pt);
+    Font(EngineContext* engine_context, FT_Library ft, const std::string& path, int size_pt,
+         FontRenderMode render_mode = FontRenderMode::BITMAP);
     ~Font();
 
     Font(const Font&) = delete;
@@ -41,35 +89,114 @@ public:
     Font& operator=(Font&&) noexcept = default;
 
     bool isLoaded() const { return loaded; }
-    GLuint getVAO() const { return VAO; }
-    GLuint getVBO() const { return VBO; }
     int getSizePt() const { return size_pt; }
     int getBaselineHeight() const { return baseline_height; }
-    std::optional<Character> getCharacter(Charcode charcode);
+    FontRenderMode getRenderMode() const { return render_mode; }
+
+    // never blocks. a glyph that isnt in the atlas yet is queued for the worker thread and the
+    // placeholder (empty, notdef advance) is returned until processUploads adds it. nullptr if
+    // the glyph cant be rendered. the pointer stays valid while the glyph is retained, otherwise
+    // only until the next processUploads or preloadGlyphs, which can evict it
+    const Character* getCharacter(Charcode charcode);
+    bool isPlaceholder(const Character* character) const { return character == &placeholder; }
+
+    // retained glyphs are never evicted, text keeps the glyphs of its laid out quads retained.
+    // every retain needs a release, the placeholder is ignored
+    void retainGlyph(const Character* character);
+    void releaseGlyph(const Character* character);
+
+    // bumped whenever glyphs land, text laid out with placeholders redoes it when this changes
+    uint64_t getGlyphGeneration() const { return glyph_generation; }
+
+    // queues glyphs behind everything on screen so they are ready before anything asks
+    void prewarmGlyphs(const std::vector<Charcode>& charcodes);
+
+    // adds glyphs the worker has finished until budget_bytes of pixels are uploaded, returns the
+    // bytes used. gl thread only, called once per frame
+    size_t processUploads(size_t budget_bytes);
+
+    // once all pages are allocated, new glyphs evict the least recently used unretained ones
+    void setMaxAtlasPages(size_t pages) { max_atlas_pages = std::max<size_t>(pages, 1); }
+    FontAtlasStats getAtlasStats() const;
+    uint64_t getEvictionCount() const { return evictions; }
+
+    // rasterises every missing glyph of the list on worker threads, each with its own face, then
+    // uploads them in one go. for filling big ranges (cjk) up front instead of glyph by glyph
+    void preloadGlyphs(const std::vector<Charcode>& charcodes);
 
 private:
     struct Atlas {
         GLuint texture_id = 0;
         unsigned int width = 0;
         unsigned int height = 0;
-        unsigned int current_x = 0;
-        unsigned int current_y = 0;
-        unsigned int max_row_height = 0;
+        ShelfPacker packer;
+    };
+
+    // a rendered glyph that isnt in an atlas yet
+    struct GlyphBitmap {
+        Charcode charcode = 0;
+        unsigned int width = 0;
+        unsigned int rows = 0;
+        int left = 0;
+        int top = 0;
+        GLuint advance = 0;
+        std::vector<unsigned char> pixels;  // tightly packed, width * rows
+        bool valid = false;                 // false if freetype couldnt render it
     };
 
+    // shared with the worker, behind a pointer so the font stays movable
+    struct GlyphQueue {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<Charcode> requests;          // something on screen is waiting for these
+        std::deque<Charcode> prewarm_requests;  // only wanted eventually
+        std::vector<GlyphBitmap> rendered;
+        bool stop = false;
+    };
+
+    static bool renderGlyph(FT_Face face, FontRenderMode render_mode, Charcode charcode,
+                            GlyphBitmap& out_glyph);
+
+    // the worker has its own FT_Library and face, neither is thread safe
+    static void glyphWorker(GlyphQueue* queue, std::string path, int size_pt,
+                            FontRenderMode render_mode);
+
     bool createNewAtlas();
-    bool initBuffers();
-    bool loadGlyph(Charcode charcode);
+    void requestGlyph(Charcode charcode);
+    void startGlyphWorker();
+    bool addGlyph(const GlyphBitmap& glyph);
+    // evicts unretained glyphs oldest first until a width x height rect fits somewhere
+    bool evictForGlyph(int width, int height, int& out_page, glm::ivec2& out_position);
 
     EngineContext* engine_context;
     bool loaded = false;
     FT_Face face = nullptr;
+    std::string path;
     int size_pt = 0;
+    FontRenderMode render_mode = FontRenderMode::BITMAP;
     int baseline_height = 0;
-    GLuint VAO = 0;
-    GLuint VBO = 0;
     std::vector<Atlas> atlases;
     std::unordered_map<Charcode, Character> characters;
+    size_t max_atlas_pages = FONT_ATLAS_DEFAULT_MAX_PAGES;
+    uint64_t frame_index = 0;  // bumped by processUploads
+    uint64_t evictions = 0;
+    // oldest first, built and sorted once a frame and shared by every eviction in it
+    std::vector<std::pair<uint64_t, Charcode>> eviction_candidates;
+    uint64_t eviction_frame = UINT64_MAX;  // none built yet
+    uint64_t released_glyphs = 0;          // releases that left a glyph unretained
+    std::vector<unsigned char> clear_pixels;  // zeros, wipes evicted glyphs
+
+    // everything below is gl thread only, except what sits inside glyph_queue
+    std::unique_ptr<GlyphQueue> glyph_queue;
+    std::thread glyph_worker;
+    std::unordered_map<Charcode, bool> requested_glyphs;  // queued, true if only for prewarm
+    std::unordered_set<Charcode> missing_glyphs;
+    std::deque<GlyphBitmap> ready_glyphs;  // rendered, waiting for upload budget
+    // rendered but every atlas was full of retained glyphs, retried once something is released
+    std::deque<GlyphBitmap> deferred_glyphs;
+    uint64_t deferred_release_count = 0;  // released_glyphs when the last one was deferred
+    Character placeholder = {};
+    uint64_t glyph_generation = 0;
 };
 
 class FontManager {
@@ -77,13 +204,37 @@ public:
     FontManager(EngineContext* engine_context);
     ~FontManager();
 
-    bool loadFont(const std::string& name, int size_pt = FONT_DEFAULT_SIZE_PT);
-    Font* getFont(const std::string& name);
+    // fonts are keyed by name, size and mode. sdf fonts ignore size_pt, one of them covers every
+    // size
+    bool loadFont(const std::string& name, int size_pt = FONT_DEFAULT_SIZE_PT,
+                  FontRenderMode render_mode = FontRenderMode::BITMAP);
+    Font* getFont(const std::string& name, int size_pt = FONT_DEFAULT_SIZE_PT,
+                  FontRenderMode render_mode = FontRenderMode::BITMAP);
+
+    // compiled on first use
+    const TextProgram& getTextProgram();
+
+    // call once per frame on the gl thread, adds glyphs rendered in the background
+    void processUploads();
+
+    // applies to every font, loaded or not
+    void setMaxAtlasPages(size_t pages);
+    // summed over all fonts
+    FontAtlasStats getAtlasStats() const;
+
+    // laid out strings of every font, shared by all text
+    TextLayoutCache& getLayoutCache() { return layout_cache; }
 
 private:
+    static std::string getFontKey(const std::string& name, int size_pt,
+                                  FontRenderMode render_mode);
+
     EngineContext* engine_context;
+    TextProgram text_program;
     FT_Library ft;
+    size_t max_atlas_pages = FONT_ATLAS_DEFAULT_MAX_PAGES;
     std::unordered_map<std::string, Font> fonts;
+    TextLayoutCache layout_cache;
 };
 
 }  // namespace vsrg
\ No newline at end of file
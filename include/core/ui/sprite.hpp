@@ -2,28 +2,43 @@
 
 #include <glad/glad.h>
 
+#include "core/engine/streamBuffer.hpp"
 #include "core/ui/texture.hpp"
 #include "public/engineContext.hpp"
 
 #define GLM_FORCE_RADIANS
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
 
 namespace vsrg {
+// 16 bytes, quads are 4 of these drawn through a shared index buffer. z comes from the batch
+// layer so it is a uniform instead of a per vertex attribute
 struct SpriteVertex {
     glm::vec2 position;
-    glm::vec2 tex_coords;
-    float opacity;
-    float z_order;
+    uint16_t tex_coords[2];  // half floats
+    uint8_t opacity;         // unorm8
+    uint8_t padding[3];
 };
+static_assert(sizeof(SpriteVertex) == 16, "SpriteVertex should stay 16 bytes");
+
+// one per sprite for the instanced backend, the vertex shader expands it into a quad
+struct SpriteInstance {
+    glm::vec2 origin;     // position minus the anchor offset, the rotation pivots on it
+    glm::vec2 size;       // already scaled
+    uint16_t uv_rect[4];  // half floats, u1 v1 u2 v2
+    float rotation;       // radians
+    uint8_t opacity;      // unorm8
+    uint8_t padding[3];
+};
+static_assert(sizeof(SpriteInstance) == 32, "SpriteInstance should stay 32 bytes");
 
-struct SpriteBatch {
-    GLuint texture_id;
-    int layer;
-    std::vector<SpriteVertex> vertices;
-    size_t sprite_count = 0;
+enum class SpriteBackend {
+    BATCHED,    // cpu transformed quads, 4 vertices per sprite
+    INSTANCED,  // one instance per sprite, quads are built on the gpu
 };
 
 class SpriteRenderer {
@@ -33,17 +48,18 @@ public:
 
     void begin();
 
-    void drawSprite(const std::string &texture_path, const glm::vec2 &position,
-                    const glm::vec2 &size, float rotation = 0.0f,
-                    const glm::vec2 &anchor = glm::vec2(0.0f),
+    // textures are passed as handles so the hot path never hashes a path, get one from
+    // TextureCache::getHandle once up front
+    void drawSprite(TextureHandle texture, const glm::vec2 &position, const glm::vec2 &size,
+                    float rotation = 0.0f, const glm::vec2 &anchor = glm::vec2(0.0f),
                     const glm::vec2 &scale = glm::vec2(1.0f), float opacity = 1.0f, int layer = 0);
 
-    void drawSprite(const std::string &texture_path, const glm::vec2 &position,
-                    const glm::vec2 &size, const glm::vec4 &uv_rect, float rotation = 0.0f,
+    void drawSprite(TextureHandle texture, const glm::vec2 &position, const glm::vec2 &size,
+                    const glm::vec4 &uv_rect, float rotation = 0.0f,
                     const glm::vec2 &anchor = glm::vec2(0.0f),
                     const glm::vec2 &scale = glm::vec2(1.0f), float opacity = 1.0f, int layer = 0);
 
-    void drawSpriteImmediate(const std::string &texture_path, const glm::vec2 &position,
+    void drawSpriteImmediate(TextureHandle texture, const glm::vec2 &position,
                              const glm::vec2 &size, float rotation = 0.0f,
                              const glm::vec2 &anchor = glm::vec2(0.0f),
                              const glm::vec2 &scale = glm::vec2(1.0f), float opacity = 1.0f,
@@ -52,23 +68,57 @@ public:
     void end();
     void flush();
 
+    // both backends give the same output, switching flushes whatever is queued
+    void setBackend(SpriteBackend new_backend);
+    SpriteBackend getBackend() const { return backend; }
+
 private:
     void setupShader();
     void setupBuffers();
 
-    SpriteBatch *getBatch(GLuint texture_id, int layer);
+    // sorts sort_keys, all the batching happens here
+    void sortKeys();
+
+    // uv_rect is relative to the image (nullptr for all of it), atlas placement is applied here
+    void pushQuad(TextureHandle texture, const glm::vec2 &position, const glm::vec2 &size,
+                  const glm::vec4 *uv_rect, float rotation, const glm::vec2 &anchor,
+                  const glm::vec2 &scale, float opacity, int layer);
 
     EngineContext *engine_context;
 
+    SpriteBackend backend = SpriteBackend::BATCHED;
+
     GLuint shader_program = 0;
     GLuint vao = 0;
-    GLuint vbo = 0;
+    GLuint index_buffer = 0;
+    std::unique_ptr<StreamBuffer> vertex_stream;
 
     GLint projection_uniform;
     GLint texture_uniform;
+    GLint z_order_uniform;
 
-    std::vector<SpriteBatch> batches;
+    GLuint instanced_program = 0;
+    GLuint instanced_vao = 0;
 
+    GLint instanced_projection_uniform;
+    GLint instanced_texture_uniform;
+    GLint instanced_z_order_uniform;
+
+    // every sprite since the last flush, in submission order. the sort key is
+    // layer (16 bits) | texture (24 bits) | sequence (24 bits), sequence indexes the quad data.
+    // all of these keep their capacity between frames
+    std::vector<uint64_t> sort_keys;
+    std::vector<uint64_t> sort_scratch;
+    std::vector<SpriteVertex> quad_vertices;     // 4 per sprite, batched backend
+    std::vector<SpriteInstance> quad_instances;  // 1 per sprite, instanced backend
+
+    static constexpr uint64_t MAX_SEQUENCE = (1 << 24) - 1;
+
+    // most sprites a single draw call covers
     static constexpr size_t MAX_BATCH_SIZE = 1000;
+    static_assert(MAX_BATCH_SIZE * 4 <= 65536, "quad indices are 16 bit");
+
+    // each stream chunk fits a few full batches, the ring has three of them
+    static constexpr size_t STREAM_CHUNK_SIZE = sizeof(SpriteVertex) * 4 * MAX_BATCH_SIZE * 4;
 };
 }  // namespace vsrg
\ No newline at end of file
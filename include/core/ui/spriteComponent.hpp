@@ -12,7 +12,10 @@
 namespace vsrg {
 class SpriteComponent : public UIComponent {
 public:
-    SpriteComponent(EngineContext *engine_context, const std::string &spritePath);
+    // load_async decodes the texture in the background, the sprite shows up once it is uploaded
+    // and getSize has no texture dimensions to go off until then
+    SpriteComponent(EngineContext *engine_context, const std::string &spritePath,
+                    bool load_async = false);
     virtual ~SpriteComponent();
 
     void render() override;
@@ -21,8 +24,14 @@ public:
     bool isLoaded() const { return loaded; }
 
 private:
+    void checkRequest();
+
     std::string texture_path;
+    TextureHandle texture_handle;  // resolved once, render only passes this around
     glm::vec2 dimensions;
     bool loaded = false;
+
+    TextureRequest request;
+    TextureRef texture_ref;  // keeps the texture cached for as long as the sprite exists
 };
 }  // namespace vsrg
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "core/ui/font.hpp"
+#include "core/ui/textLayout.hpp"
 #include "core/ui/uiComponent.hpp"
 #include "public/engineContext.hpp"
 
@@ -17,37 +20,60 @@ struct TextRenderOptions {
     float line_gap = 2.0f;
 };
 
+// fixed size text for values that change every frame (fps, combo, accuracy), formatting into it
+// never allocates. anything past the capacity is cut off
+const size_t TEXT_BUFFER_CAPACITY = 256;
+
+class TextBuffer {
+public:
+    void clear() { length = 0; }
+
+    TextBuffer &append(std::string_view text);
+    TextBuffer &appendInt(long long value);
+    // always with exactly decimals digits after the point
+    TextBuffer &appendFixed(double value, int decimals);
+
+    std::string_view view() const { return std::string_view(data, length); }
+
+private:
+    char data[TEXT_BUFFER_CAPACITY];
+    size_t length = 0;
+};
+
 class TextComponent : public UIComponent {
 public:
     TextComponent(EngineContext *engine_context, Font *font, const std::string &text = "",
                   const TextRenderOptions &text_options = TextRenderOptions{});
     virtual ~TextComponent();
 
-    void setText(const std::string &text);
+    TextComponent(const TextComponent &) = delete;
+    TextComponent &operator=(const TextComponent &) = delete;
+
+    // all of these skip the layout when nothing it depends on changed. layouts are shared through
+    // the font manager's cache, so text switching between a few values lays out once per value
+    void setText(std::string_view new_text);
     void setFont(Font *new_font);
     void setTextOptions(const TextRenderOptions &options);
 
     void render() override;
-    glm::vec2 getSize() const override { return drawable_string.dimensions; }
+    glm::vec2 getSize() const override {
+        return layout ? layout->dimensions : glm::vec2(0.0f);
+    }
 
-private:
-    struct DrawableString {
-        std::vector<Charcode> text;
-        glm::vec2 dimensions = glm::vec2(0.0f);
-    };
+    // invalid or truncated sequences become '?'. out needs room for str.size() charcodes,
+    // returns how many were written. ascii runs are widened a simd block at a time
+    static size_t decodeUTF8(std::string_view str, Charcode *out);
+    // replaces the contents of out, reusing its capacity
+    static void decodeUTF8(std::string_view str, std::vector<Charcode> &out);
+    static std::vector<Charcode> decodeUTF8(const std::string &str);
 
-    float getScalingFactor() const;
-    std::vector<Charcode> decodeUTF8(const std::string &str);
-    glm::vec2 calculateDimensions(const std::vector<Charcode> &text);
+private:
+    // swaps in the cached layout for the current text, font and options
+    void updateLayout();
 
     Font *font;
-    GLuint shader_program;
-    GLint projection_uniform;
-    GLint atlas_uniform;
-    GLint color_uniform;
-    GLint opacity_uniform;
-    GLint z_order_uniform;
+    std::string text;
     TextRenderOptions text_options;
-    DrawableString drawable_string;
+    TextLayout *layout = nullptr;
 };
 }  // namespace vsrg
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+
+namespace vsrg {
+class Font;
+struct Character;
+
+using Charcode = FT_ULong;
+
+// layouts nobody shows anymore are kept for this many strings, so hud values flipping between a
+// few states never lay out twice
+const size_t TEXT_LAYOUT_CACHE_CAPACITY = 256;
+// recycled layouts keep their vectors and buffers, only this many are kept around
+const size_t TEXT_LAYOUT_POOL_SIZE = 32;
+
+// glyph quads are grouped by atlas texture, each run is one draw call
+struct TextRun {
+    GLuint texture_id;
+    GLint first;    // first vertex
+    GLsizei count;  // vertices
+};
+
+// one laid out string, shared by every text component showing the same text in the same font
+// and size
+struct TextLayout {
+    uint64_t key = 0;
+    Font* font = nullptr;
+    std::string text;
+    float size = 0.0f;
+    float line_gap = 0.0f;
+
+    glm::vec2 dimensions = glm::vec2(0.0f);
+    std::vector<TextRun> runs;
+    // xy position, zw atlas uv. 6 per glyph, ordered by run
+    std::vector<glm::vec4> vertices;
+    // every glyph with a quad, retained so the font cant evict it from under the vertices
+    std::vector<const Character*> glyphs;
+
+    // laid out with placeholders. only matches until the font's glyph generation moves on,
+    // then text using it lays out again
+    bool waiting_for_glyphs = false;
+    uint64_t glyph_generation = 0;
+    // unused layouts dont hold on to their glyphs, any eviction since then means laying out again
+    uint64_t eviction_count = 0;
+
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    size_t vbo_capacity = 0;  // bytes
+    bool uploaded = false;
+
+    int reference_count = 0;
+    std::list<TextLayout*>::iterator unused_entry;  // valid while reference_count is 0
+};
+
+class TextLayoutCache {
+public:
+    TextLayoutCache() = default;
+    ~TextLayoutCache();
+
+    TextLayoutCache(const TextLayoutCache&) = delete;
+    TextLayoutCache& operator=(const TextLayoutCache&) = delete;
+
+    // the layout of text in font at size, laid out on a miss. every acquire needs a release
+    TextLayout* acquire(Font* font, std::string_view text, float size, float line_gap);
+    void release(TextLayout* layout);
+
+    // uploads the vertices on first use
+    GLuint getVertexArray(TextLayout* layout);
+
+    // drops every layout, only call once no text is using them
+    void clear();
+
+private:
+    static uint64_t hashKey(const Font* font, std::string_view text, float size, float line_gap);
+    // laid out with placeholders for glyphs that have landed since
+    bool isStale(const TextLayout& layout) const;
+
+    void build(TextLayout& layout);
+    // takes it out of the map, callers take it off the unused list themselves
+    void remove(TextLayout* layout);
+    void recycle(std::unique_ptr<TextLayout> layout);
+    void destroy(TextLayout& layout);
+
+    std::unordered_multimap<uint64_t, std::unique_ptr<TextLayout>> layouts;
+    std::list<TextLayout*> unused;  // unreferenced layouts, least recently released first
+    std::vector<std::unique_ptr<TextLayout>> pool;
+
+    // kept for their capacity
+    std::vector<Charcode> charcode_scratch;
+    std::vector<glm::vec4> vertex_scratch;
+    std::vector<GLuint> glyph_textures;
+    std::vector<GLint> run_cursors;
+};
+}  // namespace vsrg
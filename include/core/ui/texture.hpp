@@ -2,21 +2,124 @@
 
 #include <glad/glad.h>
 
+#include "core/engine/streamBuffer.hpp"
+#include "core/ui/atlasPacker.hpp"
 #include "public/engineContext.hpp"
 
 #define GLM_FORCE_RADIANS
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <glm/glm.hpp>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace vsrg {
+
+// small textures (skin elements) are packed into shared pages so they batch into one draw call,
+// anything bigger than the entry limit gets its own texture
+const int TEXTURE_ATLAS_PAGE_SIZE = 1024;
+const int TEXTURE_ATLAS_MAX_ENTRY_SIZE = 256;
+const int TEXTURE_ATLAS_PADDING = 2;  // edge pixels are repeated into it so filtering never bleeds
+
+// async loads upload at most this much per frame (at least one image always goes through)
+const size_t TEXTURE_UPLOAD_BUDGET_BYTES = 8 * 1024 * 1024;
+const size_t TEXTURE_UPLOAD_CHUNK_SIZE = 16 * 1024 * 1024;  // per pbo chunk, bigger images skip it
+
+// unreferenced textures are evicted oldest first once the cache goes over this, see setVramBudget
+const size_t TEXTURE_VRAM_BUDGET_DEFAULT = 256 * 1024 * 1024;
+
+// an interned texture path, resolving one is an array index instead of hashing the string.
+// handles stay valid for the life of the cache, eviction and clearAll only unload the texture
+struct TextureHandle {
+    uint32_t id = 0;  // 0 is never handed out
+
+    bool valid() const { return id != 0; }
+    bool operator==(const TextureHandle& other) const = default;
+};
+
 struct CachedTexture {
+    TextureHandle handle;
     GLuint texture_id = 0;
     glm::ivec2 dimensions = glm::ivec2(0);
     int channels = 0;
     bool loaded = false;
     int reference_count = 0;
+    uint64_t generation = 0;  // new for every entry stored under a path, see TextureRef
+
+    // where the image sits inside texture_id, x y w h normalized. uvs given to the sprite
+    // renderer are relative to this, so they have to stay within 0-1 (no wrapping)
+    glm::vec4 uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    int atlas_page = -1;  // -1 when the texture isnt in an atlas
+
+    // still decoding, texture_id is the shared placeholder until the real one is uploaded
+    bool pending = false;
+
+    // gpu memory for this entry, all mip levels. atlas entries count their padded rect
+    size_t vram_bytes = 0;
+    uint64_t last_used = 0;  // frame of the last getTexture, drives the lru eviction
+};
+
+struct TextureCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;  // anything that had to be loaded, sync or async
+    uint64_t evictions = 0;
+
+    // what is actually allocated: standalone textures plus whole atlas pages
+    size_t vram_bytes = 0;
+    size_t vram_budget = 0;
+};
+
+// handed out by loadTextureAsync, ready once the texture has been uploaded on the gl thread
+class TextureRequest {
+public:
+    TextureRequest() = default;
+
+    bool valid() const { return state != nullptr; }
+    bool isReady() const { return state && state->ready.load(); }
+    bool failed() const { return state && state->failed.load(); }
+
+private:
+    friend class TextureCache;
+
+    struct State {
+        std::atomic<bool> ready{false};
+        std::atomic<bool> failed{false};
+    };
+
+    std::shared_ptr<State> state;
+};
+
+class TextureCache;
+
+// keeps a cache entry from being evicted or cleared while it is alive. the texture has to be
+// loaded (or queued) before the ref is made, copies add their own reference
+class TextureRef {
+public:
+    TextureRef() = default;
+    TextureRef(TextureCache* cache, const std::string& path);
+    ~TextureRef();
+
+    TextureRef(const TextureRef& other);
+    TextureRef& operator=(const TextureRef& other);
+    TextureRef(TextureRef&& other) noexcept;
+    TextureRef& operator=(TextureRef&& other) noexcept;
+
+    void reset();
+
+    bool valid() const { return cache != nullptr; }
+    const std::string& getPath() const { return path; }
+
+private:
+    TextureCache* cache = nullptr;
+    std::string path;
+    uint64_t generation = 0;  // of the entry the reference was added to
 };
 
 class TextureCache {
@@ -27,19 +130,108 @@ public:
     TextureCache(const TextureCache&) = delete;
     TextureCache& operator=(const TextureCache&) = delete;
 
-    CachedTexture* getTexture(const std::string& path);
-    void addReference(const std::string& path);
+    // loads synchronously if the texture isnt cached yet. a texture still loading asynchronously
+    // is finished on the spot unless wait_if_pending is false, then the placeholder comes back
+    CachedTexture* getTexture(const std::string& path, bool wait_if_pending = true);
+    CachedTexture* getTexture(TextureHandle handle, bool wait_if_pending = true);
+
+    // interns the path, the texture itself isnt loaded until something asks for it
+    TextureHandle getHandle(const std::string& path);
+    const std::string& getPath(TextureHandle handle) const;
+
+    // decodes on the worker threads, the upload happens in processUploads
+    TextureRequest loadTextureAsync(const std::string& path);
+
+    // uploads finished decodes within the frame budget and evicts down to the vram budget,
+    // call once per frame on the gl thread before anything is drawn
+    void processUploads();
+
+    // prefer TextureRef over calling these directly. addReference returns the entry's
+    // generation (0 if the path isnt cached) and removeReference only counts it off that same
+    // entry, so a reference outliving an erased entry cant take one off its replacement
+    uint64_t addReference(const std::string& path);
+
+    void removeReference(const std::string& path, uint64_t generation);
 
-    void removeReference(const std::string& path);
+    // drops every unreferenced texture that wasnt used this frame or the one before
     void clearUnused();
 
+    // soft limit, only unreferenced standalone textures can go and anything drawn in the last
+    // frame stays, so usage can sit above it for a while
+    void setVramBudget(size_t bytes);
+    const TextureCacheStats& getStats() const { return stats; }
+
     void clearAll();
     size_t getCachedTextureCount() const { return textures.size(); }
+    size_t getAtlasPageCount() const { return atlas_pages.size(); }
+    size_t getPendingCount() const { return pending_requests.size(); }
 
 private:
-    bool loadTextureFromFile(const std::string& path, CachedTexture& texture);
+    struct AtlasPage {
+        GLuint texture_id = 0;
+        SkylinePacker packer;
+        int entry_count = 0;
+    };
+
+    // cpu side of a load, everything here can happen off the gl thread
+    struct DecodedImage {
+        std::string path;
+        int width = 0;
+        int height = 0;
+        int channels = 0;    // of the source file, pixels are always premultiplied rgba
+        int levels = 1;      // mip levels in pixels, back to back
+        bool atlas = false;  // pixels are already padded for an atlas page
+        bool ok = false;
+        std::vector<unsigned char> pixels;
+    };
+
+    static void decodeImage(const std::string& path, DecodedImage& image);
+    bool uploadImage(const DecodedImage& image, CachedTexture& texture, bool use_pbo);
+
+    bool placeInAtlas(int padded_width, int padded_height, int& page_index,
+                      glm::ivec2& position);
+    bool createAtlasPage();
+    void releaseTexture(CachedTexture& texture);
+    CachedTexture* storeTexture(const std::string& path, const CachedTexture& texture);
+    std::unordered_map<std::string, CachedTexture>::iterator eraseTexture(
+        std::unordered_map<std::string, CachedTexture>::iterator it);
+
+    bool isEvictable(const CachedTexture& texture) const;
+    void evictToBudget();
+
+    GLuint getPlaceholderTexture();
+    void finishPending(const std::string& path);
+    void completeUpload(DecodedImage& image, bool use_pbo);
+
+    void workerLoop();
 
     EngineContext* engine_context;
     std::unordered_map<std::string, CachedTexture> textures;
+
+    // indexed by handle id. the slots point into textures (its nodes never move) and are null
+    // while that path isnt cached
+    std::unordered_map<std::string, uint32_t> handle_ids;
+    std::vector<std::string> handle_paths;
+    std::vector<CachedTexture*> handle_textures;
+    std::vector<AtlasPage> atlas_pages;
+
+    TextureCacheStats stats;
+    uint64_t frame_index = 0;  // bumped by processUploads
+    uint64_t next_generation = 1;
+    std::vector<std::pair<uint64_t, std::string>> eviction_candidates;
+
+    GLuint placeholder_texture = 0;
+    std::unique_ptr<StreamBuffer> upload_stream;
+    std::unordered_map<std::string, std::shared_ptr<TextureRequest::State>> pending_requests;
+
+    // worker pool, jobs are asset paths and results wait for processUploads
+    std::vector<std::thread> workers;
+    std::mutex queue_mutex;
+    std::condition_variable queue_condition;
+    std::condition_variable decoded_condition;
+    std::deque<std::string> decode_queue;
+    std::vector<DecodedImage> decoded;
+    std::vector<DecodedImage> uploading;  // only touched on the gl thread
+    bool stopping = false;
 };
-}  // namespace vsrg
\ No newline at end of file
+}  // namespace vsrg
@@ -24,6 +24,9 @@ namespace vsrg
     std::string getCurrentDate();
     std::string getCurrentTimestamp(bool showMs = true);
 
+    // threads for a background pool, between 1 and 4, leaving a core for the render thread
+    unsigned int backgroundWorkerCount();
+
     float getFPS(float deltaTime);
     size_t getMemoryUsage();
     std::string getFormattedMemoryUsage();
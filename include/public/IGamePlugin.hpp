@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -7,7 +8,27 @@ namespace vsrg
 {
     class EngineContext;
     struct ChartData;
-    struct InputEvent;
+
+    enum class InputEventType
+    {
+        KEY_DOWN,
+        KEY_UP
+    };
+
+    struct InputEvent
+    {
+        InputEventType type;
+
+        int scancode;  // SDL_Scancode, physical key so layouts dont matter for gameplay
+        int keycode;   // SDL_Keycode
+        bool repeat;
+
+        // when the os saw the key, in std::chrono::steady_clock nanoseconds
+        int64_t timestamp_ns;
+
+        // song time of the event from the conductor set on the input manager, -1 without one
+        double song_time;
+    };
 
     struct PluginInfo
     {
@@ -27,6 +48,10 @@ namespace vsrg
         virtual void load() = 0;
         virtual void update(float delta_time) = 0;
         virtual void render() = 0;
+
+        // every key event since the last call, oldest first, called once per frame before update
+        virtual void on_input(const std::vector<InputEvent>& events) {}
+
         virtual void unload() = 0;
         virtual void shutdown() = 0;
 
@@ -9,6 +9,7 @@ class TextureCache;
 class ScreenManager;
 class PluginManager;
 class SpriteRenderer;
+class InputManager;
 
 // this is a safe interface to expose to screens or any future plugins
 class EngineContext {
@@ -30,6 +31,7 @@ public:
     ScreenManager* get_screen_manager() const { return screen_manager; }
     PluginManager* get_plugin_manager() const { return plugin_manager; }
     SpriteRenderer* get_sprite_renderer() const { return sprite_renderer; }
+    InputManager* get_input_manager() const { return input_manager; }
 
     // convenience getters for common data (define in cpp)
     int get_screen_width() const;
@@ -47,5 +49,6 @@ private:
     ScreenManager* screen_manager;
     PluginManager* plugin_manager;
     SpriteRenderer* sprite_renderer;
+    InputManager* input_manager;
 };
 }  // namespace vsrg
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+
+namespace vsrg {
+// turns the coarse audio cursor (it only moves once per audio period) into a smooth song clock.
+// every cursor change is stamped with steady_clock and a line is fitted through the recent ones,
+// so any point in time can be mapped to song time without the period sized steps
+class AudioClock {
+public:
+    using clock = std::chrono::steady_clock;
+
+    AudioClock();
+
+    // drops the fit and restarts from a known song time, for seeking, starting and resuming
+    void reset(double song_time, clock::time_point now);
+
+    // playback rate the fit is expected to land near, keeps the current song time continuous
+    void set_rate(double rate, clock::time_point now);
+    double get_rate() const { return fitted_rate; }
+
+    // call whenever the audio cursor has moved, audio_time is the cursor in seconds
+    void add_sample(clock::time_point now, double audio_time);
+
+    double song_time_at(clock::time_point time) const;
+
+private:
+    struct Sample {
+        double wall;   // seconds since origin
+        double audio;  // cursor in seconds
+    };
+
+    static constexpr size_t MAX_SAMPLES = 128;
+
+    // cursor jumps bigger than this are treated as a seek or a stall and restart the fit
+    static constexpr double RESYNC_THRESHOLD = 0.1;
+
+    // the fitted rate is kept within this fraction of the nominal one,
+    // real clock drift is in the ppm range so anything bigger is just noise in the samples
+    static constexpr double MAX_RATE_DEVIATION = 0.02;
+
+    std::array<Sample, MAX_SAMPLES> samples;
+    size_t sample_count = 0;
+    size_t next_sample = 0;
+
+    clock::time_point origin;
+    double nominal_rate = 1.0;
+
+    // song_time = base_time + fitted_rate * seconds since origin
+    double fitted_rate = 1.0;
+    double base_time = 0.0;
+
+    double seconds_since_origin(clock::time_point time) const {
+        return std::chrono::duration<double>(time - origin).count();
+    }
+
+    void refit();
+};
+}  // namespace vsrg
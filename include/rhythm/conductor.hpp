@@ -1,19 +1,15 @@
 #pragma once
 
+#include <chrono>
 #include <vector>
 
 #include "core/engine/audio.hpp"
 #include "core/engine/shader.hpp"
+#include "rhythm/audioClock.hpp"
+#include "rhythm/timingMap.hpp"
 
 
 namespace vsrg {
-struct TimingPoint {
-    float time;
-    double bpm;
-
-    int nominator;
-    int denominator;
-};
 
 class Conductor {
 public:
@@ -30,21 +26,32 @@ public:
         if (current_point != nullptr) return current_point->bpm;
         return -1.0f;
     }
-    float get_bpm_at_time(float time);
+    float get_bpm_at_time(float time) const;
+
+    double beat_at_time(double time) const { return timing_map.beat_at_time(time); }
+    double time_at_beat(double beat) const { return timing_map.time_at_beat(beat); }
 
     glm::vec2 get_time_signature() {
         if (current_point != nullptr)
             return glm::vec2(current_point->nominator, current_point->denominator);
         return glm::vec2(4, 4);
     }
-    std::vector<TimingPoint> get_timing_points() { return timing_points; }
+    const std::vector<TimingPoint>& get_timing_points() const { return timing_map.get_points(); }
+    const TimingMap& get_timing_map() const { return timing_map; }
 
     float get_song_position() { return song_position; }
+
+    // exact song time for any moment (input events, vsync), not just the last update
+    double song_time_at(std::chrono::steady_clock::time_point time) const {
+        return clock.song_time_at(time) - cached_latency;
+    }
+
     float get_song_duration() { return song_duration; }
     float get_playback_rate() { return playback_rate; }
 
     void set_playback_rate(float rate) {
         playback_rate = rate;
+        clock.set_rate(rate, std::chrono::steady_clock::now());
         if (audio != nullptr) audio->set_playback_rate(rate);
     }
 
@@ -54,15 +61,17 @@ public:
 private:
     Audio* audio;
     AudioManager* audio_manager;
-    TimingPoint* current_point;
+    const TimingPoint* current_point;
 
     float playback_rate = 1.0f;
     float song_position = 0.0f;
     float song_duration = 0.0f;
 
-    float last_hardware_position = 0.0f;
+    double last_hardware_position = 0.0;
     float cached_latency = 0.0f;
 
+    AudioClock clock;
+
     int current_beat = 0;
     int current_step = 0;
 
@@ -70,7 +79,7 @@ private:
     int last_beat = -1;
 
     size_t current_point_index = 0;
-    std::vector<TimingPoint> timing_points;
+    TimingMap timing_map;
 
     void updateBPM();
 };
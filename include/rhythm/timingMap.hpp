@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+namespace vsrg {
+struct TimingPoint {
+    float time;
+    double bpm;
+
+    int nominator;
+    int denominator;
+};
+
+// sorted, read only view of a charts timing points, every lookup is a binary search
+// beats are quarter notes counted from the first timing point, time before it uses the first bpm
+class TimingMap {
+public:
+    TimingMap() = default;
+    explicit TimingMap(std::vector<TimingPoint> timing_points);
+
+    const std::vector<TimingPoint>& get_points() const { return points; }
+    size_t size() const { return points.size(); }
+    bool empty() const { return points.empty(); }
+
+    // index of the last point at or before time, 0 if time is before every point
+    size_t get_point_index_at(double time) const;
+    const TimingPoint* get_point_at(double time) const;
+
+    double get_bpm_at(double time) const;
+
+    double beat_at_time(double time) const;
+    double time_at_beat(double beat) const;
+
+private:
+    std::vector<TimingPoint> points;
+    std::vector<double> point_beats;  // beat each point starts on, same index as points
+};
+}  // namespace vsrg
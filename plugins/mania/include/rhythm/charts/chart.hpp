@@ -12,6 +12,16 @@ public:
     virtual ~IChartLoader() = default;
 
     virtual bool loadChart(const std::string& filepath, ChartData& out_data) = 0;
+
+    // only what a song list needs, loaders should override this to skip the notes
+    virtual bool loadMetadata(const std::string& filepath, ChartMetadata& out_metadata) {
+        ChartData data;
+        if (!loadChart(filepath, data)) return false;
+
+        out_metadata = std::move(data.metadata);
+        return true;
+    }
+
     virtual bool canLoad(const std::string& filepath) const = 0;
 
     virtual std::string getLoaderName() const = 0;
@@ -35,6 +45,22 @@ public:
         return false;
     }
 
+    bool loadMetadata(const std::string& filepath, ChartMetadata& out_metadata) {
+        for (auto& loader : loaders) {
+            if (loader->canLoad(filepath)) {
+                return loader->loadMetadata(filepath, out_metadata);
+            }
+        }
+        return false;
+    }
+
+    bool canLoad(const std::string& filepath) const {
+        for (auto& loader : loaders) {
+            if (loader->canLoad(filepath)) return true;
+        }
+        return false;
+    }
+
     const std::vector<std::shared_ptr<IChartLoader>>& getLoaders() const { return loaders; }
 
 private:
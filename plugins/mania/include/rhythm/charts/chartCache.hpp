@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "rhythm/charts/chartData.hpp"
+
+
+namespace mania {
+// compiled charts are stored next to the source file as "<chart>.vsc"
+// bump CHART_CACHE_VERSION whenever the layout or the parser output changes
+const uint32_t CHART_CACHE_MAGIC = 0x43435356;  // "VSCC"
+const uint32_t CHART_CACHE_VERSION = 2;
+
+struct ChartCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+
+    // used to invalidate the cache when the source chart changes
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t source_hash;
+
+    int32_t key_count;
+    float preview_time;
+    float offset;
+
+    uint32_t note_count;
+    uint32_t timing_point_count;
+    uint32_t string_count;
+    uint32_t string_data_size;
+    uint32_t scroll_velocity_count;
+};
+
+std::string getChartCachePath(const std::string& chart_path);
+
+// returns false if there is no cache or it is stale, out_data is left untouched in that case
+bool readChartCache(const std::string& chart_path, ChartData& out_data);
+bool writeChartCache(const std::string& chart_path, const ChartData& data);
+}  // namespace mania
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -8,7 +9,7 @@
 
 
 namespace mania {
-enum class VSRGNoteType { TAP, HOLD, MINE, ROLL };
+enum class VSRGNoteType : uint8_t { TAP, HOLD, MINE, ROLL };
 
 struct VSRGNote {
     int column;
@@ -23,6 +24,12 @@ struct VSRGNote {
         : column(col), time(t), end_time(et), type(nt) {}
 };
 
+// osu calls these inherited timing points, multiplier scales scroll speed from time onwards
+struct ScrollVelocity {
+    float time;
+    float multiplier;
+};
+
 struct ChartMetadata {
     std::string title;
     std::string subtitle;
@@ -43,6 +50,7 @@ struct ChartData {
     ChartMetadata metadata;
     std::vector<VSRGNote> notes;
     std::vector<vsrg::TimingPoint> timing_points;
+    std::vector<ScrollVelocity> scroll_velocities;
 
     std::vector<VSRGNote> getNotesForColumn(int column) const {
         std::vector<VSRGNote> result;
@@ -64,5 +72,12 @@ struct ChartData {
             timing_points.begin(), timing_points.end(),
             [](const vsrg::TimingPoint& a, const vsrg::TimingPoint& b) { return a.time < b.time; });
     }
+
+    // stable so the last velocity at a given time keeps winning
+    void sortScrollVelocities() {
+        std::stable_sort(
+            scroll_velocities.begin(), scroll_velocities.end(),
+            [](const ScrollVelocity& a, const ScrollVelocity& b) { return a.time < b.time; });
+    }
 };
 }  // namespace mania
\ No newline at end of file
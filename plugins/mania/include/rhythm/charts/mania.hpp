@@ -1,31 +1,51 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "rhythm/charts/chart.hpp"
 
 
 namespace mania {
+enum class OsuSection {
+    NONE,
+    GENERAL,
+    METADATA,
+    DIFFICULTY,
+    TIMING_POINTS,
+    EVENTS,
+    HIT_OBJECTS,
+    UNKNOWN
+};
+
 class ManiaLoader : public IChartLoader {
 public:
     ManiaLoader() = default;
     ~ManiaLoader() override = default;
 
     bool loadChart(const std::string& filepath, ChartData& out_data) override;
+    bool loadMetadata(const std::string& filepath, ChartMetadata& out_metadata) override;
+
+    bool parseChart(std::string_view source, ChartData& out_data);
+    bool parseMetadata(std::string_view source, ChartMetadata& out_metadata);
 
     bool canLoad(const std::string& filepath) const override { return filepath.ends_with(".osu"); }
 
     std::string getLoaderName() const override { return "osu!mania"; }
 
 private:
-    void parseGeneralSection(const std::string& line, ChartData& data);
-    void parseMetadataSection(const std::string& line, ChartData& data);
-    void parseDifficultySection(const std::string& line, ChartData& data);
-    void parseTimingPointsSection(const std::string& line, ChartData& data);
-    void parseEventsSection(const std::string& line, ChartData& data);
-    void parseHitObjectsSection(const std::string& line, ChartData& data);
+    // metadata_only skips timing points and stops at [HitObjects]
+    void parseSections(std::string_view source, ChartData& out_data, bool metadata_only);
+    OsuSection parseSectionName(std::string_view name) const;
+
+    void parseGeneralSection(std::string_view line, ChartData& data);
+    void parseMetadataSection(std::string_view line, ChartData& data);
+    void parseDifficultySection(std::string_view line, ChartData& data);
+    void parseTimingPointsSection(std::string_view line, ChartData& data);
+    void parseEventsSection(std::string_view line, ChartData& data);
+    void parseHitObjectsSection(std::string_view line, ChartData& data);
 
     int calculateColumn(int x, int key_count) const;
-    std::string trim(const std::string& str) const;
+    std::string_view trim(std::string_view str) const;
 };
-}  // namespace mania
\ No newline at end of file
+}  // namespace mania
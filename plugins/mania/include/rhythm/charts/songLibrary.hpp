@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "public/engineContext.hpp"
+#include "rhythm/charts/chartData.hpp"
+
+
+namespace mania {
+const uint32_t SONG_LIBRARY_INDEX_MAGIC = 0x494c5356;  // "VSLI"
+const uint32_t SONG_LIBRARY_INDEX_VERSION = 2;
+
+struct LibraryEntry {
+    std::string path;  // absolute path to the chart file
+
+    // an entry is only reused if both of these still match the file on disk
+    uint64_t file_size = 0;
+    int64_t file_mtime = 0;
+
+    ChartMetadata metadata;
+};
+
+struct LibraryScanStats {
+    size_t total = 0;
+    size_t parsed = 0;
+    size_t reused = 0;
+    size_t failed = 0;  // includes charts that failed before and havent changed since
+    size_t removed = 0;
+    float elapsed_ms = 0.0f;
+};
+
+// walks the song folders and keeps a persistent metadata index of every chart in them
+class SongLibrary {
+public:
+    SongLibrary(vsrg::EngineContext* ctx, const std::string& index_path);
+    ~SongLibrary();
+
+    void addSearchPath(const std::string& path);
+    const std::vector<std::string>& getSearchPaths() const { return search_paths; }
+
+    // blocking, only charts that changed since the last scan are parsed again
+    LibraryScanStats scan();
+
+    const std::vector<LibraryEntry>& getEntries() const { return entries; }
+    const LibraryEntry* findEntry(const std::string& path) const;
+    size_t getEntryCount() const { return entries.size(); }
+
+private:
+    struct PendingChart {
+        std::string path;
+        uint64_t file_size;
+        int64_t file_mtime;
+    };
+
+    // out_failed gets the charts that failed to parse last time, keyed by path like out_index
+    bool loadIndex(std::unordered_map<std::string, LibraryEntry>& out_index,
+                   std::unordered_map<std::string, PendingChart>& out_failed);
+    bool saveIndex();
+
+    void collectCharts(std::vector<PendingChart>& out_charts);
+    void parseCharts(const std::vector<PendingChart>& charts, std::vector<LibraryEntry>& out,
+                     std::vector<uint8_t>& out_success);
+
+    vsrg::EngineContext* engine_context;
+
+    std::string index_path;
+    std::vector<std::string> search_paths;
+    std::vector<LibraryEntry> entries;
+    // stored in the index too, so broken charts are only parsed again once they change
+    std::vector<PendingChart> failed_charts;
+};
+}  // namespace mania
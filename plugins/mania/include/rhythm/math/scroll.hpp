@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
+#include "rhythm/charts/chartData.hpp"
 #include "rhythm/conductor.hpp"
 
 
@@ -23,7 +25,15 @@ public:
     ScrollSpeedMode getMode() const { return mode; }
     float getValue() const { return value; }
 
-    void setConductor(vsrg::Conductor* cond) { conductor = cond; }
+    void setConductor(vsrg::Conductor* cond) {
+        conductor = cond;
+        buildPositionTable();
+    }
+    void setScrollVelocities(const std::vector<ScrollVelocity>& velocities) {
+        scroll_velocities = velocities;
+        buildPositionTable();
+    }
+
     float calculateScrollSpeed(float current_bpm) const;
 
     void convertToCMod(float reference_bpm);
@@ -32,12 +42,42 @@ public:
     float getDisplaySpeed(float current_bpm) const;
     float calculateNoteYPosition(float note_time, float current_time, float strum_line_y) const;
 
+    // position on the scroll curve, bpm changes and scroll velocities are already folded in so
+    // the distance between two times is just the difference in position times the scroll speed.
+    // the curve only depends on the mode, not on the speed value
+    double getPositionAt(float time) const;
+    // getPositionAt for every time, done in runs per section so most of the work is vectorised.
+    // times should be sorted (a column of notes) to get the most out of it, unsorted input still
+    // gives the right result
+    void calculateNotePositions(const float* note_times, float* out_positions,
+                                size_t count) const;
+
+    // for notes whose position was computed ahead of time, current_position is getPositionAt(now)
+    float calculateYFromPosition(float note_position, double current_position,
+                                 float strum_line_y) const {
+        return strum_line_y - (float)(((double)note_position - current_position) * value);
+    }
+
+    // rebuilds the position table from the conductors timing points and the scroll velocities
+    void buildPositionTable();
+
 private:
+    // one entry per point where the scroll rate changes, position is the value of the curve at
+    // the start of the section. the first entry only covers time before the first point
+    struct ScrollSection {
+        float time;
+        double position;
+        double rate;
+    };
+
     ScrollSpeedMode mode;
     float value;
     vsrg::Conductor* conductor;
 
-    float getBPMAtTime(float time) const;
+    std::vector<ScrollVelocity> scroll_velocities;
+    std::vector<ScrollSection> sections;
+
+    size_t findSection(float time) const;
 
     float calculateDistanceThroughSections(float from_time, float to_time) const;
 };
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "rhythm/charts/chartData.hpp"
+#include "rhythm/math/scroll.hpp"
+
+
+namespace mania {
+enum class NoteState : uint8_t {
+    PENDING,  // not reached the strum line yet
+    HOLDING,  // hold note being held down
+    FADING,   // hold note that was missed, drawn faded until it leaves the screen
+    DONE      // hit or missed, never drawn again
+};
+
+// one column of notes, every array is indexed the same way and sorted by time
+struct NoteColumn {
+    std::vector<float> times;
+    std::vector<float> end_times;
+    std::vector<VSRGNoteType> types;
+    std::vector<NoteState> states;
+
+    // scroll curve positions of the head and tail, see ScrollSpeedCalculator::getPositionAt
+    std::vector<float> positions;
+    std::vector<float> end_positions;
+
+    // index of the first note that isnt done yet, only ever moves forward until reset
+    size_t head = 0;
+
+    size_t size() const { return times.size(); }
+};
+
+// per frame render data for a note that is on screen, the playfield rebuilds these every update
+struct NoteRenderState {
+    uint32_t index;
+    uint8_t column;
+    VSRGNoteType type;
+    NoteState state;
+    float y;
+    float end_y;
+};
+
+// column-major struct-of-arrays storage for every note in a chart
+class NoteStore {
+public:
+    NoteStore() = default;
+    ~NoteStore() = default;
+
+    void build(const ChartData* chart_data, int key_count);
+
+    // has to be called again whenever the calculators scroll curve changes (mode, velocities)
+    void computePositions(const ScrollSpeedCalculator& calculator);
+    void reset();
+    void clear();
+
+    int getColumnCount() const { return static_cast<int>(columns.size()); }
+    NoteColumn& getColumn(int column) { return columns[column]; }
+    const NoteColumn& getColumn(int column) const { return columns[column]; }
+
+    size_t getNoteCount() const { return note_count; }
+    size_t getMemoryUsage() const;
+
+private:
+    std::vector<NoteColumn> columns;
+    size_t note_count = 0;
+};
+}  // namespace mania
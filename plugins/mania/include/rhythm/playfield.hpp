@@ -2,16 +2,18 @@
 
 #include <atomic>
 #include <future>
+#include <string>
 #include <vector>
 
 #include "core/ui/solidComponent.hpp"
 #include "core/ui/sprite.hpp"
+#include "core/ui/texture.hpp"
+#include "public/IGamePlugin.hpp"
 #include "public/engineContext.hpp"
 #include "rhythm/charts/chartData.hpp"
 #include "rhythm/conductor.hpp"
-#include "rhythm/holdNote.hpp"
 #include "rhythm/math/scroll.hpp"
-#include "rhythm/note.hpp"
+#include "rhythm/noteStore.hpp"
 #include "rhythm/strum.hpp"
 
 namespace mania {
@@ -29,15 +31,7 @@ public:
 
     glm::vec2 getSize() const override;
 
-    void setScrollSpeed(float speed, ScrollSpeedMode mode) {
-        scroll_speed = speed;
-        switch (mode) {
-            case ScrollSpeedMode::XMOD:
-                scroll_calculator.setXMod(scroll_speed);
-            default:
-                scroll_calculator.setCMod(scroll_speed);
-        }
-    }
+    void setScrollSpeed(float speed, ScrollSpeedMode mode);
 
     float getScrollSpeed() const { return scroll_speed; }
     ScrollSpeedCalculator *getScrollSpeedCalculator() { return &scroll_calculator; }
@@ -52,7 +46,26 @@ public:
 
     bool isLoading() const { return is_loading.load(); }
 
+    const NoteStore& getNoteStore() const { return note_store; }
+
+    // key presses and releases for the strums, events for keys that arent bound are ignored
+    void handleInput(const vsrg::InputEvent &event);
+    int getColumnForScancode(int scancode) const;
+
 private:
+    // layout, textures and sizes shared by every note in a column
+    struct ColumnInfo {
+        float x = 0.0f;
+
+        vsrg::TextureHandle note_texture;
+        vsrg::TextureHandle hold_body_texture;
+        vsrg::TextureHandle hold_end_texture;
+
+        glm::vec2 note_size = glm::vec2(0.0f);
+        float hold_body_height = 0.0f;
+        float hold_end_height = 0.0f;
+    };
+
     vsrg::EngineContext *engine_context;
 
     const ChartData *chart_data;
@@ -60,10 +73,19 @@ private:
 
     int key_count;
     std::vector<Strum *> strums;
-    std::vector<Note *> notes;
+    std::vector<int> key_bindings;  // scancode for each column
+
+    NoteStore note_store;
+    std::vector<NoteRenderState> visible_notes;
+    std::vector<ColumnInfo> columns;
+    vsrg::TextureHandle mine_texture;
+    glm::vec2 mine_size;
+    std::vector<vsrg::TextureRef> texture_refs;  // every skin texture the playfield draws
 
     float scroll_speed;
     float strum_line_y;
+    float strum_width;
+    float note_box_size;
 
     ScrollSpeedCalculator scroll_calculator;
 
@@ -73,5 +95,9 @@ private:
     void createNotes();
     void createNotesAsync();
     void updateStrumPositions();
+
+    void setupColumns(float start_x);
+    void setupKeyBindings();
+    void renderHoldNote(const NoteRenderState &note);
 };
 }  // namespace mania
\ No newline at end of file
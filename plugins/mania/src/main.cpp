@@ -1,11 +1,18 @@
+#include <algorithm>
+#include <filesystem>
+
 #include "core/debug.hpp"
+#include "core/engine/input.hpp"
+#include "core/ui/font.hpp"
 #include "core/ui/sprite.hpp"
 #include "core/ui/spriteComponent.hpp"
+#include "core/ui/textComponent.hpp"
 #include "core/utils.hpp"
 #include "public/IGamePlugin.hpp"
 #include "public/engineContext.hpp"
 #include "rhythm/charts/chart.hpp"
 #include "rhythm/charts/mania.hpp"
+#include "rhythm/charts/songLibrary.hpp"
 #include "rhythm/playfield.hpp"
 
 namespace mania {
@@ -14,15 +21,41 @@ private:
     vsrg::EngineContext *ctx;
 
     ChartManager *chart_manager;
+    SongLibrary *song_library;
     vsrg::Conductor *conductor;
 
     vsrg::SpriteComponent *background;
     std::vector<Playfield *> playfields;
 
+    // song select shows all of these, start rendering their glyphs in the background now so a
+    // japanese title doesnt hitch the first frame it scrolls into view
+    void prewarmLibraryGlyphs() {
+        vsrg::Font *font = ctx->get_font_manager()->getFont("NotoSansJP-Regular.ttf");
+        if (!font) return;
+
+        std::vector<vsrg::Charcode> charcodes;
+        for (const auto &entry : song_library->getEntries()) {
+            const ChartMetadata &metadata = entry.metadata;
+            for (const std::string *text : {&metadata.title, &metadata.subtitle, &metadata.artist,
+                                            &metadata.charter, &metadata.difficulty}) {
+                // decoded straight onto the end, never more charcodes than bytes
+                size_t offset = charcodes.size();
+                charcodes.resize(offset + text->size());
+                charcodes.resize(offset +
+                                 vsrg::TextComponent::decodeUTF8(*text, charcodes.data() + offset));
+            }
+        }
+
+        std::sort(charcodes.begin(), charcodes.end());
+        charcodes.erase(std::unique(charcodes.begin(), charcodes.end()), charcodes.end());
+        font->prewarmGlyphs(charcodes);
+    }
+
 public:
     void init(vsrg::EngineContext *ctx) override {
         this->ctx = ctx;
         this->chart_manager = nullptr;
+        this->song_library = nullptr;
         this->conductor = nullptr;
         this->background = nullptr;
 
@@ -34,10 +67,23 @@ public:
 
         chart_manager = new ChartManager(ctx);
 
-        // hardcoded path for now lmfao
-        std::string song_path = "charts/Noah feat Ai Ohsera - Rebirth the end";
-        std::string chart_path = vsrg::joinPaths(
-            song_path, "Noah feat. Ai Ohsera - Rebirth the end (Begin) [Denouement].osu");
+        std::string exec_dir = vsrg::getExecutableDir();
+        song_library = new SongLibrary(ctx, vsrg::joinPaths(exec_dir, "cache", "library.idx"));
+        song_library->addSearchPath(vsrg::getAssetPath("charts"));
+        song_library->addSearchPath(vsrg::joinPaths(exec_dir, "songs"));
+        song_library->scan();
+        prewarmLibraryGlyphs();
+
+        // still defaults to this one until there is a song select
+        std::string chart_path = vsrg::getAssetPath(vsrg::joinPaths(
+            "charts/Noah feat Ai Ohsera - Rebirth the end",
+            "Noah feat. Ai Ohsera - Rebirth the end (Begin) [Denouement].osu"));
+
+        if (!song_library->findEntry(chart_path) && song_library->getEntryCount() > 0) {
+            chart_path = song_library->getEntries().front().path;
+        }
+        std::string song_path = std::filesystem::path(chart_path).parent_path().string();
+
         if (!chart_manager->loadChart(chart_path)) {
             VSRG_LOG(*ctx->get_debugger(), vsrg::DebugLevel::ERROR,
                      "Failed to load chart from: " + chart_path);
@@ -53,6 +99,9 @@ public:
         // for debug, do playback speed here?
         conductor->set_playback_rate(1.0f);
 
+        // input events get stamped with song time from this conductor
+        ctx->get_input_manager()->set_conductor(conductor);
+
         const ChartData *chart_data = chart_manager->getChartData();
         int key_count = chart_data->metadata.key_count;
 
@@ -71,7 +120,8 @@ public:
 
             std::string backgroundPath =
                 vsrg::joinPaths(song_path, chart_data->metadata.background_file);
-            background = new vsrg::SpriteComponent(ctx, backgroundPath);
+            // backgrounds are big, decode it in the background instead of stalling the load
+            background = new vsrg::SpriteComponent(ctx, backgroundPath, true);
 
             vsrg::ComponentProperties sprite_properties = {
                 true, 0.5f, 0.0f, 0, {0.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 0.0f}};
@@ -93,6 +143,14 @@ public:
         }
     }
 
+    void on_input(const std::vector<vsrg::InputEvent> &events) override {
+        for (const auto &event : events) {
+            for (auto *playfield : playfields) {
+                playfield->handleInput(event);
+            }
+        }
+    }
+
     void render() override {
         ctx->get_sprite_renderer()->begin();
 
@@ -117,6 +175,7 @@ public:
         playfields.clear();
 
         if (conductor) {
+            ctx->get_input_manager()->set_conductor(nullptr);
             delete conductor;
             conductor = nullptr;
         }
@@ -125,6 +184,11 @@ public:
             delete chart_manager;
             chart_manager = nullptr;
         }
+
+        if (song_library) {
+            delete song_library;
+            song_library = nullptr;
+        }
     }
 
     void shutdown() override {
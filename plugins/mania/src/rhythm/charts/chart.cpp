@@ -1,9 +1,11 @@
 #include "rhythm/charts/chart.hpp"
 
+#include <chrono>
 #include <filesystem>
 
 #include "core/debug.hpp"
 #include "core/utils.hpp"
+#include "rhythm/charts/chartCache.hpp"
 
 
 namespace mania {
@@ -18,12 +20,30 @@ bool ChartManager::loadChart(const std::string& path) {
     VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::INFO,
              "Loading chart from " + filePath);
 
+    auto load_start = std::chrono::steady_clock::now();
     auto new_chart = std::make_unique<ChartData>();
-    if (!ChartLoaderFactory::getInstance().loadChart(filePath, *new_chart)) {
-        VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::ERROR, "Failed to load chart");
-        return false;
+
+    bool from_cache = readChartCache(filePath, *new_chart);
+    if (!from_cache) {
+        if (!ChartLoaderFactory::getInstance().loadChart(filePath, *new_chart)) {
+            VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::ERROR,
+                     "Failed to load chart");
+            return false;
+        }
+
+        if (!writeChartCache(filePath, *new_chart)) {
+            VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::WARNING,
+                     "Failed to write compiled chart to " + getChartCachePath(filePath));
+        }
     }
 
+    float load_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() -
+                                                             load_start)
+                        .count();
+    VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::INFO,
+             std::string(from_cache ? "Chart read from compiled cache" : "Chart parsed from source") +
+                 " in " + std::to_string(load_ms) + "ms");
+
     VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::INFO,
              "Chart loaded!! " + new_chart->metadata.title + " - " + new_chart->metadata.artist +
                  " [" + new_chart->metadata.difficulty + "]");
@@ -0,0 +1,287 @@
+#include "rhythm/charts/chartCache.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include "core/mappedFile.hpp"
+#include "core/sourceStamp.hpp"
+
+
+namespace mania {
+namespace {
+// every array in the file starts on an 8 byte boundary so it can be read in place
+size_t alignOffset(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+struct ChartCacheLayout {
+    size_t string_table;
+    size_t string_data;
+    size_t note_times;
+    size_t note_end_times;
+    size_t note_columns;
+    size_t note_types;
+    size_t tp_times;
+    size_t tp_bpms;
+    size_t tp_nominators;
+    size_t tp_denominators;
+    size_t sv_times;
+    size_t sv_multipliers;
+    size_t total_size;
+};
+
+ChartCacheLayout computeLayout(const ChartCacheHeader& header) {
+    ChartCacheLayout layout;
+    size_t offset = alignOffset(sizeof(ChartCacheHeader));
+
+    layout.string_table = offset;
+    offset += sizeof(uint32_t) * 2 * header.string_count;
+    layout.string_data = offset;
+    offset = alignOffset(offset + header.string_data_size);
+
+    layout.note_times = offset;
+    offset = alignOffset(offset + sizeof(float) * header.note_count);
+    layout.note_end_times = offset;
+    offset = alignOffset(offset + sizeof(float) * header.note_count);
+    layout.note_columns = offset;
+    offset = alignOffset(offset + sizeof(uint8_t) * header.note_count);
+    layout.note_types = offset;
+    offset = alignOffset(offset + sizeof(uint8_t) * header.note_count);
+
+    layout.tp_times = offset;
+    offset = alignOffset(offset + sizeof(float) * header.timing_point_count);
+    layout.tp_bpms = offset;
+    offset = alignOffset(offset + sizeof(double) * header.timing_point_count);
+    layout.tp_nominators = offset;
+    offset = alignOffset(offset + sizeof(int32_t) * header.timing_point_count);
+    layout.tp_denominators = offset;
+    offset = alignOffset(offset + sizeof(int32_t) * header.timing_point_count);
+
+    layout.sv_times = offset;
+    offset = alignOffset(offset + sizeof(float) * header.scroll_velocity_count);
+    layout.sv_multipliers = offset;
+    offset = alignOffset(offset + sizeof(float) * header.scroll_velocity_count);
+
+    layout.total_size = offset;
+    return layout;
+}
+
+// order of the strings in the string table
+const uint32_t METADATA_STRING_COUNT = 7;
+
+template <typename Metadata>
+auto& metadataString(Metadata& metadata, uint32_t index) {
+    switch (index) {
+        case 0:
+            return metadata.title;
+        case 1:
+            return metadata.subtitle;
+        case 2:
+            return metadata.artist;
+        case 3:
+            return metadata.charter;
+        case 4:
+            return metadata.difficulty;
+        case 5:
+            return metadata.audio_file;
+        default:
+            return metadata.background_file;
+    }
+}
+}  // namespace
+
+std::string getChartCachePath(const std::string& chart_path) {
+    return chart_path + ".vsc";
+}
+
+bool readChartCache(const std::string& chart_path, ChartData& out_data) {
+    uint64_t source_size;
+    int64_t source_mtime;
+    if (!vsrg::getSourceStamp(chart_path, source_size, source_mtime)) return false;
+
+    vsrg::MappedFile cache(getChartCachePath(chart_path));
+    if (!cache.isOpen() || cache.getSize() < sizeof(ChartCacheHeader)) return false;
+
+    const unsigned char* base = cache.getData();
+
+    ChartCacheHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    if (header.magic != CHART_CACHE_MAGIC || header.version != CHART_CACHE_VERSION) return false;
+    if (header.string_count != METADATA_STRING_COUNT) return false;
+    if (header.source_size != source_size) return false;
+
+    bool touched = header.source_mtime != source_mtime;
+    if (touched) {
+        // touched but maybe not edited, only the content hash can tell
+        vsrg::MappedFile source(chart_path);
+        if (!source.isOpen()) return false;
+        if (vsrg::hashFNV1a(source.getData(), source.getSize()) != header.source_hash) return false;
+    }
+
+    ChartCacheLayout layout = computeLayout(header);
+    if (layout.total_size > cache.getSize()) return false;
+
+    ChartData data;
+    data.metadata.key_count = header.key_count;
+    data.metadata.preview_time = header.preview_time;
+    data.metadata.offset = header.offset;
+
+    const char* string_data = reinterpret_cast<const char*>(base + layout.string_data);
+    for (uint32_t i = 0; i < header.string_count; ++i) {
+        uint32_t entry[2];
+        std::memcpy(entry, base + layout.string_table + sizeof(entry) * i, sizeof(entry));
+
+        if ((uint64_t)entry[0] + entry[1] > header.string_data_size) return false;
+        metadataString(data.metadata, i).assign(string_data + entry[0], entry[1]);
+    }
+
+    // the arrays are aligned inside the mapping so they can be read directly
+    const float* note_times = reinterpret_cast<const float*>(base + layout.note_times);
+    const float* note_end_times = reinterpret_cast<const float*>(base + layout.note_end_times);
+    const uint8_t* note_columns = base + layout.note_columns;
+    const uint8_t* note_types = base + layout.note_types;
+
+    data.notes.reserve(header.note_count);
+    for (uint32_t i = 0; i < header.note_count; ++i) {
+        // a corrupt or stale file must not hand NoteStore a column or type it cant index
+        if (note_columns[i] >= data.metadata.key_count ||
+            note_types[i] > static_cast<uint8_t>(VSRGNoteType::ROLL)) {
+            return false;
+        }
+        data.notes.emplace_back(note_columns[i], note_times[i], note_end_times[i],
+                                static_cast<VSRGNoteType>(note_types[i]));
+    }
+
+    const float* tp_times = reinterpret_cast<const float*>(base + layout.tp_times);
+    const double* tp_bpms = reinterpret_cast<const double*>(base + layout.tp_bpms);
+    const int32_t* tp_nominators = reinterpret_cast<const int32_t*>(base + layout.tp_nominators);
+    const int32_t* tp_denominators =
+        reinterpret_cast<const int32_t*>(base + layout.tp_denominators);
+
+    data.timing_points.reserve(header.timing_point_count);
+    for (uint32_t i = 0; i < header.timing_point_count; ++i) {
+        data.timing_points.push_back(
+            {tp_times[i], tp_bpms[i], tp_nominators[i], tp_denominators[i]});
+    }
+
+    const float* sv_times = reinterpret_cast<const float*>(base + layout.sv_times);
+    const float* sv_multipliers = reinterpret_cast<const float*>(base + layout.sv_multipliers);
+
+    data.scroll_velocities.reserve(header.scroll_velocity_count);
+    for (uint32_t i = 0; i < header.scroll_velocity_count; ++i) {
+        data.scroll_velocities.push_back({sv_times[i], sv_multipliers[i]});
+    }
+
+    // windows wont let us write to a file that is still mapped
+    cache.close();
+    if (touched) {
+        vsrg::refreshSourceStamp(getChartCachePath(chart_path),
+                                 offsetof(ChartCacheHeader, source_mtime), source_mtime);
+    }
+
+    out_data = std::move(data);
+    return true;
+}
+
+bool writeChartCache(const std::string& chart_path, const ChartData& data) {
+    ChartCacheHeader header = {};
+    header.magic = CHART_CACHE_MAGIC;
+    header.version = CHART_CACHE_VERSION;
+
+    if (!vsrg::getSourceStamp(chart_path, header.source_size, header.source_mtime)) return false;
+
+    {
+        vsrg::MappedFile source(chart_path);
+        if (!source.isOpen()) return false;
+        header.source_hash = vsrg::hashFNV1a(source.getData(), source.getSize());
+    }
+
+    header.key_count = data.metadata.key_count;
+    header.preview_time = data.metadata.preview_time;
+    header.offset = data.metadata.offset;
+    header.note_count = static_cast<uint32_t>(data.notes.size());
+    header.timing_point_count = static_cast<uint32_t>(data.timing_points.size());
+    header.scroll_velocity_count = static_cast<uint32_t>(data.scroll_velocities.size());
+    header.string_count = METADATA_STRING_COUNT;
+
+    const ChartMetadata& metadata = data.metadata;
+    for (uint32_t i = 0; i < METADATA_STRING_COUNT; ++i) {
+        header.string_data_size += static_cast<uint32_t>(metadataString(metadata, i).size());
+    }
+
+    ChartCacheLayout layout = computeLayout(header);
+    std::vector<unsigned char> buffer(layout.total_size, 0);
+    unsigned char* base = buffer.data();
+
+    std::memcpy(base, &header, sizeof(header));
+
+    uint32_t string_offset = 0;
+    for (uint32_t i = 0; i < METADATA_STRING_COUNT; ++i) {
+        const std::string& str = metadataString(metadata, i);
+        uint32_t entry[2] = {string_offset, static_cast<uint32_t>(str.size())};
+
+        std::memcpy(base + layout.string_table + sizeof(entry) * i, entry, sizeof(entry));
+        std::memcpy(base + layout.string_data + string_offset, str.data(), str.size());
+        string_offset += entry[1];
+    }
+
+    float* note_times = reinterpret_cast<float*>(base + layout.note_times);
+    float* note_end_times = reinterpret_cast<float*>(base + layout.note_end_times);
+    uint8_t* note_columns = base + layout.note_columns;
+    uint8_t* note_types = base + layout.note_types;
+
+    for (size_t i = 0; i < data.notes.size(); ++i) {
+        const VSRGNote& note = data.notes[i];
+        note_times[i] = note.time;
+        note_end_times[i] = note.end_time;
+        note_columns[i] = static_cast<uint8_t>(note.column);
+        note_types[i] = static_cast<uint8_t>(note.type);
+    }
+
+    float* tp_times = reinterpret_cast<float*>(base + layout.tp_times);
+    double* tp_bpms = reinterpret_cast<double*>(base + layout.tp_bpms);
+    int32_t* tp_nominators = reinterpret_cast<int32_t*>(base + layout.tp_nominators);
+    int32_t* tp_denominators = reinterpret_cast<int32_t*>(base + layout.tp_denominators);
+
+    for (size_t i = 0; i < data.timing_points.size(); ++i) {
+        const vsrg::TimingPoint& tp = data.timing_points[i];
+        tp_times[i] = tp.time;
+        tp_bpms[i] = tp.bpm;
+        tp_nominators[i] = tp.nominator;
+        tp_denominators[i] = tp.denominator;
+    }
+
+    float* sv_times = reinterpret_cast<float*>(base + layout.sv_times);
+    float* sv_multipliers = reinterpret_cast<float*>(base + layout.sv_multipliers);
+
+    for (size_t i = 0; i < data.scroll_velocities.size(); ++i) {
+        sv_times[i] = data.scroll_velocities[i].time;
+        sv_multipliers[i] = data.scroll_velocities[i].multiplier;
+    }
+
+    // write to a temp file first so a crash never leaves a half written cache behind
+    std::string cache_path = getChartCachePath(chart_path);
+    std::string temp_path = cache_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        if (!file.good()) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, cache_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+}  // namespace mania
@@ -1,80 +1,186 @@
 #include "rhythm/charts/mania.hpp"
 
 #include <algorithm>
-#include <fstream>
-#include <sstream>
+#include <array>
+#include <charconv>
+
+#include "core/mappedFile.hpp"
 
 
 namespace mania {
+namespace {
+const size_t MAX_FIELDS = 8;
+using Fields = std::array<std::string_view, MAX_FIELDS>;
+
+// splits a comma separated line into views, returns the total field count
+// (fields past MAX_FIELDS are counted but not stored)
+size_t splitFields(std::string_view line, Fields& fields) {
+    size_t count = 0;
+    size_t start = 0;
+
+    while (true) {
+        size_t comma = line.find(',', start);
+        std::string_view field =
+            line.substr(start, comma == std::string_view::npos ? std::string_view::npos
+                                                               : comma - start);
+        if (count < MAX_FIELDS) fields[count] = field;
+        count++;
+
+        if (comma == std::string_view::npos) break;
+        start = comma + 1;
+    }
+
+    // a trailing comma doesnt start another field, same as getline splitting did before
+    if (count > 1 && start == line.size()) count--;
+
+    return count;
+}
+
+bool splitKeyValue(std::string_view line, std::string_view& key, std::string_view& value) {
+    size_t colon_pos = line.find(':');
+    if (colon_pos == std::string_view::npos) return false;
+
+    key = line.substr(0, colon_pos);
+    value = line.substr(colon_pos + 1);
+    return true;
+}
+
+// from_chars wont skip whitespace or a leading '+', so strip those first
+template <typename T>
+bool parseNumber(std::string_view str, T& out) {
+    size_t first = str.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos) return false;
+    str.remove_prefix(first);
+    if (str.front() == '+') str.remove_prefix(1);
+
+    auto result = std::from_chars(str.data(), str.data() + str.size(), out);
+    return result.ec == std::errc();
+}
+}  // namespace
+
 bool ManiaLoader::loadChart(const std::string& filepath, ChartData& out_data) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    vsrg::MappedFile file(filepath);
+    if (!file.isOpen()) {
+        return false;
+    }
+
+    return parseChart(file.getView(), out_data);
+}
+
+bool ManiaLoader::loadMetadata(const std::string& filepath, ChartMetadata& out_metadata) {
+    vsrg::MappedFile file(filepath);
+    if (!file.isOpen()) {
         return false;
     }
 
+    return parseMetadata(file.getView(), out_metadata);
+}
+
+bool ManiaLoader::parseChart(std::string_view source, ChartData& out_data) {
     out_data.notes.clear();
     out_data.timing_points.clear();
+    out_data.scroll_velocities.clear();
+
+    parseSections(source, out_data, false);
+
+    out_data.sortNotes();
+    out_data.sortTimingPoints();
+    out_data.sortScrollVelocities();
 
-    std::string line;
-    std::string current_section = "";
+    return true;
+}
+
+bool ManiaLoader::parseMetadata(std::string_view source, ChartMetadata& out_metadata) {
+    ChartData data;
+    parseSections(source, data, true);
+
+    out_metadata = std::move(data.metadata);
+    return true;
+}
+
+void ManiaLoader::parseSections(std::string_view source, ChartData& out_data,
+                                bool metadata_only) {
+    OsuSection current_section = OsuSection::NONE;
+    size_t line_start = 0;
 
-    while (std::getline(file, line)) {
-        line = trim(line);
+    while (line_start < source.size()) {
+        size_t line_end = source.find('\n', line_start);
+        if (line_end == std::string_view::npos) line_end = source.size();
 
-        if (line.empty() || line[0] == '/' || line.find("//") == 0) {
+        std::string_view line = trim(source.substr(line_start, line_end - line_start));
+        line_start = line_end + 1;
+
+        if (line.empty() || line[0] == '/') {
             continue;
         }
 
-        if (line[0] == '[' && line[line.length() - 1] == ']') {
-            current_section = line.substr(1, line.length() - 2);
+        if (line[0] == '[' && line.back() == ']') {
+            current_section = parseSectionName(line.substr(1, line.length() - 2));
+
+            // hit objects are always the last section, nothing after them is metadata
+            if (metadata_only && current_section == OsuSection::HIT_OBJECTS) break;
             continue;
         }
 
-        if (current_section == "General") {
-            parseGeneralSection(line, out_data);
-        } else if (current_section == "Metadata") {
-            parseMetadataSection(line, out_data);
-        } else if (current_section == "Difficulty") {
-            parseDifficultySection(line, out_data);
-        } else if (current_section == "TimingPoints") {
-            parseTimingPointsSection(line, out_data);
-        } else if (current_section == "Events") {
-            parseEventsSection(line, out_data);
-        } else if (current_section == "HitObjects") {
-            parseHitObjectsSection(line, out_data);
+        switch (current_section) {
+            case OsuSection::GENERAL:
+                parseGeneralSection(line, out_data);
+                break;
+            case OsuSection::METADATA:
+                parseMetadataSection(line, out_data);
+                break;
+            case OsuSection::DIFFICULTY:
+                parseDifficultySection(line, out_data);
+                break;
+            case OsuSection::TIMING_POINTS:
+                if (!metadata_only) parseTimingPointsSection(line, out_data);
+                break;
+            case OsuSection::EVENTS:
+                parseEventsSection(line, out_data);
+                break;
+            case OsuSection::HIT_OBJECTS:
+                parseHitObjectsSection(line, out_data);
+                break;
+            default:
+                break;
         }
     }
+}
 
-    file.close();
-
-    out_data.sortNotes();
-    out_data.sortTimingPoints();
-
-    return true;
+OsuSection ManiaLoader::parseSectionName(std::string_view name) const {
+    if (name == "General") return OsuSection::GENERAL;
+    if (name == "Metadata") return OsuSection::METADATA;
+    if (name == "Difficulty") return OsuSection::DIFFICULTY;
+    if (name == "TimingPoints") return OsuSection::TIMING_POINTS;
+    if (name == "Events") return OsuSection::EVENTS;
+    if (name == "HitObjects") return OsuSection::HIT_OBJECTS;
+    return OsuSection::UNKNOWN;
 }
 
-void ManiaLoader::parseGeneralSection(const std::string& line, ChartData& data) {
-    size_t colon_pos = line.find(':');
-    if (colon_pos == std::string::npos) return;
+void ManiaLoader::parseGeneralSection(std::string_view line, ChartData& data) {
+    std::string_view key, value;
+    if (!splitKeyValue(line, key, value)) return;
 
-    std::string key = trim(line.substr(0, colon_pos));
-    std::string value = trim(line.substr(colon_pos + 1));
+    key = trim(key);
+    value = trim(value);
 
     if (key == "AudioFilename") {
         data.metadata.audio_file = value;
     } else if (key == "PreviewTime") {
-        data.metadata.preview_time = std::stof(value) / 1000.0f;
+        float preview_time;
+        if (parseNumber(value, preview_time)) data.metadata.preview_time = preview_time / 1000.0f;
     } else if (key == "AudioLeadIn") {
-        data.metadata.offset = std::stof(value) / 1000.0f;
+        float lead_in;
+        if (parseNumber(value, lead_in)) data.metadata.offset = lead_in / 1000.0f;
     }
 }
 
-void ManiaLoader::parseMetadataSection(const std::string& line, ChartData& data) {
-    size_t colon_pos = line.find(':');
-    if (colon_pos == std::string::npos) return;
+void ManiaLoader::parseMetadataSection(std::string_view line, ChartData& data) {
+    std::string_view key, value;
+    if (!splitKeyValue(line, key, value)) return;
 
-    std::string key = trim(line.substr(0, colon_pos));
-    std::string value = trim(line.substr(colon_pos + 1));
+    key = trim(key);
+    value = trim(value);
 
     if (key == "Title") {
         data.metadata.title = value;
@@ -87,46 +193,50 @@ void ManiaLoader::parseMetadataSection(const std::string& line, ChartData& data)
     }
 }
 
-void ManiaLoader::parseEventsSection(const std::string& line, ChartData& data) {
-    if (line.compare(0, 2, "0,") != 0) return;
+void ManiaLoader::parseEventsSection(std::string_view line, ChartData& data) {
+    if (!line.starts_with("0,")) return;
     if (data.metadata.background_file != "") return;
 
     size_t firstQuote = line.find('"');
     size_t lastQuote = line.find('"', firstQuote + 1);
 
-    if (firstQuote != std::string::npos && lastQuote != std::string::npos) {
-        std::string filename = line.substr(firstQuote + 1, lastQuote - firstQuote - 1);
-        data.metadata.background_file = filename;
+    if (firstQuote != std::string_view::npos && lastQuote != std::string_view::npos) {
+        data.metadata.background_file = line.substr(firstQuote + 1, lastQuote - firstQuote - 1);
     }
 }
 
-void ManiaLoader::parseDifficultySection(const std::string& line, ChartData& data) {
-    size_t colon_pos = line.find(':');
-    if (colon_pos == std::string::npos) return;
+void ManiaLoader::parseDifficultySection(std::string_view line, ChartData& data) {
+    std::string_view key, value;
+    if (!splitKeyValue(line, key, value)) return;
 
-    std::string key = trim(line.substr(0, colon_pos));
-    std::string value = trim(line.substr(colon_pos + 1));
+    key = trim(key);
+    value = trim(value);
 
     if (key == "CircleSize") {
-        data.metadata.key_count = std::stoi(value);
+        int key_count;
+        if (parseNumber(value, key_count)) data.metadata.key_count = key_count;
     }
 }
 
-void ManiaLoader::parseTimingPointsSection(const std::string& line, ChartData& data) {
-    std::stringstream ss(line);
-    std::string token;
-    std::vector<std::string> tokens;
+void ManiaLoader::parseTimingPointsSection(std::string_view line, ChartData& data) {
+    Fields fields;
+    size_t field_count = splitFields(line, fields);
 
-    while (std::getline(ss, token, ',')) {
-        tokens.push_back(trim(token));
-    }
+    if (field_count < 2) return;
 
-    if (tokens.size() < 2) return;
+    float time, beat_length;
+    if (!parseNumber(fields[0], time) || !parseNumber(fields[1], beat_length)) return;
+    time /= 1000.0f;
 
-    float time = std::stof(tokens[0]) / 1000.0f;
-    float beat_length = std::stof(tokens[1]);
-    int meter = tokens.size() > 2 ? std::stoi(tokens[2]) : 4;
-    bool uninherited = tokens.size() > 6 ? (std::stoi(tokens[6]) == 1) : true;
+    int meter = 4;
+    if (field_count > 2 && !parseNumber(fields[2], meter)) return;
+
+    bool uninherited = true;
+    if (field_count > 6) {
+        int uninherited_flag;
+        if (!parseNumber(fields[6], uninherited_flag)) return;
+        uninherited = uninherited_flag == 1;
+    }
 
     if (uninherited && beat_length > 0) {
         vsrg::TimingPoint tp;
@@ -136,32 +246,43 @@ void ManiaLoader::parseTimingPointsSection(const std::string& line, ChartData& d
         tp.denominator = 4;
 
         data.timing_points.push_back(tp);
-    }
-}
 
-void ManiaLoader::parseHitObjectsSection(const std::string& line, ChartData& data) {
-    std::stringstream ss(line);
-    std::string token;
-    std::vector<std::string> tokens;
+        // a new red line resets the slider velocity back to 1x
+        if (!data.scroll_velocities.empty()) data.scroll_velocities.push_back({time, 1.0f});
+    } else if (!uninherited && beat_length < 0) {
+        // inherited points store the velocity as a negative inverse percentage,
+        // osu clamps it to 0.1x - 10x so we do too
+        float multiplier = -100.0f / beat_length;
+        multiplier = std::clamp(multiplier, 0.1f, 10.0f);
 
-    while (std::getline(ss, token, ',')) {
-        tokens.push_back(trim(token));
+        data.scroll_velocities.push_back({time, multiplier});
     }
+}
+
+void ManiaLoader::parseHitObjectsSection(std::string_view line, ChartData& data) {
+    Fields fields;
+    size_t field_count = splitFields(line, fields);
 
-    if (tokens.size() < 4) return;
+    if (field_count < 4) return;
 
-    int x = std::stoi(tokens[0]);
-    float time = std::stof(tokens[2]) / 1000.0f;
-    int type = std::stoi(tokens[3]);
+    int x, type;
+    float time;
+    if (!parseNumber(fields[0], x) || !parseNumber(fields[2], time) ||
+        !parseNumber(fields[3], type)) {
+        return;
+    }
+    time /= 1000.0f;
 
     int column = calculateColumn(x, data.metadata.key_count);
 
     if (type & 128) {
-        if (tokens.size() > 5) {
-            size_t colon_pos = tokens[5].find(':');
-            if (colon_pos != std::string::npos) {
-                float end_time = std::stof(tokens[5].substr(0, colon_pos)) / 1000.0f;
-                data.notes.emplace_back(column, time, end_time, VSRGNoteType::HOLD);
+        if (field_count > 5) {
+            std::string_view hold_field = trim(fields[5]);
+            size_t colon_pos = hold_field.find(':');
+            if (colon_pos != std::string_view::npos) {
+                float end_time;
+                if (!parseNumber(hold_field.substr(0, colon_pos), end_time)) return;
+                data.notes.emplace_back(column, time, end_time / 1000.0f, VSRGNoteType::HOLD);
             }
         }
     } else {
@@ -179,11 +300,11 @@ int ManiaLoader::calculateColumn(int x, int key_count) const {
     return column;
 }
 
-std::string ManiaLoader::trim(const std::string& str) const {
+std::string_view ManiaLoader::trim(std::string_view str) const {
     size_t first = str.find_first_not_of(" \t\r\n");
-    if (first == std::string::npos) return "";
+    if (first == std::string_view::npos) return {};
 
     size_t last = str.find_last_not_of(" \t\r\n");
     return str.substr(first, last - first + 1);
 }
-}  // namespace mania
\ No newline at end of file
+}  // namespace mania
@@ -0,0 +1,369 @@
+#include "rhythm/charts/songLibrary.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <thread>
+
+#include "core/debug.hpp"
+#include "core/mappedFile.hpp"
+#include "rhythm/charts/chart.hpp"
+
+
+namespace mania {
+namespace {
+// smallest possible records, used to bound the counts read from a corrupt index
+const size_t MIN_INDEX_ENTRY_SIZE = 4 + 8 + 8 + 7 * 4 + 3 * 4;
+const size_t MIN_INDEX_FAILED_SIZE = 4 + 8 + 8;
+
+void writeU32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeU64(std::string& out, uint64_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeString(std::string& out, const std::string& value) {
+    writeU32(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+// bounds checked cursor over the mapped index, any overrun marks the whole read as failed
+struct IndexReader {
+    const unsigned char* data;
+    size_t size;
+    size_t offset = 0;
+    bool ok = true;
+
+    template <typename T>
+    T read() {
+        T value{};
+        if (!ok || offset + sizeof(T) > size) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    std::string readString() {
+        uint32_t length = read<uint32_t>();
+        if (!ok || offset + length > size) {
+            ok = false;
+            return {};
+        }
+        std::string value(reinterpret_cast<const char*>(data + offset), length);
+        offset += length;
+        return value;
+    }
+};
+}  // namespace
+
+SongLibrary::SongLibrary(vsrg::EngineContext* ctx, const std::string& index_path)
+    : engine_context(ctx), index_path(index_path) {}
+
+SongLibrary::~SongLibrary() {}
+
+void SongLibrary::addSearchPath(const std::string& path) {
+    if (std::find(search_paths.begin(), search_paths.end(), path) != search_paths.end()) return;
+    search_paths.push_back(path);
+}
+
+const LibraryEntry* SongLibrary::findEntry(const std::string& path) const {
+    auto it = std::lower_bound(
+        entries.begin(), entries.end(), path,
+        [](const LibraryEntry& entry, const std::string& value) { return entry.path < value; });
+
+    if (it != entries.end() && it->path == path) return &*it;
+    return nullptr;
+}
+
+LibraryScanStats SongLibrary::scan() {
+    auto scan_start = std::chrono::steady_clock::now();
+    LibraryScanStats stats;
+
+    std::unordered_map<std::string, LibraryEntry> index;
+    std::unordered_map<std::string, PendingChart> failed_index;
+    loadIndex(index, failed_index);
+
+    std::vector<PendingChart> charts;
+    collectCharts(charts);
+
+    std::vector<LibraryEntry> new_entries;
+    new_entries.reserve(charts.size());
+
+    std::vector<PendingChart> new_failed;
+
+    std::vector<PendingChart> changed;
+    for (auto& chart : charts) {
+        auto it = index.find(chart.path);
+        if (it != index.end() && it->second.file_size == chart.file_size &&
+            it->second.file_mtime == chart.file_mtime) {
+            new_entries.push_back(std::move(it->second));
+            index.erase(it);
+            stats.reused++;
+            continue;
+        }
+        if (it != index.end()) index.erase(it);
+
+        auto failed_it = failed_index.find(chart.path);
+        if (failed_it != failed_index.end()) {
+            bool unchanged = failed_it->second.file_size == chart.file_size &&
+                             failed_it->second.file_mtime == chart.file_mtime;
+            failed_index.erase(failed_it);
+
+            if (unchanged) {
+                new_failed.push_back(std::move(chart));
+                stats.failed++;
+                continue;
+            }
+        }
+
+        changed.push_back(std::move(chart));
+    }
+
+    // whatever is left in the old index no longer exists on disk
+    stats.removed = index.size() + failed_index.size();
+
+    std::vector<LibraryEntry> parsed(changed.size());
+    std::vector<uint8_t> success(changed.size(), 0);
+    parseCharts(changed, parsed, success);
+
+    size_t parse_failures = 0;
+    for (size_t i = 0; i < parsed.size(); ++i) {
+        if (success[i]) {
+            new_entries.push_back(std::move(parsed[i]));
+            stats.parsed++;
+        } else {
+            VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::WARNING,
+                     "Failed to read chart metadata: " + changed[i].path);
+            new_failed.push_back(std::move(changed[i]));
+            parse_failures++;
+        }
+    }
+    stats.failed += parse_failures;
+
+    std::sort(new_entries.begin(), new_entries.end(),
+              [](const LibraryEntry& a, const LibraryEntry& b) { return a.path < b.path; });
+    entries = std::move(new_entries);
+    failed_charts = std::move(new_failed);
+    stats.total = entries.size();
+
+    if (stats.parsed > 0 || stats.removed > 0 || parse_failures > 0) {
+        if (!saveIndex()) {
+            VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::WARNING,
+                     "Failed to save song library index to " + index_path);
+        }
+    }
+
+    stats.elapsed_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() -
+                                                                scan_start)
+                           .count();
+
+    float seconds = stats.elapsed_ms / 1000.0f;
+    float charts_per_second = seconds > 0.0f ? (float)stats.total / seconds : 0.0f;
+
+    VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::INFO,
+             "Song library scanned " + std::to_string(stats.total) + " charts in " +
+                 std::to_string(stats.elapsed_ms) + "ms (" + std::to_string(stats.parsed) +
+                 " parsed, " + std::to_string(stats.reused) + " from index, " +
+                 std::to_string(stats.removed) + " removed, " + std::to_string(stats.failed) +
+                 " failed, " + std::to_string((int)charts_per_second) + " charts/s)");
+
+    return stats;
+}
+
+void SongLibrary::collectCharts(std::vector<PendingChart>& out_charts) {
+    namespace fs = std::filesystem;
+    ChartLoaderFactory& factory = ChartLoaderFactory::getInstance();
+
+    for (const auto& search_path : search_paths) {
+        std::error_code ec;
+        if (!fs::is_directory(search_path, ec)) continue;
+
+        fs::recursive_directory_iterator it(
+            search_path, fs::directory_options::skip_permission_denied, ec);
+        fs::recursive_directory_iterator end;
+
+        for (; !ec && it != end; it.increment(ec)) {
+            const fs::directory_entry& entry = *it;
+            if (!entry.is_regular_file(ec)) continue;
+
+            std::string path = entry.path().string();
+            if (!factory.canLoad(path)) continue;
+
+            std::error_code stat_ec;
+            uint64_t size = static_cast<uint64_t>(entry.file_size(stat_ec));
+            if (stat_ec) continue;
+            int64_t mtime =
+                static_cast<int64_t>(entry.last_write_time(stat_ec).time_since_epoch().count());
+            if (stat_ec) continue;
+
+            out_charts.push_back({std::move(path), size, mtime});
+        }
+
+        if (ec) {
+            VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::WARNING,
+                     "Stopped scanning " + search_path + ": " + ec.message());
+        }
+    }
+}
+
+void SongLibrary::parseCharts(const std::vector<PendingChart>& charts,
+                              std::vector<LibraryEntry>& out, std::vector<uint8_t>& out_success) {
+    if (charts.empty()) return;
+
+    std::atomic<size_t> next_chart{0};
+    auto worker = [&]() {
+        ChartLoaderFactory& factory = ChartLoaderFactory::getInstance();
+
+        while (true) {
+            size_t i = next_chart.fetch_add(1, std::memory_order_relaxed);
+            if (i >= charts.size()) break;
+
+            LibraryEntry& entry = out[i];
+            entry.path = charts[i].path;
+            entry.file_size = charts[i].file_size;
+            entry.file_mtime = charts[i].file_mtime;
+
+            out_success[i] = factory.loadMetadata(entry.path, entry.metadata) ? 1 : 0;
+        }
+    };
+
+    size_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+    thread_count = std::min(thread_count, charts.size());
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count - 1);
+    for (size_t i = 1; i < thread_count; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    worker();  // the calling thread helps out too
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+bool SongLibrary::loadIndex(std::unordered_map<std::string, LibraryEntry>& out_index,
+                            std::unordered_map<std::string, PendingChart>& out_failed) {
+    vsrg::MappedFile file(index_path);
+    if (!file.isOpen()) return false;
+
+    IndexReader reader{file.getData(), file.getSize()};
+
+    if (reader.read<uint32_t>() != SONG_LIBRARY_INDEX_MAGIC) return false;
+    if (reader.read<uint32_t>() != SONG_LIBRARY_INDEX_VERSION) return false;
+
+    uint64_t entry_count = reader.read<uint64_t>();
+    if (!reader.ok) return false;
+
+    // the count comes straight from the file, never reserve more than the rest of it could hold
+    out_index.reserve(std::min<uint64_t>(entry_count,
+                                         (reader.size - reader.offset) / MIN_INDEX_ENTRY_SIZE));
+    for (uint64_t i = 0; i < entry_count && reader.ok; ++i) {
+        LibraryEntry entry;
+        entry.path = reader.readString();
+        entry.file_size = reader.read<uint64_t>();
+        entry.file_mtime = reader.read<int64_t>();
+
+        ChartMetadata& metadata = entry.metadata;
+        metadata.title = reader.readString();
+        metadata.subtitle = reader.readString();
+        metadata.artist = reader.readString();
+        metadata.charter = reader.readString();
+        metadata.difficulty = reader.readString();
+        metadata.audio_file = reader.readString();
+        metadata.background_file = reader.readString();
+        metadata.key_count = reader.read<int32_t>();
+        metadata.preview_time = reader.read<float>();
+        metadata.offset = reader.read<float>();
+
+        if (reader.ok) out_index.emplace(entry.path, std::move(entry));
+    }
+
+    uint64_t failed_count = reader.read<uint64_t>();
+    out_failed.reserve(std::min<uint64_t>(failed_count,
+                                          (reader.size - reader.offset) / MIN_INDEX_FAILED_SIZE));
+    for (uint64_t i = 0; i < failed_count && reader.ok; ++i) {
+        PendingChart chart;
+        chart.path = reader.readString();
+        chart.file_size = reader.read<uint64_t>();
+        chart.file_mtime = reader.read<int64_t>();
+
+        if (reader.ok) out_failed.emplace(chart.path, std::move(chart));
+    }
+
+    if (!reader.ok) {
+        // a truncated index is useless, start from scratch
+        out_index.clear();
+        out_failed.clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool SongLibrary::saveIndex() {
+    std::string buffer;
+    buffer.reserve(entries.size() * 256);
+
+    writeU32(buffer, SONG_LIBRARY_INDEX_MAGIC);
+    writeU32(buffer, SONG_LIBRARY_INDEX_VERSION);
+    writeU64(buffer, entries.size());
+
+    for (const auto& entry : entries) {
+        const ChartMetadata& metadata = entry.metadata;
+
+        writeString(buffer, entry.path);
+        writeU64(buffer, entry.file_size);
+        writeU64(buffer, static_cast<uint64_t>(entry.file_mtime));
+
+        writeString(buffer, metadata.title);
+        writeString(buffer, metadata.subtitle);
+        writeString(buffer, metadata.artist);
+        writeString(buffer, metadata.charter);
+        writeString(buffer, metadata.difficulty);
+        writeString(buffer, metadata.audio_file);
+        writeString(buffer, metadata.background_file);
+        buffer.append(reinterpret_cast<const char*>(&metadata.key_count), sizeof(int32_t));
+        buffer.append(reinterpret_cast<const char*>(&metadata.preview_time), sizeof(float));
+        buffer.append(reinterpret_cast<const char*>(&metadata.offset), sizeof(float));
+    }
+
+    writeU64(buffer, failed_charts.size());
+    for (const auto& chart : failed_charts) {
+        writeString(buffer, chart.path);
+        writeU64(buffer, chart.file_size);
+        writeU64(buffer, static_cast<uint64_t>(chart.file_mtime));
+    }
+
+    std::error_code ec;
+    std::filesystem::path index_dir = std::filesystem::path(index_path).parent_path();
+    if (!index_dir.empty()) std::filesystem::create_directories(index_dir, ec);
+
+    std::string temp_path = index_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file.write(buffer.data(), buffer.size());
+        if (!file.good()) return false;
+    }
+
+    std::filesystem::rename(temp_path, index_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+}  // namespace mania
@@ -1,17 +1,30 @@
 #include "rhythm/math/scroll.hpp"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VSRG_SCROLL_SSE2
+#endif
+
 namespace mania {
 ScrollSpeedCalculator::ScrollSpeedCalculator(vsrg::Conductor* conductor)
-    : mode(ScrollSpeedMode::XMOD), value(1.0f), conductor(conductor) {}
+    : mode(ScrollSpeedMode::XMOD), value(1.0f), conductor(conductor) {
+    buildPositionTable();
+}
 
 void ScrollSpeedCalculator::setXMod(float multiplier) {
+    bool mode_changed = mode != ScrollSpeedMode::XMOD;
     mode = ScrollSpeedMode::XMOD;
     value = multiplier;
+
+    if (mode_changed) buildPositionTable();
 }
 
 void ScrollSpeedCalculator::setCMod(float constant_speed) {
+    bool mode_changed = mode != ScrollSpeedMode::CMOD;
     mode = ScrollSpeedMode::CMOD;
     value = constant_speed;
+
+    if (mode_changed) buildPositionTable();
 }
 
 float ScrollSpeedCalculator::calculateScrollSpeed(float current_bpm) const {
@@ -45,12 +58,76 @@ float ScrollSpeedCalculator::getDisplaySpeed(float current_bpm) const {
     return calculateScrollSpeed(current_bpm);
 }
 
-float ScrollSpeedCalculator::getBPMAtTime(float time) const {
-    if (!conductor) {
-        return 120.0f;  // fallback
+void ScrollSpeedCalculator::buildPositionTable() {
+    sections.clear();
+
+    const vsrg::TimingMap no_timing;
+    const std::vector<vsrg::TimingPoint>& timing_points =
+        conductor ? conductor->get_timing_points() : no_timing.get_points();
+
+    // cmod ignores bpm, xmod scrolls 64 pixels per beat at 1.0
+    auto sectionRate = [this](double bpm, double velocity) {
+        double pixels_per_unit = (64.0 / 60.0) * velocity;
+        return mode == ScrollSpeedMode::XMOD ? bpm * pixels_per_unit : pixels_per_unit;
+    };
+
+    double lead_in_bpm = timing_points.empty() ? 120.0 : timing_points[0].bpm;  // fallback bpm
+    double bpm = lead_in_bpm;
+    double velocity = 1.0;
+
+    if (timing_points.empty() && scroll_velocities.empty()) {
+        sections.push_back({0.0f, 0.0, sectionRate(bpm, velocity)});
+        return;
+    }
+
+    sections.reserve(timing_points.size() + scroll_velocities.size() + 1);
+
+    // walk both lists in time order, points at the same time collapse into one section
+    size_t tp_index = 0, sv_index = 0;
+    while (tp_index < timing_points.size() || sv_index < scroll_velocities.size()) {
+        bool take_tp = sv_index >= scroll_velocities.size() ||
+                       (tp_index < timing_points.size() &&
+                        timing_points[tp_index].time <= scroll_velocities[sv_index].time);
+
+        float time;
+        if (take_tp) {
+            time = timing_points[tp_index].time;
+            bpm = timing_points[tp_index++].bpm;
+        } else {
+            time = scroll_velocities[sv_index].time;
+            velocity = scroll_velocities[sv_index++].multiplier;
+        }
+
+        if (sections.empty()) {
+            // lead in, the first bpm at 1x covers everything before the first point
+            sections.push_back({time, 0.0, sectionRate(lead_in_bpm, 1.0)});
+            sections.push_back({time, 0.0, sectionRate(bpm, velocity)});
+            continue;
+        }
+
+        ScrollSection& previous = sections.back();
+        if (time <= previous.time) {
+            previous.rate = sectionRate(bpm, velocity);
+            continue;
+        }
+
+        double position = previous.position + (double)(time - previous.time) * previous.rate;
+        sections.push_back({time, position, sectionRate(bpm, velocity)});
     }
+}
+
+size_t ScrollSpeedCalculator::findSection(float time) const {
+    // last section starting at or before time, before the first point this lands on the lead in
+    auto it =
+        std::upper_bound(sections.begin(), sections.end(), time,
+                         [](float t, const ScrollSection& section) { return t < section.time; });
+    if (it == sections.begin()) return 0;
+    return static_cast<size_t>(it - sections.begin()) - 1;
+}
 
-    return conductor->get_bpm_at_time(time);
+double ScrollSpeedCalculator::getPositionAt(float time) const {
+    const ScrollSection& section = sections[findSection(time)];
+    return section.position + (double)(time - section.time) * section.rate;
 }
 
 float ScrollSpeedCalculator::calculateDistanceThroughSections(float from_time,
@@ -72,83 +149,57 @@ float ScrollSpeedCalculator::calculateDistanceThroughSections(float from_time,
     // however, it doesnt match for some reason....
     // theres probably something done in the playfield, but i cannot be bothered to look for it rn
 
-    if (!conductor) {
-        float time_diff = to_time - from_time;
-
-        if (mode == ScrollSpeedMode::CMOD) {
-            float pixels_per_second = (value / 60.0f) * 64.0f;
-            return time_diff * pixels_per_second;
-        } else {
-            float bpm = 120.0f;
-            float pixels_per_second = bpm * value * (64.0f / 60.0f);
-            return time_diff * pixels_per_second;
-        }
-    }
-
-    const auto& all_points = conductor->get_timing_points();
+    // the table already has every section summed up, so this is just two lookups
+    return (float)((getPositionAt(to_time) - getPositionAt(from_time)) * value);
+}
 
-    float total_distance = 0.0f;
-    float section_start = from_time;
+float ScrollSpeedCalculator::calculateNoteYPosition(float note_time, float current_time,
+                                                    float strum_line_y) const {
+    return strum_line_y - calculateDistanceThroughSections(current_time, note_time);
+}
 
-    for (const auto& point : all_points) {
-        if (point.time > from_time && point.time <= to_time) {
-            float section_end = point.time;
-            float time_diff = section_end - section_start;
-            float section_bpm = getBPMAtTime(section_start);
+void ScrollSpeedCalculator::calculateNotePositions(const float* note_times, float* out_positions,
+                                                   size_t count) const {
+    size_t i = 0;
 
-            float pixels_per_second;
-            if (mode == ScrollSpeedMode::CMOD) {
-                pixels_per_second = (value / 60.0f) * 64.0f;
-            } else {
-                pixels_per_second = section_bpm * value * (64.0f / 60.0f);
-            }
+    while (i < count) {
+        // inside a single section the curve is linear: out = base + (time - origin) * slope
+        size_t index = findSection(note_times[i]);
+        const ScrollSection& section = sections[index];
 
-            total_distance += time_diff * pixels_per_second;
-            section_start = section_end;
-        }
-    }
+        float run_start = index > 0 ? section.time : -INFINITY;
+        float run_end = index + 1 < sections.size() ? sections[index + 1].time : INFINITY;
 
-    if (section_start < to_time) {
-        float time_diff = to_time - section_start;
-        float section_bpm = getBPMAtTime(section_start);
+        float origin = section.time;
+        float base = (float)section.position;
+        float slope = (float)section.rate;
 
-        float pixels_per_second;
-        if (mode == ScrollSpeedMode::CMOD) {
-            pixels_per_second = (value / 60.0f) * 64.0f;
-        } else {
-            pixels_per_second = section_bpm * value * (64.0f / 60.0f);
+        size_t run_length = 1;
+        while (i + run_length < count && note_times[i + run_length] >= run_start &&
+               note_times[i + run_length] < run_end) {
+            run_length++;
         }
 
-        total_distance += time_diff * pixels_per_second;
-    }
-
-    return total_distance;
-}
+        const float* times = note_times + i;
+        float* values = out_positions + i;
+        size_t j = 0;
 
-float ScrollSpeedCalculator::calculateNoteYPosition(float note_time, float current_time,
-                                                    float strum_line_y) const {
-    float time_diff = note_time - current_time;
+#ifdef VSRG_SCROLL_SSE2
+        __m128 origin4 = _mm_set1_ps(origin);
+        __m128 base4 = _mm_set1_ps(base);
+        __m128 slope4 = _mm_set1_ps(slope);
 
-    if (mode == ScrollSpeedMode::CMOD) {
-        float pixels_per_second = (value / 60.0f) * 64.0f;
-        float distance = time_diff * pixels_per_second;
-        return strum_line_y - distance;
-    }
+        for (; j + 4 <= run_length; j += 4) {
+            __m128 t = _mm_sub_ps(_mm_loadu_ps(times + j), origin4);
+            _mm_storeu_ps(values + j, _mm_add_ps(base4, _mm_mul_ps(t, slope4)));
+        }
+#endif
 
-    if (!conductor) {
-        float bpm = 120.0f;
-        float pixels_per_second = bpm * value * (64.0f / 60.0f);
-        float distance = time_diff * pixels_per_second;
-        return strum_line_y - distance;
-    }
+        for (; j < run_length; ++j) {
+            values[j] = base + (times[j] - origin) * slope;
+        }
 
-    float distance;
-    if (note_time >= current_time) {
-        distance = calculateDistanceThroughSections(current_time, note_time);
-    } else {
-        distance = -calculateDistanceThroughSections(note_time, current_time);
+        i += run_length;
     }
-
-    return strum_line_y - distance;
 }
-}  // namespace mania
\ No newline at end of file
+}  // namespace mania
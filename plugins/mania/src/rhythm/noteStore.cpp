@@ -0,0 +1,77 @@
+#include "rhythm/noteStore.hpp"
+
+#include <algorithm>
+
+namespace mania {
+void NoteStore::build(const ChartData* chart_data, int key_count) {
+    clear();
+    if (!chart_data || key_count <= 0) return;
+
+    columns.resize(key_count);
+
+    // count first so every array is allocated exactly once
+    std::vector<size_t> column_sizes(key_count, 0);
+    for (const auto& note : chart_data->notes) {
+        if (note.column >= 0 && note.column < key_count) column_sizes[note.column]++;
+    }
+
+    for (int i = 0; i < key_count; ++i) {
+        NoteColumn& column = columns[i];
+        column.times.reserve(column_sizes[i]);
+        column.end_times.reserve(column_sizes[i]);
+        column.types.reserve(column_sizes[i]);
+        column.states.reserve(column_sizes[i]);
+    }
+
+    // chart notes are already sorted by time, so each column ends up sorted as well
+    for (const auto& note : chart_data->notes) {
+        if (note.column < 0 || note.column >= key_count) continue;
+
+        NoteColumn& column = columns[note.column];
+        column.times.push_back(note.time);
+        column.end_times.push_back(note.end_time);
+        column.types.push_back(note.type);
+        column.states.push_back(NoteState::PENDING);
+        note_count++;
+    }
+}
+
+void NoteStore::computePositions(const ScrollSpeedCalculator& calculator) {
+    for (auto& column : columns) {
+        column.positions.resize(column.size());
+        column.end_positions.resize(column.size());
+
+        // times are sorted for the column. end times mostly are, but a hold can end after a
+        // later tap, which only splits the runs and never changes the result
+        calculator.calculateNotePositions(column.times.data(), column.positions.data(),
+                                          column.size());
+        calculator.calculateNotePositions(column.end_times.data(), column.end_positions.data(),
+                                          column.size());
+    }
+}
+
+void NoteStore::reset() {
+    for (auto& column : columns) {
+        std::fill(column.states.begin(), column.states.end(), NoteState::PENDING);
+        column.head = 0;
+    }
+}
+
+void NoteStore::clear() {
+    columns.clear();
+    note_count = 0;
+}
+
+size_t NoteStore::getMemoryUsage() const {
+    size_t bytes = sizeof(NoteStore) + columns.capacity() * sizeof(NoteColumn);
+    for (const auto& column : columns) {
+        bytes += column.times.capacity() * sizeof(float);
+        bytes += column.end_times.capacity() * sizeof(float);
+        bytes += column.types.capacity() * sizeof(VSRGNoteType);
+        bytes += column.states.capacity() * sizeof(NoteState);
+        bytes += column.positions.capacity() * sizeof(float);
+        bytes += column.end_positions.capacity() * sizeof(float);
+    }
+    return bytes;
+}
+}  // namespace mania
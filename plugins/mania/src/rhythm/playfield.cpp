@@ -1,9 +1,29 @@
 #include "rhythm/playfield.hpp"
 
+#include <algorithm>
+#include <cmath>
+
+#include <SDL3/SDL.h>
+
 #include "core/debug.hpp"
 
 
 namespace mania {
+namespace {
+// same as RenderMode::Fit on a sprite component
+glm::vec2 fitToBox(const glm::vec2 &texture_size, const glm::vec2 &box) {
+    if (texture_size.x <= 0.0f || texture_size.y <= 0.0f) return box;
+
+    float texture_aspect = texture_size.x / texture_size.y;
+    float box_aspect = box.x / box.y;
+
+    if (texture_aspect > box_aspect) {
+        return glm::vec2(box.x, box.x / texture_aspect);
+    }
+    return glm::vec2(box.y * texture_aspect, box.y);
+}
+}  // namespace
+
 Playfield::Playfield(vsrg::EngineContext *ctx, const ChartData *chart_data,
                      vsrg::Conductor *conductor, int key_count, glm::vec4 background_color)
     : vsrg::SolidComponent(ctx, background_color),
@@ -12,6 +32,8 @@ Playfield::Playfield(vsrg::EngineContext *ctx, const ChartData *chart_data,
       conductor(conductor),
       key_count(key_count),
       scroll_speed(1600.0f),
+      strum_width(96.0f),
+      note_box_size(96.0f),
       is_loading(false),
       scroll_calculator(conductor) {
     VSRG_LOG(*ctx->get_debugger(), vsrg::DebugLevel::INFO,
@@ -21,7 +43,6 @@ Playfield::Playfield(vsrg::EngineContext *ctx, const ChartData *chart_data,
     float screen_width = static_cast<float>(ctx->get_screen_width());
     float screen_height = static_cast<float>(ctx->get_screen_height());
 
-    float strum_width = 96.0f;
     float strum_spacing = 0.0f;
     float total_width = (strum_width * key_count) + (strum_spacing * (key_count - 1));
 
@@ -38,21 +59,29 @@ Playfield::Playfield(vsrg::EngineContext *ctx, const ChartData *chart_data,
 
     VSRG_LOG(*ctx->get_debugger(), vsrg::DebugLevel::INFO, "pre-loading textures...");
 
-    ctx->get_texture_cache()->getTexture("strum.png");
-    ctx->get_texture_cache()->getTexture("note.png");
-    ctx->get_texture_cache()->getTexture("mine.png");
-    ctx->get_texture_cache()->getTexture("holdBody.png");
-    ctx->get_texture_cache()->getTexture("holdEnd.png");
+    // decoded in parallel on the texture workers, the getTexture calls further down wait for
+    // whichever ones they need. the refs keep the skin cached while the playfield is up
+    vsrg::TextureCache *texture_cache = ctx->get_texture_cache();
+    auto preload = [&](const std::string &path) {
+        texture_cache->loadTextureAsync(path);
+        texture_refs.emplace_back(texture_cache, path);
+    };
+
+    preload("strum.png");
+    preload("note.png");
+    preload("mine.png");
+    preload("holdBody.png");
+    preload("holdEnd.png");
 
     for (int i = 0; i < key_count; ++i) {
         std::string suffix = std::to_string(i) + ".png";
-        ctx->get_texture_cache()->getTexture("strum" + suffix);
-        ctx->get_texture_cache()->getTexture("note" + suffix);
-        ctx->get_texture_cache()->getTexture("holdBody" + suffix);
-        ctx->get_texture_cache()->getTexture("holdEnd" + suffix);
+        preload("strum" + suffix);
+        preload("note" + suffix);
+        preload("holdBody" + suffix);
+        preload("holdEnd" + suffix);
     }
 
-    VSRG_LOG(*ctx->get_debugger(), vsrg::DebugLevel::INFO, "textures pre-loaded!");
+    VSRG_LOG(*ctx->get_debugger(), vsrg::DebugLevel::INFO, "texture loads queued");
 
     for (int i = 0; i < key_count; i++) {
         float x = start_x + (i * (strum_width + strum_spacing));
@@ -64,13 +93,20 @@ Playfield::Playfield(vsrg::EngineContext *ctx, const ChartData *chart_data,
         strums.push_back(strum);
     }
 
+    // texture sizes have to be read here, the note loading task runs off the gl thread
+    setupColumns(start_x);
+    setupKeyBindings();
+
+    // the scroll curve has to be final before the loading task computes note positions from it
+    if (chart_data) scroll_calculator.setScrollVelocities(chart_data->scroll_velocities);
+    setScrollSpeed(scroll_speed / conductor->get_playback_rate(), ScrollSpeedMode::CMOD);
+
     if (chart_data) {
         VSRG_LOG(*ctx->get_debugger(), vsrg::DebugLevel::INFO, "starting async note loading...");
         is_loading.store(true);
         loading_task = std::async(std::launch::async, [this]() { this->createNotesAsync(); });
     }
 
-    setScrollSpeed(scroll_speed / conductor->get_playback_rate(), ScrollSpeedMode::CMOD);
     properties.visible = true;
 }
 
@@ -84,76 +120,127 @@ Playfield::~Playfield() {
     }
     strums.clear();
 
-    for (auto *note : notes) {
-        delete note;
-    }
-    notes.clear();
+    note_store.clear();
 }
 
-void Playfield::createNotesAsync() {
-    if (!chart_data) {
-        is_loading.store(false);
-        return;
+void Playfield::setScrollSpeed(float speed, ScrollSpeedMode mode) {
+    scroll_speed = speed;
+
+    ScrollSpeedMode previous_mode = scroll_calculator.getMode();
+    if (mode != previous_mode && loading_task.valid()) {
+        // the loading task reads the scroll curve, let it finish before it changes
+        loading_task.wait();
     }
 
-    VSRG_LOG(
-        *engine_context->get_debugger(), vsrg::DebugLevel::INFO,
-        "creating notes from chart data, note count: " + std::to_string(chart_data->notes.size()));
+    switch (mode) {
+        case ScrollSpeedMode::XMOD:
+            scroll_calculator.setXMod(scroll_speed);
+            break;
+        default:
+            scroll_calculator.setCMod(scroll_speed);
+            break;
+    }
 
-    float screen_width = static_cast<float>(engine_context->get_screen_width());
-    float strum_width = 96.0f;
+    // xmod and cmod use different curves, the speed value alone doesnt move any positions
+    if (mode != previous_mode) {
+        note_store.computePositions(scroll_calculator);
+    }
+}
+
+void Playfield::setupColumns(float start_x) {
     float strum_spacing = 0.0f;
-    float total_width = (strum_width * key_count) + (strum_spacing * (key_count - 1));
-    float start_x = (screen_width - total_width) / 2.0f;
+    glm::vec2 note_box(note_box_size, note_box_size);
+    vsrg::TextureCache *texture_cache = engine_context->get_texture_cache();
 
-    int created_count = 0;
-    int failed_count = 0;
+    mine_texture = texture_cache->getHandle("mine.png");
+    auto *cached_mine = texture_cache->getTexture(mine_texture);
+    mine_size = (cached_mine && cached_mine->loaded)
+                    ? fitToBox(glm::vec2(cached_mine->dimensions), note_box)
+                    : note_box;
 
-    std::vector<Note *> temp_notes;
+    columns.clear();
+    columns.resize(key_count);
+
+    for (int i = 0; i < key_count; i++) {
+        ColumnInfo &column = columns[i];
+        column.x = start_x + (i * (strum_width + strum_spacing));
+
+        column.note_texture = texture_cache->getHandle("note" + std::to_string(i) + ".png");
+        column.hold_body_texture =
+            texture_cache->getHandle("holdBody" + std::to_string(i) + ".png");
+        column.hold_end_texture = texture_cache->getHandle("holdEnd" + std::to_string(i) + ".png");
+
+        auto *note_texture = texture_cache->getTexture(column.note_texture);
+        column.note_size = (note_texture && note_texture->loaded)
+                               ? fitToBox(glm::vec2(note_texture->dimensions), note_box)
+                               : note_box;
+
+        auto *body_texture = texture_cache->getTexture(column.hold_body_texture);
+        if (body_texture && body_texture->loaded) {
+            column.hold_body_height = static_cast<float>(body_texture->dimensions.y);
+        }
+
+        auto *end_texture = texture_cache->getTexture(column.hold_end_texture);
+        if (end_texture && end_texture->loaded) {
+            column.hold_end_height = static_cast<float>(end_texture->dimensions.y);
+        }
+    }
+}
 
-    for (const auto &vsrg_note : chart_data->notes) {
-        if (vsrg_note.column >= key_count) continue;
+void Playfield::setupKeyBindings() {
+    // osu defaults, left hand on asdf, right hand on jkl; and space for the middle column
+    const int left_hand[] = {SDL_SCANCODE_A, SDL_SCANCODE_S, SDL_SCANCODE_D, SDL_SCANCODE_F};
+    const int right_hand[] = {SDL_SCANCODE_J, SDL_SCANCODE_K, SDL_SCANCODE_L,
+                              SDL_SCANCODE_SEMICOLON};
 
-        float x = start_x + (vsrg_note.column * (strum_width + strum_spacing));
+    key_bindings.assign(key_count, SDL_SCANCODE_UNKNOWN);
 
-        Note *note = nullptr;
-        try {
-            if (vsrg_note.type == VSRGNoteType::HOLD) {
-                note =
-                    new HoldNote(engine_context, "note" + std::to_string(vsrg_note.column) + ".png",
-                                 vsrg_note.column, vsrg_note.time, vsrg_note.end_time);
-            } else if (vsrg_note.type == VSRGNoteType::TAP) {
-                note = new Note(engine_context, "note" + std::to_string(vsrg_note.column) + ".png",
-                                vsrg_note.column, vsrg_note.time, NoteType::NORMAL);
-            } else if (vsrg_note.type == VSRGNoteType::MINE) {
-                note = new Note(engine_context, "mine.png", vsrg_note.column, vsrg_note.time,
-                                NoteType::MINE);
-            } else {
-                note = new Note(engine_context, "note" + std::to_string(vsrg_note.column) + ".png",
-                                vsrg_note.column, vsrg_note.time, NoteType::NORMAL);
-            }
+    int half = std::min(key_count / 2, 4);
+    for (int i = 0; i < half; i++) {
+        key_bindings[i] = left_hand[4 - half + i];
+        key_bindings[key_count - half + i] = right_hand[i];
+    }
 
-            if (note) {
-                note->setPosition(x, -100.0f);
-                note->setSize(strum_width, strum_width);
-                note->setCanRender(false);
+    if (key_count % 2 == 1) {
+        key_bindings[key_count / 2] = SDL_SCANCODE_SPACE;
+    }
+}
 
-                temp_notes.push_back(note);
-                created_count++;
-            }
-        } catch (const std::exception &e) {
-            VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::ERROR,
-                     std::string("failed to create note: ") + e.what());
-            failed_count++;
-            if (note) delete note;
-        }
+int Playfield::getColumnForScancode(int scancode) const {
+    for (int i = 0; i < static_cast<int>(key_bindings.size()); i++) {
+        if (key_bindings[i] == scancode && scancode != SDL_SCANCODE_UNKNOWN) return i;
+    }
+    return -1;
+}
+
+void Playfield::handleInput(const vsrg::InputEvent &event) {
+    if (event.repeat) return;
+
+    int column = getColumnForScancode(event.scancode);
+    if (column < 0 || column >= static_cast<int>(strums.size())) return;
+
+    // event.song_time is when the key was actually hit, judgement will compare against that
+    strums[column]->setPressed(event.type == vsrg::InputEventType::KEY_DOWN);
+}
+
+void Playfield::createNotesAsync() {
+    if (!chart_data) {
+        is_loading.store(false);
+        return;
     }
 
-    notes = std::move(temp_notes);
+    VSRG_LOG(
+        *engine_context->get_debugger(), vsrg::DebugLevel::INFO,
+        "creating notes from chart data, note count: " + std::to_string(chart_data->notes.size()));
+
+    note_store.build(chart_data, key_count);
+    note_store.computePositions(scroll_calculator);
+    visible_notes.reserve(256);
 
     VSRG_LOG(*engine_context->get_debugger(), vsrg::DebugLevel::INFO,
-             "created " + std::to_string(created_count) + " notes successfully, " +
-                 std::to_string(failed_count) + " failed");
+             "created " + std::to_string(note_store.getNoteCount()) + " notes successfully, " +
+                 std::to_string(chart_data->notes.size() - note_store.getNoteCount()) +
+                 " skipped (" + std::to_string(note_store.getMemoryUsage() / 1024) + " KB)");
 
     is_loading.store(false);
 }
@@ -166,7 +253,6 @@ void Playfield::createNotes() {
 
 void Playfield::updateStrumPositions() {
     float screen_width = static_cast<float>(engine_context->get_screen_width());
-    float strum_width = 96.0f;
     float strum_spacing = 0.0f;
     float total_width = (strum_width * key_count) + (strum_spacing * (key_count - 1));
     float start_x = (screen_width - total_width) / 2.0f;
@@ -189,91 +275,131 @@ void Playfield::update(float delta_time) {
     }
 
     float song_position = conductor->get_song_position();
+    double current_position = scroll_calculator.getPositionAt(song_position);
     float screen_height = static_cast<float>(engine_context->get_screen_height());
 
-    for (auto *note : notes) {
-        if (!note) continue;
+    visible_notes.clear();
+
+    for (int c = 0; c < note_store.getColumnCount(); ++c) {
+        NoteColumn &column = note_store.getColumn(c);
+        float head_height = columns[c].note_size.y;
 
-        if (note->shouldDespawn()) {
-            note->setCanRender(false);
-            continue;
+        // everything before the head is done, skip it without touching the arrays again
+        while (column.head < column.size() && column.states[column.head] == NoteState::DONE) {
+            column.head++;
         }
 
-        float note_time = note->getTime();
-        float y_pos =
-            scroll_calculator.calculateNoteYPosition(note_time, song_position, strum_line_y);
+        for (size_t i = column.head; i < column.size(); ++i) {
+            NoteState &state = column.states[i];
+            if (state == NoteState::DONE) continue;
 
-        note->setPosition(note->getPosition().x, y_pos);
+            VSRGNoteType type = column.types[i];
+            float note_time = column.times[i];
+            float y_pos = scroll_calculator.calculateYFromPosition(column.positions[i],
+                                                                   current_position, strum_line_y);
 
-        // this is for debug, presses notes when theyre on the strum
-        if (song_position >= note_time && !note->isPressed()) {
-            note->setPressed(true);
+            // columns are sorted by time, so once a note is above the screen every later one is
+            // too and the rest of the column can wait for a later frame
+            if (state == NoteState::PENDING && y_pos < 0 - head_height) break;
 
-            if (note->getType() == NoteType::HOLD) {
-                HoldNote *hold_note = dynamic_cast<HoldNote *>(note);
-                if (hold_note) {
-                    hold_note->setHolding(true);
+            // this is for debug, presses notes when theyre on the strum
+            if (state == NoteState::PENDING && song_position >= note_time) {
+                if (type != VSRGNoteType::HOLD) {
+                    state = NoteState::DONE;
+                    continue;
                 }
+                state = NoteState::HOLDING;
             }
-        }
 
-        if (note->getType() == NoteType::HOLD) {
-            HoldNote *hold_note = dynamic_cast<HoldNote *>(note);
-            if (hold_note) {
-                float end_note_time = hold_note->getEndTime();
-
-                if (hold_note->isHolding() && song_position >= end_note_time) {
-                    hold_note->setHolding(false);
-                    hold_note->despawnNote();
-                } else if (!hold_note->isFadingOut() && !hold_note->isHolding() &&
-                           !note->isPressed()) {
-                    if (y_pos > strum_line_y) {
-                        hold_note->startFadeOut();
-                    }
+            if (type == VSRGNoteType::HOLD) {
+                float end_note_time = column.end_times[i];
+
+                if (state == NoteState::HOLDING && song_position >= end_note_time) {
+                    state = NoteState::DONE;
+                    continue;
+                } else if (state == NoteState::PENDING && y_pos > strum_line_y) {
+                    state = NoteState::FADING;
                 }
-            }
-        } else {
-            if (y_pos > strum_line_y + note->getSize().y && !note->shouldDespawn()) {
-                note->despawnNote();
-            }
-        }
 
-        if (note->getType() == NoteType::HOLD) {
-            HoldNote *hold_note = dynamic_cast<HoldNote *>(note);
-            if (hold_note) {
-                float end_note_time = hold_note->getEndTime();
-                float end_y_pos = scroll_calculator.calculateNoteYPosition(
-                    end_note_time, song_position, strum_line_y);
+                float end_y_pos = scroll_calculator.calculateYFromPosition(
+                    column.end_positions[i], current_position, strum_line_y);
+
+                if (state == NoteState::FADING && end_y_pos + note_box_size > screen_height) {
+                    state = NoteState::DONE;
+                    continue;
+                }
 
-                hold_note->setEndY(end_y_pos);
-                if (hold_note->isHolding()) {
-                    note->setPosition(note->getPosition().x, strum_line_y);
+                if (state == NoteState::HOLDING) {
                     y_pos = strum_line_y;
                 }
 
-                float note_head_y = y_pos;
-                float hold_end_y = hold_note->getEndY();
-                float note_height = note->getSize().y;
+                float top_y = std::min(y_pos, end_y_pos);
+                float bottom_y = std::max(y_pos + head_height, end_y_pos + head_height);
 
-                float top_y = std::min(note_head_y, hold_end_y);
-                float bottom_y = std::max(note_head_y + note_height, hold_end_y + note_height);
+                if (bottom_y < 0 || top_y > screen_height) continue;
 
-                if (bottom_y < 0 || top_y > screen_height) {
-                    note->setCanRender(false);
-                } else {
-                    note->setCanRender(true);
-                }
-            }
-        } else {
-            float note_height = note->getSize().y;
-            if (y_pos < 0 - note_height || y_pos > screen_height) {
-                note->setCanRender(false);
+                visible_notes.push_back({static_cast<uint32_t>(i), static_cast<uint8_t>(c), type,
+                                         state, y_pos, end_y_pos});
             } else {
-                note->setCanRender(true);
+                if (y_pos > strum_line_y + head_height) {
+                    state = NoteState::DONE;
+                    continue;
+                }
+
+                if (y_pos < 0 - head_height || y_pos > screen_height) continue;
+
+                visible_notes.push_back({static_cast<uint32_t>(i), static_cast<uint8_t>(c), type,
+                                         state, y_pos, y_pos});
             }
         }
+    }
+}
+
+void Playfield::renderHoldNote(const NoteRenderState &note) {
+    auto *renderer = engine_context->get_sprite_renderer();
+    const ColumnInfo &column = columns[note.column];
+
+    float note_x = column.x;
+    float note_y = note.y;
+    float end_y = note.end_y;
+    float end_time = note_store.getColumn(note.column).end_times[note.index];
+
+    float body_start_y = note_y + (note_box_size / 2.0f);
+
+    float total_body_height = std::abs(end_y - body_start_y);
+    float actual_end_height = std::min(column.hold_end_height, total_body_height);
+
+    float body_texture_height = total_body_height - actual_end_height;
+    float alpha = note.state == NoteState::FADING ? 0.5f : 1.0f;
+
+    // hold pieces sit one layer below the note heads
+    int hold_layer = 1;
+
+    if (total_body_height > 1.0f && end_time > 0.0f) {
+        if (column.hold_end_height > 0.0f && actual_end_height > 0.0f) {
+            float v_height_end = std::min(actual_end_height / column.hold_end_height, 1.0f);
+
+            renderer->drawSprite(column.hold_end_texture, glm::vec2(note_x, end_y),
+                                 glm::vec2(note_box_size, actual_end_height),
+                                 glm::vec4(0.0f, 0.0f, 1.0f, v_height_end), 0.0f, glm::vec2(0.0f),
+                                 glm::vec2(1.0f), alpha, hold_layer);
+        }
 
-        note->update(delta_time);
+        if (column.hold_body_height > 0.0f && body_texture_height > 0.0f) {
+            float v_height = std::min(body_texture_height / column.hold_body_height, 1.0f);
+
+            renderer->drawSprite(column.hold_body_texture,
+                                 glm::vec2(note_x, end_y + actual_end_height),
+                                 glm::vec2(note_box_size, body_texture_height),
+                                 glm::vec4(0.0f, 0.0f, 1.0f, v_height), 0.0f, glm::vec2(0.0f),
+                                 glm::vec2(1.0f), alpha, hold_layer);
+        }
+    }
+
+    // the head disappears once the hold is hit or missed
+    if (note.state == NoteState::PENDING) {
+        renderer->drawSprite(column.note_texture, glm::vec2(note_x, note_y), column.note_size,
+                             0.0f, glm::vec2(0.0f), glm::vec2(1.0f), 1.0f, 2);
     }
 }
 
@@ -283,19 +409,32 @@ void Playfield::render() {
     }
 
     SolidComponent::render();
-    engine_context->get_sprite_renderer()->begin();
+
+    auto *renderer = engine_context->get_sprite_renderer();
+    renderer->begin();
 
     for (auto *strum : strums) {
         if (strum) strum->render();
     }
 
     if (!is_loading.load()) {
-        for (auto *note : notes) {
-            if (note) note->render();
+        for (const auto &note : visible_notes) {
+            if (note.type == VSRGNoteType::HOLD) {
+                renderHoldNote(note);
+                continue;
+            }
+
+            const ColumnInfo &column = columns[note.column];
+            bool is_mine = note.type == VSRGNoteType::MINE;
+
+            renderer->drawSprite(is_mine ? mine_texture : column.note_texture,
+                                 glm::vec2(column.x, note.y),
+                                 is_mine ? mine_size : column.note_size, 0.0f, glm::vec2(0.0f),
+                                 glm::vec2(1.0f), 1.0f, 2);
         }
     }
 
-    engine_context->get_sprite_renderer()->end();
+    renderer->end();
 }
 
 glm::vec2 Playfield::getSize() const {
@@ -313,4 +452,4 @@ glm::vec2 Playfield::getSize() const {
 
     return glm::vec2(total_width, max_height);
 }
-}  // namespace mania
\ No newline at end of file
+}  // namespace mania
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+#include "rhythm/charts/chartData.hpp"
+
+
+namespace mania {
+// the getline/stringstream loader ManiaLoader replaced, kept unchanged as the reference the
+// parser tests compare against. it throws on numbers stof/stoi cant read
+class LegacyManiaLoader {
+public:
+    bool loadChart(const std::string& filepath, ChartData& out_data);
+
+private:
+    void parseGeneralSection(const std::string& line, ChartData& data);
+    void parseMetadataSection(const std::string& line, ChartData& data);
+    void parseDifficultySection(const std::string& line, ChartData& data);
+    void parseTimingPointsSection(const std::string& line, ChartData& data);
+    void parseEventsSection(const std::string& line, ChartData& data);
+    void parseHitObjectsSection(const std::string& line, ChartData& data);
+
+    int calculateColumn(int x, int key_count) const;
+    std::string trim(const std::string& str) const;
+};
+}  // namespace mania
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/utils.hpp"
+#include "legacyLoader.hpp"
+#include "rhythm/charts/mania.hpp"
+
+using namespace mania;
+
+// fuzz-style corpus test: every bundled chart, a set of hand written edge cases and seeded
+// mutations of the charts go through both the string_view parser and the old getline loader,
+// and the results have to match exactly. inputs the old loader threw on are skipped, the new
+// parser drops those lines instead
+
+namespace {
+const int MUTATIONS_PER_CHART = 100;
+const int MAX_EDITS = 20;
+
+// mostly characters that mean something to the parser, so mutations hit the number and field
+// handling instead of producing lines nobody looks at
+const std::string MUTATION_ALPHABET = " ,:\n\r-.0123456789[]/e+";
+
+const char* EDGE_CASES[] = {
+    // trailing commas dont start another field
+    "[TimingPoints]\n100,500,4,1,0,100,\n",
+    "[TimingPoints]\n100,500,4,1,0,100,1,\n",
+    "[HitObjects]\n64,192,1000,1,0,\n",
+    "[HitObjects]\n64,192,1000,128,0,2000:0:0:0:\n",
+    "[HitObjects]\n64,192,1000,128,0,2000\n",
+    "[HitObjects]\n64,192,1000,128,0\n",
+    // short and inherited timing points
+    "[TimingPoints]\n100,500\n",
+    "[TimingPoints]\n100,-50,4,1,0,100,0,0\n[HitObjects]\n0,0,0,1\n",
+    "[TimingPoints]\n100,0,4,1,0,100,1,0\n",
+    // columns clamp to the key count
+    "[Difficulty]\nCircleSize:7\n[HitObjects]\n511,192,1000,1,0\n0,1,2,1\n-64,1,2,1\n9999,1,2,1\n",
+    // whitespace, crlf and comments
+    "[General]\r\nAudioFilename:  song.mp3 \r\nPreviewTime: 1234\r\n\r\n// comment\r\n",
+    "[Metadata]\nTitle:a:b\nArtist :\tsomeone\nCreator:\nVersion:hard\n",
+    "  [HitObjects]  \n 64 , 192 , 1000 , 1 , 0 \n\t448,192,1500,128,0,1750:0\n",
+    // numbers stof and from_chars both read a prefix of
+    "[HitObjects]\n64.9,192,1000.5,1.7,0\n64,192,1e3,1,0\n64,192,+500,1,0\n",
+    "[General]\nAudioLeadIn:12abc\n[Difficulty]\nCircleSize:4.5\n",
+    // backgrounds, only the first one counts
+    "[Events]\n0,0,\"bg.png\",0,0\n0,0,\"other.png\",0,0\n",
+    "[Events]\n0,0,bg.png,0,0\n1,0,\"video.mp4\"\n",
+    // unknown sections and lines outside any section
+    "64,192,1000,1,0\n[Colours]\nCombo1:255,0,0\n[HitObjects]\n64,192,1000,1,0\n",
+    "[HitObjects]\n[]\n64,192,1000,1,0\n",
+    "",
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+bool sameChart(const ChartData& a, const ChartData& b) {
+    const ChartMetadata& m = a.metadata;
+    const ChartMetadata& n = b.metadata;
+    if (m.title != n.title || m.artist != n.artist || m.charter != n.charter ||
+        m.difficulty != n.difficulty || m.audio_file != n.audio_file ||
+        m.background_file != n.background_file || m.key_count != n.key_count ||
+        m.preview_time != n.preview_time || m.offset != n.offset) {
+        return false;
+    }
+
+    if (a.notes.size() != b.notes.size()) return false;
+    for (size_t i = 0; i < a.notes.size(); i++) {
+        const VSRGNote& x = a.notes[i];
+        const VSRGNote& y = b.notes[i];
+        if (x.column != y.column || x.time != y.time || x.end_time != y.end_time ||
+            x.type != y.type) {
+            return false;
+        }
+    }
+
+    if (a.timing_points.size() != b.timing_points.size()) return false;
+    for (size_t i = 0; i < a.timing_points.size(); i++) {
+        const vsrg::TimingPoint& x = a.timing_points[i];
+        const vsrg::TimingPoint& y = b.timing_points[i];
+        if (x.time != y.time || x.bpm != y.bpm || x.nominator != y.nominator ||
+            x.denominator != y.denominator) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string mutate(std::string source, std::mt19937& rng) {
+    if (source.empty()) return source;
+
+    int edits = 1 + rng() % MAX_EDITS;
+    for (int i = 0; i < edits && !source.empty(); i++) {
+        size_t position = rng() % source.size();
+        char c = MUTATION_ALPHABET[rng() % MUTATION_ALPHABET.size()];
+
+        switch (rng() % 4) {
+            case 0:
+                source[position] = c;
+                break;
+            case 1:
+                source.erase(position, 1 + rng() % 5);
+                break;
+            case 2:
+                source.insert(position, 1, c);
+                break;
+            default:
+                source.insert(position, " ");
+                break;
+        }
+    }
+
+    return source;
+}
+
+struct Results {
+    int matched = 0;
+    int skipped = 0;
+    int mismatched = 0;
+};
+
+// the old loader only reads files, so every input goes through a scratch file
+void compare(const std::string& source, const std::string& scratch_path, const std::string& name,
+             Results& results) {
+    {
+        std::ofstream scratch(scratch_path, std::ios::binary | std::ios::trunc);
+        scratch << source;
+    }
+
+    ChartData expected;
+    try {
+        LegacyManiaLoader legacy;
+        legacy.loadChart(scratch_path, expected);
+    } catch (const std::exception&) {
+        results.skipped++;
+        return;
+    }
+
+    ChartData actual;
+    ManiaLoader loader;
+    loader.parseChart(source, actual);
+
+    if (sameChart(expected, actual)) {
+        results.matched++;
+        return;
+    }
+
+    results.mismatched++;
+    std::cerr << "mismatch: " << name << std::endl;
+    if (results.mismatched == 1) std::cerr << "--- input ---\n" << source << "\n---" << std::endl;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string chart_dir =
+        argc > 1 ? argv[1] : vsrg::joinPaths(VSRG_PROJECT_ROOT, "assets", "charts");
+    std::string scratch_path =
+        (std::filesystem::temp_directory_path() / "vsrg-parser-corpus.osu").string();
+
+    Results results;
+
+    int edge_case = 0;
+    for (const char* source : EDGE_CASES) {
+        compare(source, scratch_path, "edge case " + std::to_string(edge_case++), results);
+    }
+
+    std::vector<std::string> charts;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(chart_dir, ec);
+         it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) break;
+        if (it->path().extension() == ".osu") charts.push_back(it->path().string());
+    }
+
+    std::sort(charts.begin(), charts.end());
+
+    if (charts.empty()) {
+        std::cerr << "no charts found in " << chart_dir << std::endl;
+        return 1;
+    }
+
+    // fixed seed and sorted charts, a failure always reproduces
+    std::mt19937 rng(42);
+    for (const auto& chart : charts) {
+        std::string source = readFile(chart);
+        std::string name = std::filesystem::path(chart).filename().string();
+
+        compare(source, scratch_path, name, results);
+        for (int i = 0; i < MUTATIONS_PER_CHART; i++) {
+            compare(mutate(source, rng), scratch_path, name + " mutation " + std::to_string(i),
+                    results);
+        }
+    }
+
+    std::filesystem::remove(scratch_path, ec);
+
+    std::cout << results.matched << " matched, " << results.skipped
+              << " skipped (old loader threw), " << results.mismatched << " mismatched"
+              << std::endl;
+    return results.mismatched == 0 ? 0 : 1;
+}
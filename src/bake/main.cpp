@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+#include "core/ui/bakedTexture.hpp"
+#include "core/utils.hpp"
+
+using namespace vsrg;
+
+// bakes every image under an asset folder so the client never decodes png/jpg at runtime
+// usage: vsrg-bake [asset dir] [--force]
+// the asset dir defaults to the one next to the executable
+
+namespace {
+bool isImagePath(const std::filesystem::path &path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+           extension == ".bmp" || extension == ".tga";
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    std::string asset_dir = joinPaths(getExecutableDir(), "assets");
+    bool force = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--force") {
+            force = true;
+        } else if (arg == "--help" || arg == "-h") {
+            std::cout << "usage: vsrg-bake [asset dir] [--force]" << std::endl;
+            return 0;
+        } else {
+            asset_dir = arg;
+        }
+    }
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(asset_dir, ec)) {
+        std::cerr << "not a directory: " << asset_dir << std::endl;
+        return 1;
+    }
+
+    int baked = 0;
+    int up_to_date = 0;
+    int failed = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto options = std::filesystem::directory_options::skip_permission_denied;
+    for (auto it = std::filesystem::recursive_directory_iterator(asset_dir, options, ec);
+         it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (ec) break;
+        if (!it->is_regular_file(ec) || !isImagePath(it->path())) continue;
+
+        std::string image_path = it->path().string();
+
+        BakedTexture texture;
+        if (!force && readBakedTexture(image_path, texture)) {
+            up_to_date++;
+            continue;
+        }
+
+        if (!decodeTextureSource(image_path, texture) || !writeBakedTexture(image_path, texture)) {
+            std::cerr << "failed: " << image_path << std::endl;
+            failed++;
+            continue;
+        }
+
+        std::cout << "baked: " << image_path << " (" << texture.width << "x" << texture.height
+                  << ", " << texture.level_count << " levels)" << std::endl;
+        baked++;
+    }
+
+    if (ec) {
+        std::cerr << "error while walking " << asset_dir << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                            start);
+
+    std::cout << baked << " baked, " << up_to_date << " up to date, " << failed << " failed in "
+              << static_cast<int>(elapsed.count()) << " ms" << std::endl;
+
+    return failed > 0 ? 1 : 0;
+}
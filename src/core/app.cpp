@@ -3,6 +3,8 @@
 #include <iostream>
 
 #include "core/screens/initScreen.hpp"
+#include "core/ui/font.hpp"
+#include "core/ui/texture.hpp"
 #include "core/utils.hpp"
 
 
@@ -93,7 +95,8 @@ void Client::start() {
 
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // everything outputs premultiplied alpha, baked textures are stored that way
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
     glEnable(GL_DEPTH_TEST);
     glClearDepth(1.0);
@@ -119,6 +122,10 @@ void Client::start() {
         delta_time = std::chrono::duration<float>(current_time - last_time).count();
         last_time = current_time;
 
+        // textures decoded and glyphs rendered in the background since last frame
+        engine_context->get_texture_cache()->processUploads();
+        engine_context->get_font_manager()->processUploads();
+
         // think we might need 2 threads eventually, one for logic and one for
         // rendering but for now this is fine?
         engine_context->get_screen_manager()->update(delta_time);
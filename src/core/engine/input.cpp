@@ -0,0 +1,83 @@
+#include "core/engine/input.hpp"
+
+#include <chrono>
+
+#include "core/debug.hpp"
+#include "public/engineContext.hpp"
+#include "rhythm/conductor.hpp"
+
+
+namespace vsrg {
+InputManager::InputManager(EngineContext* engine_context) : engine_context(engine_context) {
+    int64_t steady_now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now().time_since_epoch())
+                             .count();
+    ticks_to_steady_ns = steady_now - (int64_t)SDL_GetTicksNS();
+
+    SDL_AddEventWatch(on_sdl_event, this);
+}
+
+InputManager::~InputManager() {
+    SDL_RemoveEventWatch(on_sdl_event, this);
+}
+
+bool SDLCALL InputManager::on_sdl_event(void* userdata, SDL_Event* event) {
+    if (event->type != SDL_EVENT_KEY_DOWN && event->type != SDL_EVENT_KEY_UP) return true;
+
+    InputManager* manager = static_cast<InputManager*>(userdata);
+    const SDL_KeyboardEvent& key = event->key;
+
+    InputEvent input;
+    input.type = key.down ? InputEventType::KEY_DOWN : InputEventType::KEY_UP;
+    input.scancode = (int)key.scancode;
+    input.keycode = (int)key.key;
+    input.repeat = key.repeat;
+
+    // sdl fills this from the os event where it can, otherwise its the time sdl received it
+    input.timestamp_ns = (int64_t)key.timestamp + manager->ticks_to_steady_ns;
+    input.song_time = -1.0;
+
+    if (!manager->queue.try_push(input)) {
+        manager->dropped_events.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return true;
+}
+
+void InputManager::set_conductor(Conductor* conductor) {
+    clear();
+    this->conductor = conductor;
+}
+
+size_t InputManager::drain(std::vector<InputEvent>& out_events) {
+    size_t count = 0;
+    InputEvent input;
+
+    while (queue.try_pop(input)) {
+        if (conductor) {
+            std::chrono::steady_clock::time_point time{std::chrono::duration_cast<
+                std::chrono::steady_clock::duration>(std::chrono::nanoseconds(input.timestamp_ns))};
+            input.song_time = conductor->song_time_at(time);
+        }
+
+        out_events.push_back(input);
+        count++;
+    }
+
+    uint64_t dropped = dropped_events.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_events) {
+        VSRG_LOG(*engine_context->get_debugger(), DebugLevel::WARNING,
+                 "input queue full, dropped " + std::to_string(dropped - reported_dropped_events) +
+                     " events");
+        reported_dropped_events = dropped;
+    }
+
+    return count;
+}
+
+void InputManager::clear() {
+    InputEvent input;
+    while (queue.try_pop(input)) {
+    }
+}
+}  // namespace vsrg
@@ -0,0 +1,122 @@
+#include "core/engine/streamBuffer.hpp"
+
+#include <algorithm>
+
+#include "core/debug.hpp"
+
+
+namespace vsrg {
+StreamBuffer::StreamBuffer(EngineContext* engine_context, GLenum target, size_t chunk_size,
+                           int chunk_count)
+    : engine_context(engine_context),
+      target(target),
+      chunk_size(chunk_size),
+      chunk_count(std::clamp(chunk_count, 1, 8)) {
+    glGenBuffers(1, &buffer);
+    glBindBuffer(target, buffer);
+
+    size_t total_size = chunk_size * this->chunk_count;
+
+    if (GLAD_GL_ARB_buffer_storage && glBufferStorage) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(target, total_size, nullptr, flags);
+        mapped_data = static_cast<unsigned char*>(glMapBufferRange(target, 0, total_size, flags));
+        persistent = mapped_data != nullptr;
+    }
+
+    if (!persistent) {
+        // buffer storage is immutable, so the fallback needs a fresh buffer object
+        if (GLAD_GL_ARB_buffer_storage) {
+            glBindBuffer(target, 0);
+            glDeleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+            glBindBuffer(target, buffer);
+        }
+        glBufferData(target, total_size, nullptr, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(target, 0);
+
+    engine_context->get_debugger()->log(
+        DebugLevel::INFO,
+        std::string("Stream buffer created (") +
+            (persistent ? "persistent mapped" : "orphaning fallback") + ", " +
+            std::to_string(total_size / 1024) + " KB)",
+        __FILE__, __LINE__);
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (auto& fence : chunk_fences) {
+        if (fence) glDeleteSync(fence);
+    }
+
+    if (buffer) {
+        if (persistent) {
+            glBindBuffer(target, buffer);
+            glUnmapBuffer(target);
+            glBindBuffer(target, 0);
+        }
+        glDeleteBuffers(1, &buffer);
+    }
+}
+
+void StreamBuffer::advanceChunk() {
+    if (persistent) {
+        // fence what was just written, then wait until the gpu is done with the next chunk
+        if (chunk_fences[current_chunk]) glDeleteSync(chunk_fences[current_chunk]);
+        chunk_fences[current_chunk] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        current_chunk = (current_chunk + 1) % chunk_count;
+
+        GLsync fence = chunk_fences[current_chunk];
+        if (fence) {
+            GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            while (result == GL_TIMEOUT_EXPIRED) {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            }
+            glDeleteSync(fence);
+            chunk_fences[current_chunk] = nullptr;
+        }
+    } else {
+        // orphan, the driver hands us new storage and keeps the old one alive for pending draws
+        glBufferData(target, chunk_size * chunk_count, nullptr, GL_STREAM_DRAW);
+        current_chunk = 0;
+    }
+
+    chunk_offset = 0;
+}
+
+void* StreamBuffer::map(size_t size, size_t& out_offset) {
+    if (size > chunk_size) return nullptr;
+
+    glBindBuffer(target, buffer);
+
+    // the fallback treats the whole buffer as one big chunk, orphaning only when it is full
+    size_t limit = persistent ? chunk_size : chunk_size * chunk_count;
+    if (chunk_offset + size > limit) advanceChunk();
+
+    size_t offset = (persistent ? current_chunk * chunk_size : 0) + chunk_offset;
+    chunk_offset += size;
+    out_offset = offset;
+
+    if (persistent) {
+        return mapped_data + offset;
+    }
+
+    void* data = glMapBufferRange(target, offset, size,
+                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                      GL_MAP_UNSYNCHRONIZED_BIT);
+
+    // a pixel unpack buffer left bound would turn the caller's plain uploads into offsets
+    if (!data) glBindBuffer(target, 0);
+    return data;
+}
+
+void StreamBuffer::unmap() {
+    // coherent mappings are visible to the gpu as soon as the draw is issued
+    if (!persistent) {
+        glBindBuffer(target, buffer);
+        glUnmapBuffer(target);
+    }
+}
+}  // namespace vsrg
@@ -2,6 +2,7 @@
 
 #include "core/debug.hpp"
 #include "core/engine/audio.hpp"
+#include "core/engine/input.hpp"
 #include "core/engine/shader.hpp"
 #include "core/utils.hpp"
 #include "public/engineContext.hpp"
@@ -41,17 +42,42 @@ DebugScreen::~DebugScreen() {
 
 void DebugScreen::update(float delta_time) {
     if (gameplay_plugin) {
+        input_events.clear();
+        engine_context->get_input_manager()->drain(input_events);
+        if (!input_events.empty()) gameplay_plugin->on_input(input_events);
+
         gameplay_plugin->update(delta_time);
+    } else {
+        // nobody reads them, dont let them pile up until the queue overflows
+        engine_context->get_input_manager()->clear();
     }
 
     float fps = getFPS(delta_time);
-    std::string memory = getFormattedMemoryUsage();
 
-    std::stringstream textData;
-    textData << "FPS: " << static_cast<int>(fps) << "\n";
-    textData << "Memory: " << memory << "\n";
+    // memory reads /proc, both only change the text once a second so it stays cached in between
+    stats_timer += delta_time;
+    if (stats_timer >= 1.0f || memory.empty()) {
+        // a steady eviction rate means the glyph atlas is too small
+        glyph_stats = engine_context->get_font_manager()->getAtlasStats();
+        if (!memory.empty()) {
+            glyph_eviction_rate = (glyph_stats.evictions - last_glyph_evictions) / stats_timer;
+        }
+        last_glyph_evictions = glyph_stats.evictions;
+        stats_timer = 0.0f;
+
+        memory = getFormattedMemoryUsage();
+    }
+
+    text_data.clear();
+    text_data.append("FPS: ").appendInt(static_cast<int>(fps)).append("\n");
+    text_data.append("Memory: ").append(memory).append("\n");
+    text_data.append("Glyphs: ").appendInt(glyph_stats.glyphs).append(" in ");
+    text_data.appendInt(glyph_stats.pages).append("/").appendInt(glyph_stats.max_pages);
+    text_data.append(" pages, ").appendInt(static_cast<int>(glyph_stats.occupancy * 100.0f));
+    text_data.append("% used, ").appendInt(static_cast<int>(glyph_eviction_rate));
+    text_data.append(" evictions/s\n");
 
-    text_component.setText(textData.str());
+    text_component.setText(text_data.view());
 }
 
 void DebugScreen::render() {
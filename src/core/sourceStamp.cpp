@@ -0,0 +1,27 @@
+#include "core/sourceStamp.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace vsrg {
+bool getSourceStamp(const std::string& path, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    auto file_size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto write_time = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+
+    size = static_cast<uint64_t>(file_size);
+    mtime = static_cast<int64_t>(write_time.time_since_epoch().count());
+    return true;
+}
+
+void refreshSourceStamp(const std::string& cache_path, size_t mtime_offset, int64_t mtime) {
+    std::fstream file(cache_path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.is_open()) return;
+
+    file.seekp(mtime_offset);
+    file.write(reinterpret_cast<const char*>(&mtime), sizeof(mtime));
+}
+}  // namespace vsrg
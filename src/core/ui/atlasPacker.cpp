@@ -0,0 +1,190 @@
+#include "core/ui/atlasPacker.hpp"
+
+#include <algorithm>
+#include <climits>
+
+
+namespace vsrg {
+void SkylinePacker::reset(int width, int height) {
+    this->width = width;
+    this->height = height;
+    used_area = 0;
+
+    skyline.clear();
+    if (width > 0) skyline.push_back({0, 0, width});
+}
+
+int SkylinePacker::fitAt(size_t index, int rect_width, int rect_height) const {
+    int x = skyline[index].x;
+    if (x + rect_width > width) return -1;
+
+    // the rect rests on the highest segment it spans
+    int y = 0;
+    int remaining = rect_width;
+    for (size_t i = index; remaining > 0; i++) {
+        y = std::max(y, skyline[i].y);
+        if (y + rect_height > height) return -1;
+        remaining -= skyline[i].width;
+    }
+
+    return y;
+}
+
+bool SkylinePacker::pack(int rect_width, int rect_height, glm::ivec2& out_position) {
+    if (rect_width <= 0 || rect_height <= 0) return false;
+
+    int best_index = -1;
+    int best_top = INT_MAX;
+    int best_segment_width = INT_MAX;
+    int best_y = 0;
+
+    for (size_t i = 0; i < skyline.size(); i++) {
+        int y = fitAt(i, rect_width, rect_height);
+        if (y < 0) continue;
+
+        // lowest top edge wins, ties go to the narrower segment to leave wide gaps open
+        int top = y + rect_height;
+        if (top < best_top || (top == best_top && skyline[i].width < best_segment_width)) {
+            best_index = static_cast<int>(i);
+            best_top = top;
+            best_segment_width = skyline[i].width;
+            best_y = y;
+        }
+    }
+
+    if (best_index < 0) return false;
+
+    out_position = glm::ivec2(skyline[best_index].x, best_y);
+
+    // the new segment covers the rect, everything it overlaps gets shortened or removed
+    Segment added = {out_position.x, best_y + rect_height, rect_width};
+    skyline.insert(skyline.begin() + best_index, added);
+
+    size_t i = best_index + 1;
+    while (i < skyline.size()) {
+        Segment& segment = skyline[i];
+        int added_end = added.x + added.width;
+        if (segment.x >= added_end) break;
+
+        int shrink = added_end - segment.x;
+        if (shrink >= segment.width) {
+            skyline.erase(skyline.begin() + i);
+            continue;
+        }
+
+        segment.x += shrink;
+        segment.width -= shrink;
+        break;
+    }
+
+    // merge neighbours at the same height so the list stays short
+    for (size_t j = 0; j + 1 < skyline.size();) {
+        if (skyline[j].y == skyline[j + 1].y) {
+            skyline[j].width += skyline[j + 1].width;
+            skyline.erase(skyline.begin() + j + 1);
+        } else {
+            j++;
+        }
+    }
+
+    used_area += static_cast<long long>(rect_width) * rect_height;
+    return true;
+}
+
+float SkylinePacker::getOccupancy() const {
+    if (width <= 0 || height <= 0) return 0.0f;
+    return static_cast<float>(used_area) / (static_cast<float>(width) * height);
+}
+
+void ShelfPacker::reset(int width, int height) {
+    this->width = width;
+    this->height = height;
+    shelves_end = 0;
+    used_area = 0;
+    shelves.clear();
+}
+
+bool ShelfPacker::pack(int rect_width, int rect_height, glm::ivec2& out_position) {
+    if (rect_width <= 0 || rect_height <= 0 || rect_width > width) return false;
+
+    int step = SHELF_PACKER_HEIGHT_STEP;
+    int shelf_height = (rect_height + step - 1) / step * step;
+
+    // the tightest shelf with a wide enough gap. only shelves of the rounded height count while
+    // there is room for new ones, after that any shelf tall enough does
+    bool page_full = height - shelves_end < shelf_height;
+    Shelf* best_shelf = nullptr;
+    size_t best_span = 0;
+    for (auto& shelf : shelves) {
+        if (shelf.height < rect_height) continue;
+        if (shelf.height != shelf_height && shelf.used > 0 && !page_full) continue;
+        if (best_shelf && shelf.height >= best_shelf->height) continue;
+
+        for (size_t i = 0; i < shelf.spans.size(); i++) {
+            if (shelf.spans[i].width >= rect_width) {
+                best_shelf = &shelf;
+                best_span = i;
+                break;
+            }
+        }
+    }
+
+    if (!best_shelf) {
+        // open a new shelf below the others, the last one may be cut short by the page edge
+        shelf_height = std::min(shelf_height, height - shelves_end);
+        if (shelf_height < rect_height) return false;
+
+        shelves.push_back({shelves_end, shelf_height, 0, {{0, width}}});
+        shelves_end += shelf_height;
+        best_shelf = &shelves.back();
+        best_span = 0;
+    }
+
+    Span& span = best_shelf->spans[best_span];
+    out_position = glm::ivec2(span.x, best_shelf->y);
+
+    span.x += rect_width;
+    span.width -= rect_width;
+    if (span.width == 0) best_shelf->spans.erase(best_shelf->spans.begin() + best_span);
+
+    best_shelf->used++;
+    used_area += static_cast<long long>(rect_width) * rect_height;
+    return true;
+}
+
+void ShelfPacker::release(glm::ivec2 position, int rect_width, int rect_height) {
+    auto shelf = std::find_if(shelves.begin(), shelves.end(),
+                              [&](const Shelf& s) { return s.y == position.y; });
+    if (shelf == shelves.end() || shelf->used == 0) return;
+
+    auto& spans = shelf->spans;
+    auto next = std::lower_bound(spans.begin(), spans.end(), position.x,
+                                 [](const Span& span, int x) { return span.x < x; });
+    next = spans.insert(next, {position.x, rect_width});
+
+    // merge with the gaps on either side so wide rects fit again
+    if (next + 1 != spans.end() && next->x + next->width == (next + 1)->x) {
+        next->width += (next + 1)->width;
+        spans.erase(next + 1);
+    }
+    if (next != spans.begin() && (next - 1)->x + (next - 1)->width == next->x) {
+        (next - 1)->width += next->width;
+        spans.erase(next);
+    }
+
+    shelf->used--;
+    used_area -= static_cast<long long>(rect_width) * rect_height;
+}
+
+int ShelfPacker::getShelfHeight(int y) const {
+    for (const auto& shelf : shelves) {
+        if (shelf.y == y) return shelf.height;
+    }
+    return 0;
+}
+
+float ShelfPacker::getOccupancy() const {
+    if (width <= 0 || height <= 0) return 0.0f;
+    return static_cast<float>(used_area) / (static_cast<float>(width) * height);
+}
+}  // namespace vsrg
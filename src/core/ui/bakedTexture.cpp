@@ -0,0 +1,229 @@
+#include "core/ui/bakedTexture.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include "core/mappedFile.hpp"
+#include "core/sourceStamp.hpp"
+#include "core/ui/texture.hpp"
+
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+namespace vsrg {
+namespace {
+unsigned char premultiply(unsigned char color, unsigned char alpha) {
+    return static_cast<unsigned char>((color * alpha + 127) / 255);
+}
+
+// 2x2 box filter, odd edges reuse the last row/column. fine on premultiplied pixels
+void downsample(const unsigned char* src, int src_width, int src_height, unsigned char* dst,
+                int dst_width, int dst_height) {
+    for (int y = 0; y < dst_height; y++) {
+        int y0 = std::min(y * 2, src_height - 1);
+        int y1 = std::min(y * 2 + 1, src_height - 1);
+
+        for (int x = 0; x < dst_width; x++) {
+            int x0 = std::min(x * 2, src_width - 1);
+            int x1 = std::min(x * 2 + 1, src_width - 1);
+
+            const unsigned char* a = src + (static_cast<size_t>(y0) * src_width + x0) * 4;
+            const unsigned char* b = src + (static_cast<size_t>(y0) * src_width + x1) * 4;
+            const unsigned char* c = src + (static_cast<size_t>(y1) * src_width + x0) * 4;
+            const unsigned char* d = src + (static_cast<size_t>(y1) * src_width + x1) * 4;
+            unsigned char* out = dst + (static_cast<size_t>(y) * dst_width + x) * 4;
+
+            for (int i = 0; i < 4; i++) {
+                out[i] = static_cast<unsigned char>((a[i] + b[i] + c[i] + d[i] + 2) / 4);
+            }
+        }
+    }
+}
+}  // namespace
+
+size_t BakedTexture::getLevelOffset(int level) const {
+    size_t offset = 0;
+    for (int i = 0; i < level; i++) {
+        offset += static_cast<size_t>(getLevelWidth(i)) * getLevelHeight(i) * 4;
+    }
+    return offset;
+}
+
+std::string getBakedTexturePath(const std::string& image_path) {
+    return image_path + ".vtx";
+}
+
+bool shouldBakeMipmaps(int width, int height) {
+    return width > TEXTURE_ATLAS_MAX_ENTRY_SIZE || height > TEXTURE_ATLAS_MAX_ENTRY_SIZE;
+}
+
+bool decodeTextureSource(const std::string& image_path, BakedTexture& out_texture) {
+    int width, height, channels;
+    unsigned char* data = stbi_load(image_path.c_str(), &width, &height, &channels, 0);
+    if (!data) return false;
+
+    BakedTexture texture;
+    texture.width = width;
+    texture.height = height;
+    texture.channels = channels;
+    texture.level_count = 1;
+
+    if (shouldBakeMipmaps(width, height)) {
+        while (texture.getLevelWidth(texture.level_count - 1) > 1 ||
+               texture.getLevelHeight(texture.level_count - 1) > 1) {
+            texture.level_count++;
+        }
+    }
+
+    texture.pixels.resize(texture.getLevelOffset(texture.level_count));
+
+    // expand to rgba the way sampling the old single channel textures did (GL_RED reads back
+    // as red only), then premultiply so filtering and blending dont fringe
+    size_t pixel_count = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < pixel_count; i++) {
+        const unsigned char* src = data + i * channels;
+        unsigned char* dst = &texture.pixels[i * 4];
+
+        switch (channels) {
+            case 1:
+                dst[0] = src[0], dst[1] = 0, dst[2] = 0, dst[3] = 255;
+                break;
+            case 2:
+                dst[0] = dst[1] = dst[2] = premultiply(src[0], src[1]), dst[3] = src[1];
+                break;
+            case 3:
+                dst[0] = src[0], dst[1] = src[1], dst[2] = src[2], dst[3] = 255;
+                break;
+            default:
+                dst[0] = premultiply(src[0], src[3]);
+                dst[1] = premultiply(src[1], src[3]);
+                dst[2] = premultiply(src[2], src[3]);
+                dst[3] = src[3];
+                break;
+        }
+    }
+
+    stbi_image_free(data);
+
+    for (int level = 1; level < texture.level_count; level++) {
+        downsample(&texture.pixels[texture.getLevelOffset(level - 1)],
+                   texture.getLevelWidth(level - 1), texture.getLevelHeight(level - 1),
+                   &texture.pixels[texture.getLevelOffset(level)], texture.getLevelWidth(level),
+                   texture.getLevelHeight(level));
+    }
+
+    out_texture = std::move(texture);
+    return true;
+}
+
+bool readBakedTexture(const std::string& image_path, BakedTexture& out_texture) {
+    uint64_t source_size;
+    int64_t source_mtime;
+    if (!getSourceStamp(image_path, source_size, source_mtime)) return false;
+
+    MappedFile cache(getBakedTexturePath(image_path));
+    if (!cache.isOpen() || cache.getSize() < sizeof(BakedTextureHeader)) return false;
+
+    const unsigned char* base = cache.getData();
+
+    BakedTextureHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    if (header.magic != BAKED_TEXTURE_MAGIC || header.version != BAKED_TEXTURE_VERSION) {
+        return false;
+    }
+    if (header.source_size != source_size) return false;
+
+    bool touched = header.source_mtime != source_mtime;
+    if (touched) {
+        // touched but maybe not edited, only the content hash can tell
+        MappedFile source(image_path);
+        if (!source.isOpen()) return false;
+        if (hashFNV1a(source.getData(), source.getSize()) != header.source_hash) return false;
+    }
+
+    if (header.width <= 0 || header.height <= 0 || header.level_count == 0 ||
+        header.level_count > 32) {
+        return false;
+    }
+
+    BakedTexture texture;
+    texture.width = header.width;
+    texture.height = header.height;
+    texture.channels = header.channels;
+    texture.level_count = static_cast<int>(header.level_count);
+
+    size_t data_size = texture.getLevelOffset(texture.level_count);
+    if (header.data_size != data_size) return false;
+    if (sizeof(header) + data_size > cache.getSize()) return false;
+
+    // the whole chain is one contiguous block, so this is the only copy
+    const unsigned char* pixels = base + sizeof(header);
+    texture.pixels.assign(pixels, pixels + data_size);
+
+    // windows wont let us write to a file that is still mapped
+    cache.close();
+    if (touched) {
+        refreshSourceStamp(getBakedTexturePath(image_path),
+                           offsetof(BakedTextureHeader, source_mtime), source_mtime);
+    }
+
+    out_texture = std::move(texture);
+    return true;
+}
+
+bool writeBakedTexture(const std::string& image_path, const BakedTexture& texture) {
+    BakedTextureHeader header = {};
+    header.magic = BAKED_TEXTURE_MAGIC;
+    header.version = BAKED_TEXTURE_VERSION;
+
+    if (!getSourceStamp(image_path, header.source_size, header.source_mtime)) return false;
+
+    {
+        MappedFile source(image_path);
+        if (!source.isOpen()) return false;
+        header.source_hash = hashFNV1a(source.getData(), source.getSize());
+    }
+
+    header.width = texture.width;
+    header.height = texture.height;
+    header.channels = texture.channels;
+    header.level_count = static_cast<uint32_t>(texture.level_count);
+    header.data_size = texture.pixels.size();
+
+    // write to a temp file first so a crash never leaves a half written cache behind
+    std::string cache_path = getBakedTexturePath(image_path);
+    std::string temp_path = cache_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(texture.pixels.data()), texture.pixels.size());
+        if (!file.good()) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, cache_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+
+    return true;
+}
+
+bool loadBakedTexture(const std::string& image_path, BakedTexture& out_texture) {
+    if (readBakedTexture(image_path, out_texture)) return true;
+    if (!decodeTextureSource(image_path, out_texture)) return false;
+
+    // a read only asset folder just means decoding every time
+    writeBakedTexture(image_path, out_texture);
+    return true;
+}
+}  // namespace vsrg
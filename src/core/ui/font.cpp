@@ -1,16 +1,152 @@
 #include "core/ui/font.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstring>
+#include <iterator>
 #include <memory>
+#include <thread>
 #include <tuple>
 #include <utility>
 
 #include "core/debug.hpp"
+#include "core/engine/shader.hpp"
 #include "core/utils.hpp"
 
 namespace vsrg {
 
+const char* text_vertex_shader = R"glsl(
+    #version 330 core
+    layout (location = 0) in vec4 vertex; // vec2 pos, vec2 tex
+    out vec2 texture_coords;
+
+    uniform mat4 projection;
+    uniform float z_order;
+
+    void main()
+    {
+        gl_Position = projection * vec4(vertex.xy, z_order, 1.0);
+        texture_coords = vertex.zw;
+    }
+)glsl";
+
+const char* text_fragment_shader = R"glsl(
+    #version 330 core
+    in vec2 texture_coords;
+    out vec4 texture_color;
+
+    uniform sampler2D atlas;
+    uniform vec3 color;
+    uniform float opacity;
+    uniform bool sdf;
+
+    void main()
+    {
+        float alpha = texture(atlas, texture_coords).r;
+        if (sdf) {
+            // 0.5 is the outline, fade over about one screen pixel whatever the scale
+            float width = max(fwidth(alpha) * 0.5, 1e-4);
+            alpha = smoothstep(0.5 - width, 0.5 + width, alpha);
+        }
+        texture_color = vec4(color, 1.0) * (alpha * opacity);
+    }
+)glsl";
+
+namespace {
+const float SDF_INF = 1e20f;
+
+// felzenszwalb/huttenlocher squared distance transform of one row or column of the grid, in
+// place. f, v and z are scratch space for length, length and length + 1 entries
+void distanceTransform(float* grid, int offset, int stride, int length, float* f, int* v,
+                       float* z) {
+    v[0] = 0;
+    z[0] = -SDF_INF;
+    z[1] = SDF_INF;
+    f[0] = grid[offset];
+
+    for (int q = 1, k = 0; q < length; q++) {
+        f[q] = grid[offset + q * stride];
+        float s;
+        do {
+            int r = v[k];
+            s = (f[q] - f[r] + static_cast<float>(q * q - r * r)) / static_cast<float>(2 * (q - r));
+        } while (s <= z[k] && --k > -1);
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = SDF_INF;
+    }
+
+    for (int q = 0, k = 0; q < length; q++) {
+        while (z[k + 1] < q) k++;
+        int r = v[k];
+        grid[offset + q * stride] = f[r] + static_cast<float>((q - r) * (q - r));
+    }
+}
+
+// turns an antialiased coverage bitmap into a distance field padded by FONT_SDF_SPREAD on every
+// side, 128 on the outline and higher inside like FT_RENDER_MODE_SDF. freetypes own sdf
+// renderers take milliseconds per glyph, this is a couple of passes over a tiny grid. partial
+// coverage places the edge inside the pixel, which is what keeps it smooth
+void buildDistanceField(unsigned int& width, unsigned int& rows,
+                        std::vector<unsigned char>& pixels) {
+    const int pad = FONT_SDF_SPREAD;
+    int grid_width = static_cast<int>(width) + pad * 2;
+    int grid_rows = static_cast<int>(rows) + pad * 2;
+    size_t grid_size = static_cast<size_t>(grid_width) * grid_rows;
+
+    // squared distance to the nearest outside pixel and to the nearest inside one
+    std::vector<float> outer(grid_size, SDF_INF);
+    std::vector<float> inner(grid_size, 0.0f);
+
+    for (unsigned int y = 0; y < rows; y++) {
+        for (unsigned int x = 0; x < width; x++) {
+            float a = pixels[y * width + x] / 255.0f;
+            if (a == 0.0f) continue;
+
+            size_t i = (y + pad) * static_cast<size_t>(grid_width) + x + pad;
+            if (a == 1.0f) {
+                outer[i] = 0.0f;
+                inner[i] = SDF_INF;
+            } else {
+                float d = 0.5f - a;
+                outer[i] = d > 0.0f ? d * d : 0.0f;
+                inner[i] = d < 0.0f ? d * d : 0.0f;
+            }
+        }
+    }
+
+    int length = std::max(grid_width, grid_rows);
+    std::vector<float> f(length), z(length + 1);
+    std::vector<int> v(length);
+
+    for (auto* grid : {&outer, &inner}) {
+        for (int x = 0; x < grid_width; x++) {
+            distanceTransform(grid->data(), x, grid_width, grid_rows, f.data(), v.data(),
+                              z.data());
+        }
+        for (int y = 0; y < grid_rows; y++) {
+            distanceTransform(grid->data(), y * grid_width, 1, grid_width, f.data(), v.data(),
+                              z.data());
+        }
+    }
+
+    pixels.resize(grid_size);
+    for (size_t i = 0; i < grid_size; i++) {
+        float distance = std::sqrt(outer[i]) - std::sqrt(inner[i]);  // positive outside
+        float value = 128.0f - distance * (128.0f / pad);
+        pixels[i] = static_cast<unsigned char>(std::clamp(std::lround(value), 0l, 255l));
+    }
+
+    width = static_cast<unsigned int>(grid_width);
+    rows = static_cast<unsigned int>(grid_rows);
+}
+
+// lists shorter than this arent worth spinning up threads for
+const size_t FONT_PRELOAD_MIN_THREADED = 64;
+}  // namespace
+
 FontManager::FontManager(EngineContext* engine_context) : engine_context(engine_context) {
     if (FT_Init_FreeType(&ft)) {
         engine_context->get_debugger()->log(
@@ -20,35 +156,99 @@ FontManager::FontManager(EngineContext* engine_context) : engine_context(engine_
 }
 
 FontManager::~FontManager() {
+    // layouts hold on to glyphs
+    layout_cache.clear();
     fonts.clear();
     FT_Done_FreeType(ft);
+
+    if (text_program.program) glDeleteProgram(text_program.program);
+}
+
+const TextProgram& FontManager::getTextProgram() {
+    if (text_program.program) return text_program;
+
+    GLuint program = createShaderProgram(engine_context, text_vertex_shader, text_fragment_shader);
+    if (!program) return text_program;
+
+    text_program.program = program;
+    text_program.projection_uniform = glGetUniformLocation(program, "projection");
+    text_program.atlas_uniform = glGetUniformLocation(program, "atlas");
+    text_program.color_uniform = glGetUniformLocation(program, "color");
+    text_program.opacity_uniform = glGetUniformLocation(program, "opacity");
+    text_program.z_order_uniform = glGetUniformLocation(program, "z_order");
+    text_program.sdf_uniform = glGetUniformLocation(program, "sdf");
+
+    return text_program;
 }
 
-bool FontManager::loadFont(const std::string& name, int size_pt) {
+void FontManager::setMaxAtlasPages(size_t pages) {
+    max_atlas_pages = pages;
+    for (auto& [key, font] : fonts) {
+        font.setMaxAtlasPages(pages);
+    }
+}
+
+FontAtlasStats FontManager::getAtlasStats() const {
+    FontAtlasStats stats;
+    for (const auto& [key, font] : fonts) {
+        FontAtlasStats font_stats = font.getAtlasStats();
+        stats.pages += font_stats.pages;
+        stats.max_pages += font_stats.max_pages;
+        stats.glyphs += font_stats.glyphs;
+        stats.occupancy += font_stats.occupancy * font_stats.pages;
+        stats.evictions += font_stats.evictions;
+    }
+    if (stats.pages > 0) stats.occupancy /= stats.pages;
+
+    return stats;
+}
+
+void FontManager::processUploads() {
+    // every font still gets called once the budget is spent, its frame index has to tick for
+    // the lru order to mean anything
+    size_t budget = FONT_UPLOAD_BUDGET_BYTES;
+    for (auto& [key, font] : fonts) {
+        budget -= std::min(budget, font.processUploads(budget));
+    }
+}
+
+std::string FontManager::getFontKey(const std::string& name, int size_pt,
+                                    FontRenderMode render_mode) {
+    if (render_mode == FontRenderMode::SDF) return name + "#sdf";
+    return name + "#" + std::to_string(size_pt);
+}
+
+bool FontManager::loadFont(const std::string& name, int size_pt, FontRenderMode render_mode) {
     std::string execPath = getExecutableDir();
     std::string filePath = joinPaths(execPath, "assets/fonts", name);
 
-    auto [it, inserted] =
-        fonts.emplace(std::piecewise_construct, std::forward_as_tuple(name),
-                      std::forward_as_tuple(engine_context, ft, filePath, size_pt));
+    if (render_mode == FontRenderMode::SDF) size_pt = FONT_SDF_SIZE_PT;
+
+    auto [it, inserted] = fonts.emplace(
+        std::piecewise_construct, std::forward_as_tuple(getFontKey(name, size_pt, render_mode)),
+        std::forward_as_tuple(engine_context, ft, filePath, size_pt, render_mode));
+    if (inserted) it->second.setMaxAtlasPages(max_atlas_pages);
     return it->second.isLoaded();
 }
 
-Font* FontManager::getFont(const std::string& name) {
-    auto it = fonts.find(name);
+Font* FontManager::getFont(const std::string& name, int size_pt, FontRenderMode render_mode) {
+    std::string key = getFontKey(name, size_pt, render_mode);
+
+    auto it = fonts.find(key);
     if (it != fonts.end())
         return &it->second;
     else {
-        if (loadFont(name)) {
-            return &fonts.at(name);
+        if (loadFont(name, size_pt, render_mode)) {
+            return &fonts.at(key);
         } else {
             return nullptr;
         }
     }
 }
 
-Font::Font(EngineContext* engine_context, FT_Library ft, const std::string& path, int size_pt)
-    : engine_context(engine_context), size_pt(size_pt) {
+Font::Font(EngineContext* engine_context, FT_Library ft, const std::string& path, int size_pt,
+           FontRenderMode render_mode)
+    : engine_context(engine_context), path(path), size_pt(size_pt), render_mode(render_mode) {
     if (FT_New_Face(ft, path.c_str(), 0, &face)) {
         engine_context->get_debugger()->log(
             DebugLevel::ERROR, std::string("Failed to load font: ") + path, __FILE__, __LINE__);
@@ -75,10 +275,16 @@ Font::Font(EngineContext* engine_context, FT_Library ft, const std::string& path
     }
 
     if (!createNewAtlas()) return;
-    if (!initBuffers()) return;
 
+    std::vector<Charcode> ascii;
     for (Charcode c = 32; c < 128; c++) {
-        loadGlyph(c);
+        ascii.push_back(c);
+    }
+    preloadGlyphs(ascii);
+
+    // stands in for glyphs still rendering, takes up the space of a notdef box
+    if (!FT_Load_Glyph(face, 0, FT_LOAD_DEFAULT)) {
+        placeholder.advance = static_cast<GLuint>(face->glyph->advance.x >> 6);
     }
 
     if (auto H = getCharacter('H')) {
@@ -89,31 +295,184 @@ Font::Font(EngineContext* engine_context, FT_Library ft, const std::string& path
 }
 
 Font::~Font() {
+    if (glyph_queue) {
+        {
+            std::lock_guard<std::mutex> lock(glyph_queue->mutex);
+            glyph_queue->stop = true;
+        }
+        glyph_queue->condition.notify_all();
+    }
+    if (glyph_worker.joinable()) glyph_worker.join();
+
     if (face) {
         FT_Done_Face(face);
         face = nullptr;
     }
 
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-
     for (const auto& atlas : atlases) {
         glDeleteTextures(1, &atlas.texture_id);
     }
 }
 
-std::optional<Character> Font::getCharacter(Charcode charcode) {
-    if (!loaded) return {};
+const Character* Font::getCharacter(Charcode charcode) {
+    if (!loaded) return nullptr;
     auto it = characters.find(charcode);
-    if (it != characters.end())
-        return it->second;
-    else {
-        if (loadGlyph(charcode)) {
-            return characters.at(charcode);
+    if (it != characters.end()) {
+        it->second.last_used = frame_index;
+        return &it->second;
+    } else {
+        if (missing_glyphs.count(charcode)) return nullptr;
+
+        requestGlyph(charcode);
+        return &placeholder;
+    }
+}
+
+void Font::retainGlyph(const Character* character) {
+    if (character && !isPlaceholder(character)) character->reference_count++;
+}
+
+void Font::releaseGlyph(const Character* character) {
+    if (!character || isPlaceholder(character)) return;
+    if (--character->reference_count == 0) released_glyphs++;
+    character->last_used = frame_index;
+}
+
+void Font::requestGlyph(Charcode charcode) {
+    auto [it, inserted] = requested_glyphs.try_emplace(charcode, false);
+    if (!inserted) {
+        if (!it->second) return;
+        // was only prewarming, queue it again in front. the duplicate is skipped on upload
+        it->second = false;
+    }
+
+    startGlyphWorker();
+    {
+        std::lock_guard<std::mutex> lock(glyph_queue->mutex);
+        glyph_queue->requests.push_back(charcode);
+    }
+    glyph_queue->condition.notify_one();
+}
+
+void Font::prewarmGlyphs(const std::vector<Charcode>& charcodes) {
+    if (!loaded) return;
+
+    std::vector<Charcode> wanted;
+    for (Charcode charcode : charcodes) {
+        if (characters.count(charcode) || missing_glyphs.count(charcode)) continue;
+        if (requested_glyphs.try_emplace(charcode, true).second) wanted.push_back(charcode);
+    }
+    if (wanted.empty()) return;
+
+    startGlyphWorker();
+    {
+        std::lock_guard<std::mutex> lock(glyph_queue->mutex);
+        glyph_queue->prewarm_requests.insert(glyph_queue->prewarm_requests.end(), wanted.begin(),
+                                             wanted.end());
+    }
+    glyph_queue->condition.notify_one();
+}
+
+void Font::startGlyphWorker() {
+    if (glyph_queue) return;
+
+    glyph_queue = std::make_unique<GlyphQueue>();
+    glyph_worker = std::thread(glyphWorker, glyph_queue.get(), path, size_pt, render_mode);
+}
+
+void Font::glyphWorker(GlyphQueue* queue, std::string path, int size_pt,
+                       FontRenderMode render_mode) {
+    FT_Library ft = nullptr;
+    FT_Face face = nullptr;
+    if (!FT_Init_FreeType(&ft)) {
+        if (FT_New_Face(ft, path.c_str(), 0, &face)) {
+            face = nullptr;
+        } else if (FT_Set_Char_Size(face, 0, size_pt * 64, 96, 96)) {
+            FT_Done_Face(face);
+            face = nullptr;
+        }
+    }
+
+    while (true) {
+        Charcode charcode;
+        {
+            std::unique_lock<std::mutex> lock(queue->mutex);
+            queue->condition.wait(lock, [queue] {
+                return queue->stop || !queue->requests.empty() ||
+                       !queue->prewarm_requests.empty();
+            });
+            if (queue->stop) break;
+
+            auto& source = queue->requests.empty() ? queue->prewarm_requests : queue->requests;
+            charcode = source.front();
+            source.pop_front();
+        }
+
+        // without a face every glyph comes back invalid, which marks it missing
+        GlyphBitmap glyph;
+        glyph.charcode = charcode;
+        if (face) glyph.valid = renderGlyph(face, render_mode, charcode, glyph);
+
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->rendered.push_back(std::move(glyph));
+    }
+
+    if (face) FT_Done_Face(face);
+    if (ft) FT_Done_FreeType(ft);
+}
+
+size_t Font::processUploads(size_t budget_bytes) {
+    frame_index++;
+    if (!glyph_queue) return 0;
+
+    {
+        std::lock_guard<std::mutex> lock(glyph_queue->mutex);
+        for (auto& glyph : glyph_queue->rendered) {
+            ready_glyphs.push_back(std::move(glyph));
+        }
+        glyph_queue->rendered.clear();
+    }
+
+    // retrying before anything was released or another page is allowed would fail the same way,
+    // and sort every glyph in the atlas again for nothing
+    if (!deferred_glyphs.empty() &&
+        (released_glyphs != deferred_release_count || atlases.size() < max_atlas_pages)) {
+        ready_glyphs.insert(ready_glyphs.begin(), std::make_move_iterator(deferred_glyphs.begin()),
+                            std::make_move_iterator(deferred_glyphs.end()));
+        deferred_glyphs.clear();
+    }
+    if (ready_glyphs.empty() || budget_bytes == 0) return 0;
+
+    bool changed = false;
+
+    size_t used = 0;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    while (!ready_glyphs.empty() && used < budget_bytes) {
+        GlyphBitmap& glyph = ready_glyphs.front();
+        used += glyph.pixels.size();
+
+        if (characters.count(glyph.charcode)) {
+            requested_glyphs.erase(glyph.charcode);
+        } else if (!glyph.valid) {
+            requested_glyphs.erase(glyph.charcode);
+            missing_glyphs.insert(glyph.charcode);
+            changed = true;
+        } else if (addGlyph(glyph)) {
+            requested_glyphs.erase(glyph.charcode);
+            changed = true;
         } else {
-            return {};
+            // stays requested, so nothing asks the worker for it again
+            deferred_glyphs.push_back(std::move(glyph));
+            deferred_release_count = released_glyphs;
         }
+
+        ready_glyphs.pop_front();
     }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (changed) glyph_generation++;
+    return used;
 }
 
 bool Font::createNewAtlas() {
@@ -121,13 +480,13 @@ bool Font::createNewAtlas() {
 
     new_atlas.width = FONT_ATLAS_DEFAULT_SIZE;
     new_atlas.height = FONT_ATLAS_DEFAULT_SIZE;
+    new_atlas.packer.reset(new_atlas.width, new_atlas.height);
     engine_context->get_debugger()->log(DebugLevel::INFO,
                                         std::string("Creating new font atlas of size ") +
                                             std::to_string(new_atlas.width) + "x" +
                                             std::to_string(new_atlas.height),
                                         __FILE__, __LINE__);
 
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     glGenTextures(1, &new_atlas.texture_id);
     glBindTexture(GL_TEXTURE_2D, new_atlas.texture_id);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, new_atlas.width, new_atlas.height, 0, GL_RED,
@@ -139,7 +498,6 @@ bool Font::createNewAtlas() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     glBindTexture(GL_TEXTURE_2D, 0);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
     if (glGetError() != GL_NO_ERROR) {
         engine_context->get_debugger()->log(
@@ -153,69 +511,222 @@ bool Font::createNewAtlas() {
     return true;
 }
 
-bool Font::initBuffers() {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(float) * 4, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    return (glGetError() == GL_NO_ERROR);
-}
+void Font::preloadGlyphs(const std::vector<Charcode>& charcodes) {
+    if (!face || atlases.empty()) return;
+
+    std::vector<Charcode> missing;
+    for (Charcode charcode : charcodes) {
+        if (characters.find(charcode) == characters.end()) missing.push_back(charcode);
+    }
+    std::sort(missing.begin(), missing.end());
+    missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+    if (missing.empty()) return;
+
+    std::vector<GlyphBitmap> glyphs(missing.size());
+
+    unsigned int worker_count = backgroundWorkerCount();
+
+    if (worker_count <= 1 || missing.size() < FONT_PRELOAD_MIN_THREADED) {
+        for (size_t i = 0; i < missing.size(); i++) {
+            glyphs[i].valid = renderGlyph(face, render_mode, missing[i], glyphs[i]);
+        }
+    } else {
+        // FT_Library and FT_Face arent thread safe, every worker opens its own. glyphs are
+        // handed out one at a time since cjk outlines vary a lot in cost
+        std::atomic<size_t> next_glyph{0};
+        auto work = [&]() {
+            FT_Library worker_ft;
+            if (FT_Init_FreeType(&worker_ft)) return;
+
+            FT_Face worker_face;
+            if (FT_New_Face(worker_ft, path.c_str(), 0, &worker_face) ||
+                FT_Set_Char_Size(worker_face, 0, size_pt * 64, 96, 96)) {
+                FT_Done_FreeType(worker_ft);
+                return;
+            }
+
+            for (size_t i = next_glyph++; i < missing.size(); i = next_glyph++) {
+                glyphs[i].valid = renderGlyph(worker_face, render_mode, missing[i], glyphs[i]);
+            }
+
+            FT_Done_Face(worker_face);
+            FT_Done_FreeType(worker_ft);
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned int i = 0; i < worker_count; i++) {
+            workers.emplace_back(work);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
 
-bool Font::loadGlyph(Charcode charcode) {
-    if (!face || atlases.empty()) return false;
+    // one upload pass for the whole batch
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t i = 0; i < glyphs.size(); i++) {
+        if (glyphs[i].valid && !addGlyph(glyphs[i])) break;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
+    glyph_generation++;
+}
+
+bool Font::renderGlyph(FT_Face face, FontRenderMode render_mode, Charcode charcode,
+                       GlyphBitmap& out_glyph) {
     if (FT_Load_Char(face, charcode, FT_LOAD_RENDER)) return false;
 
     FT_GlyphSlot glyph = face->glyph;
+    const FT_Bitmap& bitmap = glyph->bitmap;
+
+    out_glyph.charcode = charcode;
+    out_glyph.width = bitmap.width;
+    out_glyph.rows = bitmap.rows;
+    out_glyph.left = glyph->bitmap_left;
+    out_glyph.top = glyph->bitmap_top;
+    out_glyph.advance = static_cast<GLuint>(glyph->advance.x >> 6);
+    out_glyph.pixels.resize(static_cast<size_t>(bitmap.width) * bitmap.rows);
+
+    // the pitch can be padded or negative, copy row by row
+    for (unsigned int row = 0; row < bitmap.rows; row++) {
+        std::memcpy(&out_glyph.pixels[static_cast<size_t>(row) * bitmap.width],
+                    bitmap.buffer + static_cast<ptrdiff_t>(row) * bitmap.pitch, bitmap.width);
+    }
 
-    Atlas* current_atlas = nullptr;
-    while (true) {
-        current_atlas = &atlases.back();
+    if (render_mode == FontRenderMode::SDF && bitmap.width > 0 && bitmap.rows > 0) {
+        buildDistanceField(out_glyph.width, out_glyph.rows, out_glyph.pixels);
+        out_glyph.left -= FONT_SDF_SPREAD;
+        out_glyph.top += FONT_SDF_SPREAD;
+    }
 
-        if (current_atlas->current_x + glyph->bitmap.width + 1 >= current_atlas->width) {
-            current_atlas->current_y += current_atlas->max_row_height + 1;
-            current_atlas->current_x = 0;
-            current_atlas->max_row_height = 0;
-        }
+    return true;
+}
 
-        if (current_atlas->current_y + glyph->bitmap.rows + 1 < current_atlas->height) {
-            break;
+// expects GL_UNPACK_ALIGNMENT 1, leaves an atlas bound
+bool Font::addGlyph(const GlyphBitmap& glyph) {
+    int page = 0;
+    glm::ivec2 position(0);
+
+    // spaces and other empty glyphs only need their metrics
+    if (glyph.width > 0 && glyph.rows > 0) {
+        // a pixel of gap on the left and top keeps filtering from bleeding into neighbours
+        int packed_width = static_cast<int>(glyph.width) + 1;
+        int packed_height = static_cast<int>(glyph.rows) + 1;
+
+        bool packed = false;
+        for (size_t i = 0; i < atlases.size() && !packed; i++) {
+            packed = atlases[i].packer.pack(packed_width, packed_height, position);
+            if (packed) page = static_cast<int>(i);
         }
-
-        if (!createNewAtlas()) {
+        if (!packed && atlases.size() < max_atlas_pages && createNewAtlas()) {
+            page = static_cast<int>(atlases.size()) - 1;
+            packed = atlases[page].packer.pack(packed_width, packed_height, position);
+        }
+        if (!packed && !evictForGlyph(packed_width, packed_height, page, position)) {
             return false;
         }
+        position.x += 1;
+        position.y += 1;
+
+        glBindTexture(GL_TEXTURE_2D, atlases[page].texture_id);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y, glyph.width, glyph.rows, GL_RED,
+                        GL_UNSIGNED_BYTE, glyph.pixels.data());
+    }
+
+    const Atlas& atlas = atlases[page];
+    Character character = {atlas.texture_id,
+                           glm::ivec2(glyph.width, glyph.rows),
+                           glm::ivec2(glyph.left, glyph.top),
+                           glyph.advance,
+                           glm::vec2((float)position.x / atlas.width,
+                                     (float)position.y / atlas.height),
+                           glm::vec2((float)glyph.width / atlas.width,
+                                     (float)glyph.rows / atlas.height)};
+    character.page = page;
+    character.atlas_position = position;
+    character.last_used = frame_index;
+    characters.insert({glyph.charcode, character});
+
+    return true;
+}
+
+bool Font::evictForGlyph(int width, int height, int& out_page, glm::ivec2& out_position) {
+    if (eviction_frame != frame_index) {
+        eviction_candidates.clear();
+        for (const auto& [charcode, character] : characters) {
+            if (character.reference_count <= 0 && character.size.x > 0 && character.size.y > 0) {
+                eviction_candidates.emplace_back(character.last_used, charcode);
+            }
+        }
+        std::sort(eviction_candidates.begin(), eviction_candidates.end());
+        eviction_frame = frame_index;
     }
 
-    if (glyph->bitmap.width > 0 && glyph->bitmap.rows > 0) {
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        glBindTexture(GL_TEXTURE_2D, current_atlas->texture_id);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, current_atlas->current_x, current_atlas->current_y,
-                        glyph->bitmap.width, glyph->bitmap.rows, GL_RED, GL_UNSIGNED_BYTE,
-                        glyph->bitmap.buffer);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // walks the list once, moving the entries worth keeping down over the dropped ones
+    size_t kept = 0;
+    size_t i = 0;
+    bool found = false;
+    while (i < eviction_candidates.size() && !found) {
+        auto candidate = eviction_candidates[i++];
+        auto [last_used, charcode] = candidate;
+
+        // the list can be a few glyphs old, drop anything used or retained since
+        auto it = characters.find(charcode);
+        if (it == characters.end() || it->second.reference_count > 0 ||
+            it->second.last_used != last_used) {
+            continue;
+        }
+
+        // only glyphs on a shelf the new one fits on free anything useful
+        const Character& victim = it->second;
+        int page = victim.page;
+        glm::ivec2 position(victim.atlas_position.x - 1, victim.atlas_position.y - 1);
+        if (atlases[page].packer.getShelfHeight(position.y) < height) {
+            eviction_candidates[kept++] = candidate;
+            continue;
+        }
+
+        int victim_width = victim.size.x + 1;
+        int victim_height = victim.size.y + 1;
+
+        atlases[page].packer.release(position, victim_width, victim_height);
+        characters.erase(it);
+        evictions++;
+
+        // wipe it, whatever takes the space next may not cover all of it
+        size_t victim_size = static_cast<size_t>(victim_width) * victim_height;
+        if (clear_pixels.size() < victim_size) clear_pixels.resize(victim_size, 0);
+        glBindTexture(GL_TEXTURE_2D, atlases[page].texture_id);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y, victim_width, victim_height,
+                        GL_RED, GL_UNSIGNED_BYTE, clear_pixels.data());
+
+        if (atlases[page].packer.pack(width, height, out_position)) {
+            out_page = page;
+            found = true;
+        }
     }
 
-    Character character = {current_atlas->texture_id,
-                           glm::ivec2(glyph->bitmap.width, glyph->bitmap.rows),
-                           glm::ivec2(glyph->bitmap_left, glyph->bitmap_top),
-                           static_cast<GLuint>(glyph->advance.x >> 6),
-                           glm::vec2((float)current_atlas->current_x / current_atlas->width,
-                                     (float)current_atlas->current_y / current_atlas->height),
-                           glm::vec2((float)glyph->bitmap.width / current_atlas->width,
-                                     (float)glyph->bitmap.rows / current_atlas->height)};
-    characters.insert({charcode, character});
+    // whatever wasnt looked at stays, behind the kept ones
+    auto end = std::move(eviction_candidates.begin() + i, eviction_candidates.end(),
+                         eviction_candidates.begin() + kept);
+    eviction_candidates.erase(end, eviction_candidates.end());
+    return found;
+}
 
-    current_atlas->current_x += glyph->bitmap.width + 1;
-    current_atlas->max_row_height = std::max(current_atlas->max_row_height, glyph->bitmap.rows);
+FontAtlasStats Font::getAtlasStats() const {
+    FontAtlasStats stats;
+    stats.pages = atlases.size();
+    stats.max_pages = max_atlas_pages;
+    stats.glyphs = characters.size();
+    stats.evictions = evictions;
 
-    return true;
+    for (const auto& atlas : atlases) {
+        stats.occupancy += atlas.packer.getOccupancy();
+    }
+    if (!atlases.empty()) stats.occupancy /= atlases.size();
+
+    return stats;
 }
 
 }  // namespace vsrg
\ No newline at end of file
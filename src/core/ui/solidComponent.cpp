@@ -32,7 +32,8 @@ const char *color_frag_shader = R"glsl(
 
     void main()
     {
-        frag_color = vec4(color.rgb, color.a * opacity);
+        float alpha = color.a * opacity;
+        frag_color = vec4(color.rgb * alpha, alpha);
     }
 )glsl";
 
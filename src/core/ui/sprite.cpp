@@ -1,6 +1,8 @@
 #include "core/ui/sprite.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -10,17 +12,21 @@
 
 namespace vsrg {
 
+// half float bit patterns for the default full texture uvs
+constexpr uint16_t HALF_ZERO = 0x0000;
+constexpr uint16_t HALF_ONE = 0x3C00;
+
 const char *batch_vertex_shader = R"glsl(
     #version 330 core
     layout (location = 0) in vec2 position;
     layout (location = 1) in vec2 tex_coords;
     layout (location = 2) in float opacity;
-    layout (location = 3) in float z_order;
     
     out vec2 v_tex_coords;
     out float v_opacity;
     
     uniform mat4 projection;
+    uniform float z_order;
     
     void main() {
         gl_Position = projection * vec4(position, z_order, 1.0);
@@ -39,8 +45,45 @@ const char *batch_fragment_shader = R"glsl(
     uniform sampler2D sprite_texture;
     
     void main() {
-        vec4 sampled = texture(sprite_texture, v_tex_coords);
-        frag_color = vec4(sampled.rgb, sampled.a * v_opacity);
+        // textures are premultiplied, so opacity scales every channel
+        frag_color = texture(sprite_texture, v_tex_coords) * v_opacity;
+    }
+)glsl";
+
+// quads are built from gl_VertexID, corners are in the same order as the batched path
+const char *instanced_vertex_shader = R"glsl(
+    #version 330 core
+    layout (location = 0) in vec2 origin;
+    layout (location = 1) in vec2 size;
+    layout (location = 2) in vec4 uv_rect;
+    layout (location = 3) in float rotation;
+    layout (location = 4) in float opacity;
+    
+    out vec2 v_tex_coords;
+    out float v_opacity;
+    
+    uniform mat4 projection;
+    uniform float z_order;
+    
+    const vec2 corners[4] = vec2[4](vec2(0.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0));
+    const int indices[6] = int[6](0, 1, 2, 0, 2, 3);
+    
+    void main() {
+        vec2 corner = corners[indices[gl_VertexID]];
+        vec2 local = corner * size;
+    
+        float c = 1.0;
+        float s = 0.0;
+        if (rotation != 0.0) {
+            c = cos(rotation);
+            s = sin(rotation);
+        }
+    
+        vec2 position = origin + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+    
+        gl_Position = projection * vec4(position, z_order, 1.0);
+        v_tex_coords = mix(uv_rect.xy, uv_rect.zw, corner);
+        v_opacity = opacity;
     }
 )glsl";
 
@@ -55,7 +98,9 @@ SpriteRenderer::SpriteRenderer(EngineContext *engine_context) : engine_context(e
 SpriteRenderer::~SpriteRenderer() {
     if (shader_program) glDeleteProgram(shader_program);
     if (vao) glDeleteVertexArrays(1, &vao);
-    if (vbo) glDeleteBuffers(1, &vbo);
+    if (index_buffer) glDeleteBuffers(1, &index_buffer);
+    if (instanced_program) glDeleteProgram(instanced_program);
+    if (instanced_vao) glDeleteVertexArrays(1, &instanced_vao);
 }
 
 void SpriteRenderer::setupShader() {
@@ -64,17 +109,42 @@ void SpriteRenderer::setupShader() {
 
     projection_uniform = glGetUniformLocation(shader_program, "projection");
     texture_uniform = glGetUniformLocation(shader_program, "sprite_texture");
+    z_order_uniform = glGetUniformLocation(shader_program, "z_order");
+
+    instanced_program =
+        createShaderProgram(engine_context, instanced_vertex_shader, batch_fragment_shader);
+
+    instanced_projection_uniform = glGetUniformLocation(instanced_program, "projection");
+    instanced_texture_uniform = glGetUniformLocation(instanced_program, "sprite_texture");
+    instanced_z_order_uniform = glGetUniformLocation(instanced_program, "z_order");
 }
 
 void SpriteRenderer::setupBuffers() {
+    vertex_stream =
+        std::make_unique<StreamBuffer>(engine_context, GL_ARRAY_BUFFER, STREAM_CHUNK_SIZE, 3);
+
+    // every quad uses the same two triangles, so the indices never change
+    std::vector<uint16_t> indices(MAX_BATCH_SIZE * 6);
+    for (size_t i = 0; i < MAX_BATCH_SIZE; i++) {
+        uint16_t base = (uint16_t)(i * 4);
+        indices[i * 6 + 0] = base + 0;
+        indices[i * 6 + 1] = base + 1;
+        indices[i * 6 + 2] = base + 2;
+        indices[i * 6 + 3] = base + 0;
+        indices[i * 6 + 4] = base + 2;
+        indices[i * 6 + 5] = base + 3;
+    }
+
     glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
 
     glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-    glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteVertex) * 6 * MAX_BATCH_SIZE, nullptr,
-                 GL_DYNAMIC_DRAW);
+    glGenBuffers(1, &index_buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(),
+                 GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_stream->getBuffer());
 
     // position
     glEnableVertexAttribArray(0);
@@ -83,205 +153,277 @@ void SpriteRenderer::setupBuffers() {
 
     // tex_coords
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex),
+    glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(SpriteVertex),
                           (void *)offsetof(SpriteVertex, tex_coords));
 
     // opacity
     glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex),
+    glVertexAttribPointer(2, 1, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteVertex),
                           (void *)offsetof(SpriteVertex, opacity));
 
-    // z_order
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex),
-                          (void *)offsetof(SpriteVertex, z_order));
-
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // instance attributes are pointed at the stream per draw in flush, since gl 3.3 has no base
+    // instance. they all advance once per instance
+    glGenVertexArrays(1, &instanced_vao);
+    glBindVertexArray(instanced_vao);
+    for (GLuint i = 0; i < 5; i++) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribDivisor(i, 1);
+    }
+    glBindVertexArray(0);
 }
 
 void SpriteRenderer::begin() {
-    batches.clear();
+    sort_keys.clear();
+    quad_vertices.clear();
+    quad_instances.clear();
 }
 
-void SpriteRenderer::drawSprite(const std::string &texture_path, const glm::vec2 &position,
+void SpriteRenderer::drawSprite(TextureHandle texture, const glm::vec2 &position,
                                 const glm::vec2 &size, float rotation, const glm::vec2 &anchor,
                                 const glm::vec2 &scale, float opacity, int layer) {
-    auto *cached_texture = engine_context->get_texture_cache()->getTexture(texture_path);
-    if (!cached_texture || !cached_texture->loaded || !cached_texture->texture_id) {
-        return;
-    }
-
-    SpriteBatch *batch = getBatch(cached_texture->texture_id, layer);
-
-    if (batch->sprite_count >= MAX_BATCH_SIZE) {
-        flush();
-        batch = getBatch(cached_texture->texture_id, layer);
-    }
-
-    glm::vec2 scaled_size = size * scale;
-    glm::vec2 anchor_offset = scaled_size * anchor;
-
-    glm::mat4 transform = glm::mat4(1.0f);
-    transform = glm::translate(transform, glm::vec3(position, 0.0f));
-    transform = glm::translate(transform, glm::vec3(-anchor_offset, 0.0f));
-
-    if (rotation != 0.0f) {
-        transform = glm::rotate(transform, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
-    }
-
-    if (scale != glm::vec2(1.0f)) {
-        transform = glm::scale(transform, glm::vec3(scale, 1.0f));
-    }
-
-    glm::vec4 corners[4] = {transform * glm::vec4(0.0f, size.y, 0.0f, 1.0f),
-                            transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
-                            transform * glm::vec4(size.x, 0.0f, 0.0f, 1.0f),
-                            transform * glm::vec4(size.x, size.y, 0.0f, 1.0f)};
-
-    glm::vec2 tex_coords[4] = {{0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}};
-
-    float z_value = layer * 0.1f;  // Calculate z from layer (higher layer = closer to camera)
-
-    batch->vertices.push_back({glm::vec2(corners[0]), tex_coords[0], opacity, z_value});
-    batch->vertices.push_back({glm::vec2(corners[1]), tex_coords[1], opacity, z_value});
-    batch->vertices.push_back({glm::vec2(corners[2]), tex_coords[2], opacity, z_value});
-
-    batch->vertices.push_back({glm::vec2(corners[0]), tex_coords[0], opacity, z_value});
-    batch->vertices.push_back({glm::vec2(corners[2]), tex_coords[2], opacity, z_value});
-    batch->vertices.push_back({glm::vec2(corners[3]), tex_coords[3], opacity, z_value});
-
-    batch->sprite_count++;
+    pushQuad(texture, position, size, nullptr, rotation, anchor, scale, opacity, layer);
 }
 
-void SpriteRenderer::drawSprite(const std::string &texture_path, const glm::vec2 &position,
+void SpriteRenderer::drawSprite(TextureHandle texture, const glm::vec2 &position,
                                 const glm::vec2 &size, const glm::vec4 &uv_rect, float rotation,
                                 const glm::vec2 &anchor, const glm::vec2 &scale, float opacity,
                                 int layer) {
-    auto *cached_texture = engine_context->get_texture_cache()->getTexture(texture_path);
-    if (!cached_texture || !cached_texture->loaded || !cached_texture->texture_id) {
+    pushQuad(texture, position, size, &uv_rect, rotation, anchor, scale, opacity, layer);
+}
+
+void SpriteRenderer::pushQuad(TextureHandle texture, const glm::vec2 &position,
+                              const glm::vec2 &size, const glm::vec4 *uv_rect, float rotation,
+                              const glm::vec2 &anchor, const glm::vec2 &scale, float opacity,
+                              int layer) {
+    // textures still loading in the background draw as their (invisible) placeholder
+    auto *cached_texture = engine_context->get_texture_cache()->getTexture(texture, false);
+    if (!cached_texture || !cached_texture->texture_id ||
+        (!cached_texture->loaded && !cached_texture->pending)) {
         return;
     }
 
-    SpriteBatch *batch = getBatch(cached_texture->texture_id, layer);
-
-    if (batch->sprite_count >= MAX_BATCH_SIZE) {
-        flush();
-        batch = getBatch(cached_texture->texture_id, layer);
+    if (sort_keys.size() > MAX_SEQUENCE) flush();
+
+    // layers are biased so negative ones still sort first
+    uint64_t layer_bits = (uint64_t)(std::clamp(layer, -32768, 32767) + 32768);
+    uint64_t texture_bits = cached_texture->texture_id & 0xFFFFFF;  // gl names stay small
+    sort_keys.push_back((layer_bits << 48) | (texture_bits << 24) | sort_keys.size());
+
+    // uv rect is x, y, width, height (normalized 0-1) relative to the image, v = 0 is the top
+    // row. atlased textures move it into their spot on the page
+    uint16_t u1 = HALF_ZERO, v1 = HALF_ZERO, u2 = HALF_ONE, v2 = HALF_ONE;
+    if (uv_rect || cached_texture->atlas_page >= 0) {
+        glm::vec4 rect = uv_rect ? *uv_rect : glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        const glm::vec4 &image = cached_texture->uv_rect;
+
+        uint32_t u = glm::packHalf2x16(glm::vec2(image.x + rect.x * image.z,
+                                                 image.x + (rect.x + rect.z) * image.z));
+        uint32_t v = glm::packHalf2x16(glm::vec2(image.y + rect.y * image.w,
+                                                 image.y + (rect.y + rect.w) * image.w));
+        u1 = u & 0xFFFF;
+        u2 = u >> 16;
+        v1 = v & 0xFFFF;
+        v2 = v >> 16;
     }
 
     glm::vec2 scaled_size = size * scale;
-    glm::vec2 anchor_offset = scaled_size * anchor;
+    glm::vec2 origin = position - scaled_size * anchor;
 
-    glm::mat4 transform = glm::mat4(1.0f);
-    transform = glm::translate(transform, glm::vec3(position, 0.0f));
-    transform = glm::translate(transform, glm::vec3(-anchor_offset, 0.0f));
+    uint8_t packed_opacity = (uint8_t)(std::clamp(opacity, 0.0f, 1.0f) * 255.0f + 0.5f);
 
-    if (rotation != 0.0f) {
-        transform = glm::rotate(transform, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+    if (backend == SpriteBackend::INSTANCED) {
+        // the vertex shader does the rest
+        quad_instances.push_back({origin, scaled_size, {u1, v1, u2, v2},
+                                  glm::radians(rotation), packed_opacity, {}});
+        return;
     }
 
-    if (scale != glm::vec2(1.0f)) {
-        transform = glm::scale(transform, glm::vec3(scale, 1.0f));
+    // same as translate(position - anchor) * rotate * scale applied to the quad corners, the
+    // rotation pivots around the origin corner
+    glm::vec2 corners[4];
+    if (rotation == 0.0f) {
+        // axis aligned, which is nearly everything
+        corners[0] = {origin.x, origin.y + scaled_size.y};
+        corners[1] = origin;
+        corners[2] = {origin.x + scaled_size.x, origin.y};
+        corners[3] = origin + scaled_size;
+    } else {
+        float radians = glm::radians(rotation);
+        float c = std::cos(radians);
+        float s = std::sin(radians);
+
+        glm::vec2 axis_x(c * scaled_size.x, s * scaled_size.x);
+        glm::vec2 axis_y(-s * scaled_size.y, c * scaled_size.y);
+
+        corners[0] = origin + axis_y;
+        corners[1] = origin;
+        corners[2] = origin + axis_x;
+        corners[3] = origin + axis_x + axis_y;
     }
 
-    glm::vec4 corners[4] = {transform * glm::vec4(0.0f, size.y, 0.0f, 1.0f),
-                            transform * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),
-                            transform * glm::vec4(size.x, 0.0f, 0.0f, 1.0f),
-                            transform * glm::vec4(size.x, size.y, 0.0f, 1.0f)};
+    quad_vertices.push_back({corners[0], {u1, v2}, packed_opacity, {}});
+    quad_vertices.push_back({corners[1], {u1, v1}, packed_opacity, {}});
+    quad_vertices.push_back({corners[2], {u2, v1}, packed_opacity, {}});
+    quad_vertices.push_back({corners[3], {u2, v2}, packed_opacity, {}});
+}
 
-    // UV Rect: x, y, width, height (normalized 0-1)
-    // Standard (0,0,1,1) maps to:
-    // TL: {0,1}, BL: {0,0}, BR: {1,0}, TR: {1,1}
-    // This seems inverted Y? OpenGL 0,0 is usually Bottom-Left.
-    // In previous drawSprite:
-    // corners[0] (0, size.y) -> tex_coords[0] {0.0f, 1.0f} (Top-Left geometry ->
-    // Top-Left UV?) corners[1] (0, 0)      -> tex_coords[1] {0.0f, 0.0f}
-    // (Bottom-Left geometry -> Bottom-Left UV) So Y=0 is Bottom. Y=1 is Top in
-    // UVs.
+void SpriteRenderer::end() {
+    flush();
+}
 
-    float u1 = uv_rect.x;
-    float v1 = uv_rect.y;
-    float u2 = uv_rect.x + uv_rect.z;
-    float v2 = uv_rect.y + uv_rect.w;
+void SpriteRenderer::sortKeys() {
+    // lsd radix sort, 8 bits a pass. keys are pushed in sequence order and every pass is stable,
+    // so the sequence bits never need sorting. passes where every key has the same digit
+    // (usually most of the layer and texture bytes) are skipped too
+    constexpr int FIRST_SHIFT = 24;
+    constexpr int PASSES = (64 - FIRST_SHIFT) / 8;
 
-    glm::vec2 tex_coords[4] = {{u1, v2}, {u1, v1}, {u2, v1}, {u2, v2}};
+    size_t count = sort_keys.size();
+    sort_scratch.resize(count);
 
-    float z_value = layer * 0.1f;
+    size_t histograms[PASSES][256] = {};
+    for (uint64_t key : sort_keys) {
+        for (int pass = 0; pass < PASSES; pass++) {
+            histograms[pass][(key >> (FIRST_SHIFT + pass * 8)) & 0xFF]++;
+        }
+    }
 
-    batch->vertices.push_back({glm::vec2(corners[0]), tex_coords[0], opacity, z_value});
-    batch->vertices.push_back({glm::vec2(corners[1]), tex_coords[1], opacity, z_value});
-    batch->vertices.push_back({glm::vec2(corners[2]), tex_coords[2], opacity, z_value});
+    for (int pass = 0; pass < PASSES; pass++) {
+        int shift = FIRST_SHIFT + pass * 8;
+        size_t *histogram = histograms[pass];
+        if (histogram[(sort_keys[0] >> shift) & 0xFF] == count) continue;
 
-    batch->vertices.push_back({glm::vec2(corners[0]), tex_coords[0], opacity, z_value});
-    batch->vertices.push_back({glm::vec2(corners[2]), tex_coords[2], opacity, z_value});
-    batch->vertices.push_back({glm::vec2(corners[3]), tex_coords[3], opacity, z_value});
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            size_t digit_count = histogram[digit];
+            histogram[digit] = offset;
+            offset += digit_count;
+        }
 
-    batch->sprite_count++;
-}
+        for (uint64_t key : sort_keys) {
+            sort_scratch[histogram[(key >> shift) & 0xFF]++] = key;
+        }
 
-void SpriteRenderer::end() {
-    flush();
+        sort_keys.swap(sort_scratch);
+    }
 }
 
 void SpriteRenderer::flush() {
-    if (batches.empty()) return;
+    if (sort_keys.empty()) return;
+
+    sortKeys();
 
-    std::sort(batches.begin(), batches.end(),
-              [](const SpriteBatch &a, const SpriteBatch &b) { return a.layer < b.layer; });
+    bool instanced = backend == SpriteBackend::INSTANCED;
+    GLint z_uniform = instanced ? instanced_z_order_uniform : z_order_uniform;
 
-    glUseProgram(shader_program);
+    glUseProgram(instanced ? instanced_program : shader_program);
 
     glm::mat4 projection = glm::ortho(0.0f, (float)engine_context->get_screen_width(),
                                       (float)engine_context->get_screen_height(), 0.0f);
-    glUniformMatrix4fv(projection_uniform, 1, GL_FALSE, glm::value_ptr(projection));
+    glUniformMatrix4fv(instanced ? instanced_projection_uniform : projection_uniform, 1,
+                       GL_FALSE, glm::value_ptr(projection));
 
-    glBindVertexArray(vao);
+    glBindVertexArray(instanced ? instanced_vao : vao);
     glActiveTexture(GL_TEXTURE0);
-    glUniform1i(texture_uniform, 0);
+    glUniform1i(instanced ? instanced_texture_uniform : texture_uniform, 0);
+
+    if (instanced) glBindBuffer(GL_ARRAY_BUFFER, vertex_stream->getBuffer());
 
-    // render each batch
-    for (auto &batch : batches) {
-        if (batch.vertices.empty()) continue;
+    size_t sprite_size = instanced ? sizeof(SpriteInstance) : sizeof(SpriteVertex) * 4;
+    const unsigned char *quad_data =
+        instanced ? (const unsigned char *)quad_instances.data()
+                  : (const unsigned char *)quad_vertices.data();
 
-        glBindTexture(GL_TEXTURE_2D, batch.texture_id);
+    // sorted keys with the same layer and texture are one batch, split at MAX_BATCH_SIZE
+    size_t count = sort_keys.size();
+    for (size_t start = 0; start < count;) {
+        uint64_t batch_bits = sort_keys[start] >> 24;
 
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(SpriteVertex) * batch.vertices.size(),
-                        batch.vertices.data());
+        size_t end = start + 1;
+        while (end < count && end - start < MAX_BATCH_SIZE &&
+               (sort_keys[end] >> 24) == batch_bits) {
+            end++;
+        }
 
-        glDrawArrays(GL_TRIANGLES, 0, batch.vertices.size());
+        GLuint texture_id = (GLuint)(batch_bits & 0xFFFFFF);
+        int layer = (int)(batch_bits >> 24) - 32768;
+        size_t sprite_count = end - start;
+
+        // gather the batch straight into the stream, no glBufferSubData stall on the last draw
+        size_t offset;
+        auto *dst = (unsigned char *)vertex_stream->map(sprite_count * sprite_size, offset);
+        if (!dst) {
+            start = end;
+            continue;
+        }
+
+        for (size_t i = start; i < end; i++) {
+            size_t sequence = sort_keys[i] & MAX_SEQUENCE;
+            std::memcpy(dst, quad_data + sequence * sprite_size, sprite_size);
+            dst += sprite_size;
+        }
+        vertex_stream->unmap();
+
+        glBindTexture(GL_TEXTURE_2D, texture_id);
+        glUniform1f(z_uniform, layer * 0.1f);  // higher layer = closer to camera
+
+        if (instanced) {
+            auto attrib = [offset](size_t member) { return (void *)(offset + member); };
+
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                                  attrib(offsetof(SpriteInstance, origin)));
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                                  attrib(offsetof(SpriteInstance, size)));
+            glVertexAttribPointer(2, 4, GL_HALF_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                                  attrib(offsetof(SpriteInstance, uv_rect)));
+            glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+                                  attrib(offsetof(SpriteInstance, rotation)));
+            glVertexAttribPointer(4, 1, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteInstance),
+                                  attrib(offsetof(SpriteInstance, opacity)));
+
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)sprite_count);
+        } else {
+            GLint base_vertex = (GLint)(offset / sizeof(SpriteVertex));
+            glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(sprite_count * 6), GL_UNSIGNED_SHORT,
+                                     nullptr, base_vertex);
+        }
+
+        start = end;
     }
 
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
     glUseProgram(0);
 
-    batches.clear();
+    sort_keys.clear();
+    quad_vertices.clear();
+    quad_instances.clear();
 }
 
-SpriteBatch *SpriteRenderer::getBatch(GLuint texture_id, int layer) {
-    for (auto &batch : batches) {
-        if (batch.texture_id == texture_id && batch.layer == layer &&
-            batch.sprite_count < MAX_BATCH_SIZE) {
-            return &batch;
-        }
-    }
+void SpriteRenderer::setBackend(SpriteBackend new_backend) {
+    if (new_backend == backend) return;
+
+    flush();
+    backend = new_backend;
 
-    // create new batch
-    SpriteBatch new_batch;
-    new_batch.texture_id = texture_id;
-    new_batch.layer = layer;
-    batches.push_back(new_batch);
-    return &batches.back();
+    engine_context->get_debugger()->log(
+        DebugLevel::INFO,
+        std::string("Sprite backend set to ") +
+            (backend == SpriteBackend::INSTANCED ? "instanced" : "batched"),
+        __FILE__, __LINE__);
 }
 
-void SpriteRenderer::drawSpriteImmediate(const std::string &texture_path, const glm::vec2 &position,
+void SpriteRenderer::drawSpriteImmediate(TextureHandle texture, const glm::vec2 &position,
                                          const glm::vec2 &size, float rotation,
                                          const glm::vec2 &anchor, const glm::vec2 &scale,
                                          float opacity, int layer) {
     begin();
-    drawSprite(texture_path, position, size, rotation, anchor, scale, opacity, layer);
+    drawSprite(texture, position, size, rotation, anchor, scale, opacity, layer);
     end();
 }
 
@@ -5,11 +5,24 @@
 
 namespace vsrg {
 
-SpriteComponent::SpriteComponent(EngineContext *engine_context, const std::string &spritePath)
+SpriteComponent::SpriteComponent(EngineContext *engine_context, const std::string &spritePath,
+                                 bool load_async)
     : UIComponent(engine_context), texture_path(spritePath) {
-    auto *cached_texture = engine_context->get_texture_cache()->getTexture(spritePath);
+    TextureCache *texture_cache = engine_context->get_texture_cache();
+    texture_handle = texture_cache->getHandle(spritePath);
+
+    if (load_async) {
+        request = texture_cache->loadTextureAsync(spritePath);
+        texture_ref = TextureRef(texture_cache, spritePath);
+        dimensions = glm::vec2(0.0f);
+        checkRequest();
+        return;
+    }
+
+    auto *cached_texture = texture_cache->getTexture(texture_handle);
 
     if (cached_texture && cached_texture->loaded) {
+        texture_ref = TextureRef(texture_cache, spritePath);
         dimensions = glm::vec2(cached_texture->dimensions);
         loaded = true;
     } else {
@@ -24,6 +37,28 @@ SpriteComponent::SpriteComponent(EngineContext *engine_context, const std::strin
 
 SpriteComponent::~SpriteComponent() {}
 
+void SpriteComponent::checkRequest() {
+    if (!request.isReady()) return;
+
+    if (!request.failed()) {
+        auto *cached_texture =
+            engine_context->get_texture_cache()->getTexture(texture_handle, false);
+        if (cached_texture && cached_texture->loaded) {
+            dimensions = glm::vec2(cached_texture->dimensions);
+            loaded = true;
+        }
+    }
+
+    if (!loaded) {
+        engine_context->get_debugger()->log(
+            DebugLevel::ERROR,
+            std::string("Failed to create sprite component - texture not found: ") + texture_path,
+            __FILE__, __LINE__);
+    }
+
+    request = TextureRequest();
+}
+
 glm::vec2 SpriteComponent::getSize() const {
     // If no render_size is set, use original texture dimensions
     if (properties.render_size.x <= 0.0f || properties.render_size.y <= 0.0f) {
@@ -69,15 +104,16 @@ glm::vec2 SpriteComponent::getSize() const {
 }
 
 void SpriteComponent::render() {
-    if (!properties.visible) return;
+    if (request.valid()) checkRequest();
+    if (!properties.visible || !loaded) return;
 
     auto *renderer = engine_context->get_sprite_renderer();
     if (properties.use_custom_uv) {
-        renderer->drawSprite(texture_path, properties.position, getSize(), properties.uv_rect,
+        renderer->drawSprite(texture_handle, properties.position, getSize(), properties.uv_rect,
                              properties.rotation, properties.anchor, properties.scale,
                              properties.opacity, properties.layer);
     } else {
-        renderer->drawSprite(texture_path, properties.position, getSize(), properties.rotation,
+        renderer->drawSprite(texture_handle, properties.position, getSize(), properties.rotation,
                              properties.anchor, properties.scale, properties.opacity,
                              properties.layer);
     }
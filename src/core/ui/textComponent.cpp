@@ -1,90 +1,227 @@
 #include "core/ui/textComponent.hpp"
-#include "core/engine/shader.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
 
 #define GLM_FORCE_RADIANS
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VSRG_UTF8_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) ||                                  \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VSRG_UTF8_SSE2
+#endif
+
 namespace vsrg {
+namespace {
+static_assert(sizeof(Charcode) == 4 || sizeof(Charcode) == 8,
+              "the ascii fast path widens bytes to 32 or 64 bits");
+
+// decodes the sequence at s into codepoint and returns the byte after it. a
+// bad lead byte or a missing continuation byte becomes '?' and only skips the
+// lead byte, overlong forms and surrogates are let through
+inline const unsigned char *decodeSequence(const unsigned char *s,
+                                           const unsigned char *end,
+                                           Charcode &codepoint) {
+  unsigned char c = *s++;
+
+  if (c < 0x80) {
+    codepoint = c;
+  } else if ((c & 0xE0) == 0xC0) {
+    if (s < end && (*s & 0xC0) == 0x80) {
+      codepoint = ((c & 0x1F) << 6) | (*s & 0x3F);
+      s++;
+    } else {
+      codepoint = '?';
+    }
+  } else if ((c & 0xF0) == 0xE0) {
+    if (s + 1 < end && (*s & 0xC0) == 0x80 && (*(s + 1) & 0xC0) == 0x80) {
+      codepoint = ((c & 0x0F) << 12) | ((*s & 0x3F) << 6) | (*(s + 1) & 0x3F);
+      s += 2;
+    } else {
+      codepoint = '?';
+    }
+  } else if ((c & 0xF8) == 0xF0) {
+    if (s + 2 < end && (*s & 0xC0) == 0x80 && (*(s + 1) & 0xC0) == 0x80 &&
+        (*(s + 2) & 0xC0) == 0x80) {
+      codepoint = ((c & 0x07) << 18) | ((*s & 0x3F) << 12) |
+                  ((*(s + 1) & 0x3F) << 6) | (*(s + 2) & 0x3F);
+      s += 3;
+    } else {
+      codepoint = '?';
+    }
+  } else {
+    codepoint = '?';
+  }
+  return s;
+}
 
-const char *vertex_shader_source = R"glsl(
-    #version 330 core
-    layout (location = 0) in vec4 vertex; // vec2 pos, vec2 tex
-    out vec2 texture_coords;
+#if defined(VSRG_UTF8_AVX2)
+const size_t UTF8_BLOCK_SIZE = 32;
 
-    uniform mat4 projection;
-    uniform float z_order;
+// bit i is set if byte i of the block isnt ascii
+inline unsigned int nonASCIIMask(const unsigned char *s) {
+  __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s));
+  return static_cast<unsigned int>(_mm256_movemask_epi8(bytes));
+}
 
-    void main()
-    {
-        gl_Position = projection * vec4(vertex.xy, z_order, 1.0);
-        texture_coords = vertex.zw;
+// zero extends a block of ascii bytes into charcodes
+inline void widenASCII(const unsigned char *s, Charcode *out) {
+  if constexpr (sizeof(Charcode) == 4) {
+    for (size_t i = 0; i < UTF8_BLOCK_SIZE; i += 8) {
+      __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(s + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                          _mm256_cvtepu8_epi32(bytes));
+    }
+  } else {
+    for (size_t i = 0; i < UTF8_BLOCK_SIZE; i += 16) {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+      for (size_t j = 0; j < 16; j += 4) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i + j),
+                            _mm256_cvtepu8_epi64(bytes));
+        bytes = _mm_srli_si128(bytes, 4);
+      }
     }
-)glsl";
+  }
+}
+#elif defined(VSRG_UTF8_SSE2)
+const size_t UTF8_BLOCK_SIZE = 16;
+
+// bit i is set if byte i of the block isnt ascii
+inline unsigned int nonASCIIMask(const unsigned char *s) {
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+  return static_cast<unsigned int>(_mm_movemask_epi8(bytes));
+}
 
-const char *fragment_shader_source = R"glsl(
-    #version 330 core
-    in vec2 texture_coords;
-    out vec4 texture_color;
+// zero extends a block of ascii bytes into charcodes
+inline void widenASCII(const unsigned char *s, Charcode *out) {
+  __m128i zero = _mm_setzero_si128();
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+  __m128i halves[2] = {_mm_unpacklo_epi8(bytes, zero),
+                       _mm_unpackhi_epi8(bytes, zero)};
 
-    uniform sampler2D atlas;
-    uniform vec3 color;
-	uniform float opacity;
+  for (int i = 0; i < 4; i++) {
+    __m128i words = i % 2 ? _mm_unpackhi_epi16(halves[i / 2], zero)
+                          : _mm_unpacklo_epi16(halves[i / 2], zero);
+    __m128i *dst = reinterpret_cast<__m128i *>(out + i * 4);
 
-    void main()
-    {
-        float alpha = texture(atlas, texture_coords).r;
-        texture_color = vec4(color, alpha * opacity);
+    if constexpr (sizeof(Charcode) == 4) {
+      _mm_storeu_si128(dst, words);
+    } else {
+      _mm_storeu_si128(dst, _mm_unpacklo_epi32(words, zero));
+      _mm_storeu_si128(dst + 1, _mm_unpackhi_epi32(words, zero));
     }
-)glsl";
+  }
+}
+#endif
+} // namespace
+
+TextBuffer &TextBuffer::append(std::string_view text) {
+  size_t count = std::min(text.size(), TEXT_BUFFER_CAPACITY - length);
+  std::memcpy(data + length, text.data(), count);
+  length += count;
+  return *this;
+}
+
+TextBuffer &TextBuffer::appendInt(long long value) {
+  char digits[24];
+  auto result = std::to_chars(digits, digits + sizeof(digits), value);
+  return append(std::string_view(digits, result.ptr - digits));
+}
+
+TextBuffer &TextBuffer::appendFixed(double value, int decimals) {
+  char digits[64];
+  auto result = std::to_chars(digits, digits + sizeof(digits), value,
+                              std::chars_format::fixed, decimals);
+  if (result.ec != std::errc())
+    return append("?");
+  return append(std::string_view(digits, result.ptr - digits));
+}
 
 TextComponent::TextComponent(EngineContext *engine_context, Font *font,
                              const std::string &text,
                              const TextRenderOptions &text_options)
-    : UIComponent(engine_context), font(font), text_options(text_options) {
-  setText(text);
-
-  shader_program = createShaderProgram(engine_context, vertex_shader_source,
-                                       fragment_shader_source);
-  projection_uniform = glGetUniformLocation(shader_program, "projection");
-  atlas_uniform = glGetUniformLocation(shader_program, "atlas");
-  color_uniform = glGetUniformLocation(shader_program, "color");
-  opacity_uniform = glGetUniformLocation(shader_program, "opacity");
-  z_order_uniform = glGetUniformLocation(shader_program, "z_order");
+    : UIComponent(engine_context), font(font), text(text),
+      text_options(text_options) {
+  updateLayout();
 }
 
-TextComponent::~TextComponent() { glDeleteProgram(shader_program); }
+TextComponent::~TextComponent() {
+  engine_context->get_font_manager()->getLayoutCache().release(layout);
+}
 
-void TextComponent::setText(const std::string &text) {
-  std::vector<Charcode> charcodes = decodeUTF8(text);
-  glm::vec2 dimensions = calculateDimensions(charcodes);
-  drawable_string = DrawableString{charcodes, dimensions};
+void TextComponent::setText(std::string_view new_text) {
+  if (new_text == text)
+    return;
+  text.assign(new_text.data(), new_text.size());
+  updateLayout();
 }
 
 void TextComponent::setFont(Font *new_font) {
+  if (new_font == font)
+    return;
   font = new_font;
-  drawable_string.dimensions = calculateDimensions(drawable_string.text);
+  updateLayout();
 }
 
 void TextComponent::setTextOptions(const TextRenderOptions &options) {
+  bool relayout = options.size != text_options.size ||
+                  options.line_gap != text_options.line_gap;
+  // the color is only a uniform
   text_options = options;
-  drawable_string.dimensions = calculateDimensions(drawable_string.text);
+  if (relayout)
+    updateLayout();
+}
+
+void TextComponent::updateLayout() {
+  TextLayoutCache &cache =
+      engine_context->get_font_manager()->getLayoutCache();
+
+  // acquire before releasing, relaying out the same text keeps its glyphs
+  // retained throughout
+  TextLayout *old_layout = layout;
+  layout = nullptr;
+  if (!text.empty() && font != nullptr)
+    layout =
+        cache.acquire(font, text, text_options.size, text_options.line_gap);
+  cache.release(old_layout);
 }
 
 void TextComponent::render() {
-  if (!properties.visible || properties.opacity == 0.0f ||
-      drawable_string.text.empty() || font == nullptr)
+  if (!properties.visible || properties.opacity == 0.0f || layout == nullptr)
+    return;
+
+  // glyphs that were still rendering have landed since the last layout
+  if (layout->waiting_for_glyphs &&
+      font->getGlyphGeneration() != layout->glyph_generation)
+    updateLayout();
+  if (layout->runs.empty())
+    return;
+
+  FontManager *font_manager = engine_context->get_font_manager();
+  GLuint vao = font_manager->getLayoutCache().getVertexArray(layout);
+
+  const TextProgram &program = font_manager->getTextProgram();
+  if (!program.program)
     return;
 
-  glUseProgram(shader_program);
+  glUseProgram(program.program);
 
-  glUniform1f(opacity_uniform, properties.opacity);
-  glUniform3f(color_uniform, text_options.color.x, text_options.color.y,
-              text_options.color.z);
+  glUniform1f(program.opacity_uniform, properties.opacity);
+  glUniform3f(program.color_uniform, text_options.color.x,
+              text_options.color.y, text_options.color.z);
+  glUniform1i(program.sdf_uniform,
+              font->getRenderMode() == FontRenderMode::SDF);
 
   float z_value = -properties.layer * 0.1f;
-  glUniform1f(z_order_uniform, z_value);
+  glUniform1f(program.z_order_uniform, z_value);
 
   glm::vec2 dims = getSize();
   glm::vec2 anchor_offset = dims * properties.anchor;
@@ -108,65 +245,16 @@ void TextComponent::render() {
   }
 
   glm::mat4 final_projection = projection * transform;
-  glUniformMatrix4fv(projection_uniform, 1, GL_FALSE,
+  glUniformMatrix4fv(program.projection_uniform, 1, GL_FALSE,
                      glm::value_ptr(final_projection));
 
   glActiveTexture(GL_TEXTURE0);
-  glUniform1i(atlas_uniform, 0);
-  glBindVertexArray(font->getVAO());
-
-  float current_x = 0.0f;
-  float current_y = 0.0f;
-
-  float scaling_factor = getScalingFactor();
-  float line_height =
-      (font->getSizePt() + text_options.line_gap) * scaling_factor;
-  GLuint last_texture_id = 0;
-
-  for (auto c = drawable_string.text.begin(); c != drawable_string.text.end();
-       c++) {
-    if (*c == '\n') {
-      current_x = 0.0f;
-      current_y += line_height;
-      continue;
-    }
-
-    auto ch = font->getCharacter(*c);
-    if (!ch)
-      continue;
+  glUniform1i(program.atlas_uniform, 0);
+  glBindVertexArray(vao);
 
-    if (ch->texture_id != last_texture_id) {
-      glBindTexture(GL_TEXTURE_2D, ch->texture_id);
-      last_texture_id = ch->texture_id;
-    }
-
-    float xpos = current_x + ch->bearing.x * scaling_factor;
-    float ypos = current_y + (font->getBaselineHeight() - ch->bearing.y +
-                              font->getSizePt()) *
-                                 scaling_factor;
-    float w = ch->size.x * scaling_factor;
-    float h = ch->size.y * scaling_factor;
-
-    float vertices[6][4] = {
-        {xpos, ypos + h, ch->atlas_offset.x,
-         ch->atlas_offset.y + ch->atlas_size_norm.y},
-        {xpos, ypos, ch->atlas_offset.x, ch->atlas_offset.y},
-        {xpos + w, ypos, ch->atlas_offset.x + ch->atlas_size_norm.x,
-         ch->atlas_offset.y},
-        {xpos, ypos + h, ch->atlas_offset.x,
-         ch->atlas_offset.y + ch->atlas_size_norm.y},
-        {xpos + w, ypos, ch->atlas_offset.x + ch->atlas_size_norm.x,
-         ch->atlas_offset.y},
-        {xpos + w, ypos + h, ch->atlas_offset.x + ch->atlas_size_norm.x,
-         ch->atlas_offset.y + ch->atlas_size_norm.y}};
-
-    glBindBuffer(GL_ARRAY_BUFFER, font->getVBO());
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    current_x += ch->advance * scaling_factor;
+  for (const auto &run : layout->runs) {
+    glBindTexture(GL_TEXTURE_2D, run.texture_id);
+    glDrawArrays(GL_TRIANGLES, run.first, run.count);
   }
 
   glBindVertexArray(0);
@@ -174,101 +262,45 @@ void TextComponent::render() {
   glUseProgram(0);
 }
 
-float TextComponent::getScalingFactor() const {
-  if (font == nullptr)
-    return text_options.size;
-  return text_options.size / font->getSizePt();
-}
-
-std::vector<Charcode> TextComponent::decodeUTF8(const std::string &str) {
-  std::vector<FT_ULong> codepoints;
-  const unsigned char *s = reinterpret_cast<const unsigned char *>(str.c_str());
-  const unsigned char *end = s + str.length();
+size_t TextComponent::decodeUTF8(std::string_view str, Charcode *out) {
+  const unsigned char *s = reinterpret_cast<const unsigned char *>(str.data());
+  const unsigned char *end = s + str.size();
+  Charcode *start = out;
 
-  // vibe coded btw don't judge
   while (s < end) {
-    FT_ULong codepoint = 0;
-    unsigned char c = *s++;
-
-    if (c < 0x80) {
-      codepoint = c;
-    } else if ((c & 0xE0) == 0xC0) {
-      if (s < end && (*s & 0xC0) == 0x80) {
-        codepoint = ((c & 0x1F) << 6) | (*s & 0x3F);
-        s++;
-      } else {
-        codepoint = '?';
-      }
-    } else if ((c & 0xF0) == 0xE0) {
-      if (s + 1 < end && (*s & 0xC0) == 0x80 && (*(s + 1) & 0xC0) == 0x80) {
-        codepoint = ((c & 0x0F) << 12) | ((*s & 0x3F) << 6) | (*(s + 1) & 0x3F);
-        s += 2;
-      } else {
-        codepoint = '?';
+#if defined(VSRG_UTF8_AVX2) || defined(VSRG_UTF8_SSE2)
+    if (static_cast<size_t>(end - s) >= UTF8_BLOCK_SIZE) {
+      unsigned int mask = nonASCIIMask(s);
+      if (mask == 0) {
+        widenASCII(s, out);
+        s += UTF8_BLOCK_SIZE;
+        out += UTF8_BLOCK_SIZE;
+        continue;
       }
-    } else if ((c & 0xF8) == 0xF0) {
-      if (s + 2 < end && (*s & 0xC0) == 0x80 && (*(s + 1) & 0xC0) == 0x80 &&
-          (*(s + 2) & 0xC0) == 0x80) {
-        codepoint = ((c & 0x07) << 18) | ((*s & 0x3F) << 12) |
-                    ((*(s + 1) & 0x3F) << 6) | (*(s + 2) & 0x3F);
-        s += 3;
-      } else {
-        codepoint = '?';
-      }
-    } else {
-      codepoint = '?';
-    }
-    codepoints.push_back(codepoint);
-  }
-  return codepoints;
-}
-
-glm::vec2
-TextComponent::calculateDimensions(const std::vector<Charcode> &text) {
-  if (text.empty() || font == nullptr) {
-    return {0, 0};
-  }
-
-  float current_line_width = 0.0f;
-  float max_width = 0.0f;
-  int max_ascent = 0;
-  int min_descent = 0;
-  bool has_visible_glyphs = false;
-  int line_count = 1;
-
-  for (auto c : text) {
-    if (c == '\n') {
-      max_width = std::max(max_width, current_line_width);
-      current_line_width = 0.0f;
-      line_count++;
-      continue;
-    }
-
-    auto ch = font->getCharacter(c);
-    if (!ch)
-      continue;
 
-    current_line_width += ch->advance * getScalingFactor();
-
-    if (ch->size.x > 0 && ch->size.y > 0) {
-      if (!has_visible_glyphs) {
-        max_ascent = ch->bearing.y;
-        min_descent = ch->bearing.y - ch->size.y;
-        has_visible_glyphs = true;
-      } else {
-        max_ascent = std::max(max_ascent, (int)ch->bearing.y);
-        min_descent = std::min(min_descent, (int)(ch->bearing.y - ch->size.y));
-      }
+      // copy the ascii in front of the first sequence, then decode that one
+      for (int i = std::countr_zero(mask); i > 0; i--)
+        *out++ = *s++;
     }
+#endif
+    s = decodeSequence(s, end, *out++);
   }
 
-  max_width = std::max(max_width, current_line_width);
+  return out - start;
+}
 
-  float line_height =
-      (font->getSizePt() + text_options.line_gap) * getScalingFactor();
-  float total_height = line_count * line_height;
+void TextComponent::decodeUTF8(std::string_view str,
+                               std::vector<Charcode> &out) {
+  // never more charcodes than bytes. only grows, shrinking keeps the capacity
+  if (out.size() < str.size())
+    out.resize(str.size());
+  out.resize(decodeUTF8(str, out.data()));
+}
 
-  return {max_width, total_height};
+std::vector<Charcode> TextComponent::decodeUTF8(const std::string &str) {
+  std::vector<Charcode> codepoints;
+  decodeUTF8(str, codepoints);
+  return codepoints;
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,281 @@
+#include "core/ui/textLayout.hpp"
+
+#include <algorithm>
+
+#include "core/sourceStamp.hpp"
+#include "core/ui/font.hpp"
+#include "core/ui/textComponent.hpp"
+
+namespace vsrg {
+TextLayoutCache::~TextLayoutCache() {
+    clear();
+}
+
+uint64_t TextLayoutCache::hashKey(const Font* font, std::string_view text, float size,
+                                  float line_gap) {
+    // fnv-1a over the text, then the rest of the key
+    uint64_t hash = hashFNV1a(text.data(), text.size());
+    hash = hashFNV1a(&font, sizeof(font), hash);
+    hash = hashFNV1a(&size, sizeof(size), hash);
+    hash = hashFNV1a(&line_gap, sizeof(line_gap), hash);
+    return hash;
+}
+
+bool TextLayoutCache::isStale(const TextLayout& layout) const {
+    return layout.waiting_for_glyphs &&
+           layout.font->getGlyphGeneration() != layout.glyph_generation;
+}
+
+TextLayout* TextLayoutCache::acquire(Font* font, std::string_view text, float size,
+                                     float line_gap) {
+    uint64_t key = hashKey(font, text, size, line_gap);
+
+    auto [begin, end] = layouts.equal_range(key);
+    for (auto it = begin; it != end; ++it) {
+        TextLayout* layout = it->second.get();
+        if (layout->font != font || layout->size != size || layout->line_gap != line_gap ||
+            layout->text != text)
+            continue;
+
+        if (layout->reference_count > 0) {
+            // still shown somewhere with placeholders, whoever shows it lays out again
+            if (isStale(*layout)) continue;
+            layout->reference_count++;
+            return layout;
+        }
+
+        unused.erase(layout->unused_entry);
+        if (isStale(*layout) || font->getEvictionCount() != layout->eviction_count) {
+            build(*layout);
+        } else {
+            for (const Character* ch : layout->glyphs) font->retainGlyph(ch);
+        }
+        layout->reference_count = 1;
+        return layout;
+    }
+
+    std::unique_ptr<TextLayout> layout;
+    if (!pool.empty()) {
+        layout = std::move(pool.back());
+        pool.pop_back();
+    } else {
+        layout = std::make_unique<TextLayout>();
+    }
+
+    layout->key = key;
+    layout->font = font;
+    layout->text.assign(text.data(), text.size());
+    layout->size = size;
+    layout->line_gap = line_gap;
+    build(*layout);
+    layout->reference_count = 1;
+
+    TextLayout* result = layout.get();
+    layouts.emplace(key, std::move(layout));
+    return result;
+}
+
+void TextLayoutCache::release(TextLayout* layout) {
+    if (layout == nullptr || --layout->reference_count > 0) return;
+
+    for (const Character* ch : layout->glyphs) layout->font->releaseGlyph(ch);
+
+    // nobody would get a match on it anymore
+    if (isStale(*layout)) {
+        remove(layout);
+        return;
+    }
+
+    layout->eviction_count = layout->font->getEvictionCount();
+    layout->unused_entry = unused.insert(unused.end(), layout);
+
+    while (unused.size() > TEXT_LAYOUT_CACHE_CAPACITY) {
+        TextLayout* oldest = unused.front();
+        unused.pop_front();
+        remove(oldest);
+    }
+}
+
+GLuint TextLayoutCache::getVertexArray(TextLayout* layout) {
+    if (layout->uploaded || layout->vertices.empty()) return layout->vao;
+
+    if (!layout->vao) {
+        glGenVertexArrays(1, &layout->vao);
+        glGenBuffers(1, &layout->vbo);
+
+        glBindVertexArray(layout->vao);
+        glBindBuffer(GL_ARRAY_BUFFER, layout->vbo);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), 0);
+        glBindVertexArray(0);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, layout->vbo);
+    }
+
+    size_t size = layout->vertices.size() * sizeof(glm::vec4);
+    if (size > layout->vbo_capacity) {
+        glBufferData(GL_ARRAY_BUFFER, size, layout->vertices.data(), GL_STATIC_DRAW);
+        layout->vbo_capacity = size;
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, layout->vertices.data());
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    layout->uploaded = true;
+    return layout->vao;
+}
+
+void TextLayoutCache::clear() {
+    for (auto& [key, layout] : layouts) {
+        if (layout->reference_count > 0) {
+            for (const Character* ch : layout->glyphs) layout->font->releaseGlyph(ch);
+        }
+        destroy(*layout);
+    }
+    for (auto& layout : pool) destroy(*layout);
+
+    layouts.clear();
+    unused.clear();
+    pool.clear();
+}
+
+void TextLayoutCache::build(TextLayout& layout) {
+    // the glyphs of a layout being built are never retained, it is either new or unused
+    layout.glyphs.clear();
+    layout.vertices.clear();
+    layout.runs.clear();
+    layout.dimensions = glm::vec2(0.0f);
+    layout.waiting_for_glyphs = false;
+    layout.uploaded = false;
+    glyph_textures.clear();
+
+    Font* font = layout.font;
+    TextComponent::decodeUTF8(layout.text, charcode_scratch);
+    if (charcode_scratch.empty()) return;
+
+    layout.glyph_generation = font->getGlyphGeneration();
+
+    float current_x = 0.0f;
+    float current_y = 0.0f;
+    float max_width = 0.0f;
+    int line_count = 1;
+
+    float scaling_factor = layout.size / font->getSizePt();
+    float line_height = (font->getSizePt() + layout.line_gap) * scaling_factor;
+
+    for (Charcode c : charcode_scratch) {
+        if (c == '\n') {
+            max_width = std::max(max_width, current_x);
+            current_x = 0.0f;
+            current_y += line_height;
+            line_count++;
+            continue;
+        }
+
+        const Character* ch = font->getCharacter(c);
+        if (!ch) continue;
+        if (font->isPlaceholder(ch)) layout.waiting_for_glyphs = true;
+
+        float xpos = current_x + ch->bearing.x * scaling_factor;
+        float ypos =
+            current_y + (font->getBaselineHeight() - ch->bearing.y + font->getSizePt()) *
+                            scaling_factor;
+        float w = ch->size.x * scaling_factor;
+        float h = ch->size.y * scaling_factor;
+
+        current_x += ch->advance * scaling_factor;
+
+        // spaces and other empty glyphs only advance
+        if (ch->size.x <= 0 || ch->size.y <= 0) continue;
+
+        font->retainGlyph(ch);
+        layout.glyphs.push_back(ch);
+
+        float u1 = ch->atlas_offset.x;
+        float v1 = ch->atlas_offset.y;
+        float u2 = u1 + ch->atlas_size_norm.x;
+        float v2 = v1 + ch->atlas_size_norm.y;
+
+        layout.vertices.push_back({xpos, ypos + h, u1, v2});
+        layout.vertices.push_back({xpos, ypos, u1, v1});
+        layout.vertices.push_back({xpos + w, ypos, u2, v1});
+        layout.vertices.push_back({xpos, ypos + h, u1, v2});
+        layout.vertices.push_back({xpos + w, ypos, u2, v1});
+        layout.vertices.push_back({xpos + w, ypos + h, u2, v2});
+
+        // a string rarely touches more than one or two atlases, a linear search is plenty
+        auto run = std::find_if(layout.runs.begin(), layout.runs.end(),
+                                [&](const TextRun& r) { return r.texture_id == ch->texture_id; });
+        if (run == layout.runs.end()) {
+            layout.runs.push_back({ch->texture_id, 0, 0});
+            run = layout.runs.end() - 1;
+        }
+        run->count += 6;
+        glyph_textures.push_back(ch->texture_id);
+    }
+
+    max_width = std::max(max_width, current_x);
+    layout.dimensions = {max_width, line_count * line_height};
+
+    if (layout.runs.size() <= 1) return;
+
+    // more than one atlas, regroup the quads so every run is one contiguous range. glyphs of one
+    // string share a color so their draw order doesnt matter
+    GLint offset = 0;
+    for (auto& run : layout.runs) {
+        run.first = offset;
+        offset += run.count;
+    }
+
+    vertex_scratch.resize(layout.vertices.size());
+    run_cursors.clear();
+    for (const auto& run : layout.runs) run_cursors.push_back(run.first);
+
+    for (size_t glyph = 0; glyph < glyph_textures.size(); glyph++) {
+        size_t run_index = 0;
+        while (layout.runs[run_index].texture_id != glyph_textures[glyph]) run_index++;
+
+        GLint& cursor = run_cursors[run_index];
+        std::copy_n(layout.vertices.begin() + glyph * 6, 6, vertex_scratch.begin() + cursor);
+        cursor += 6;
+    }
+
+    layout.vertices.swap(vertex_scratch);
+}
+
+void TextLayoutCache::remove(TextLayout* layout) {
+    auto [begin, end] = layouts.equal_range(layout->key);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second.get() != layout) continue;
+
+        std::unique_ptr<TextLayout> owned = std::move(it->second);
+        layouts.erase(it);
+        recycle(std::move(owned));
+        return;
+    }
+}
+
+void TextLayoutCache::recycle(std::unique_ptr<TextLayout> layout) {
+    if (pool.size() >= TEXT_LAYOUT_POOL_SIZE) {
+        destroy(*layout);
+        return;
+    }
+
+    layout->font = nullptr;
+    layout->text.clear();
+    layout->glyphs.clear();
+    layout->vertices.clear();
+    layout->runs.clear();
+    layout->uploaded = false;
+    layout->reference_count = 0;
+    pool.push_back(std::move(layout));
+}
+
+void TextLayoutCache::destroy(TextLayout& layout) {
+    if (layout.vbo) glDeleteBuffers(1, &layout.vbo);
+    if (layout.vao) glDeleteVertexArrays(1, &layout.vao);
+    layout.vbo = 0;
+    layout.vao = 0;
+    layout.vbo_capacity = 0;
+}
+}  // namespace vsrg
@@ -1,116 +1,661 @@
 #include "core/ui/texture.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 #include "core/debug.hpp"
+#include "core/ui/bakedTexture.hpp"
 #include "core/utils.hpp"
 
-
-#ifndef STB_IMAGE_IMPLEMENTATION_DONE
-#define STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION_DONE
-#endif
 #include <stb_image.h>
 
 namespace vsrg {
 
 TextureCache::TextureCache(EngineContext* engine_context) : engine_context(engine_context) {
+    // global in stb, set once here since the workers decode concurrently
+    stbi_set_flip_vertically_on_load(false);
+
+    stats.vram_budget = TEXTURE_VRAM_BUDGET_DEFAULT;
+
+    // id 0 is the invalid handle
+    handle_paths.emplace_back();
+    handle_textures.push_back(nullptr);
+
     engine_context->get_debugger()->log(DebugLevel::INFO, "Texture cache initialized", __FILE__,
                                         __LINE__);
 }
 
 TextureCache::~TextureCache() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_condition.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
     clearAll();
+
+    if (placeholder_texture) glDeleteTextures(1, &placeholder_texture);
+    upload_stream.reset();
 }
 
-bool TextureCache::loadTextureFromFile(const std::string& path, CachedTexture& texture) {
-    std::string execPath = getExecutableDir();
-    std::string filePath = joinPaths(execPath, "assets", path);
+void TextureCache::decodeImage(const std::string& path, DecodedImage& image) {
+    std::string file_path = joinPaths(getExecutableDir(), "assets", path);
 
-    int width, height, channels;
-    stbi_set_flip_vertically_on_load(false);
-    unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &channels, 0);
+    image.path = path;
+
+    BakedTexture baked;
+    if (!loadBakedTexture(file_path, baked)) return;
 
-    if (!data) {
+    int width = baked.width;
+    int height = baked.height;
+
+    image.width = width;
+    image.height = height;
+    image.channels = baked.channels;
+    image.levels = baked.level_count;
+    image.atlas = width <= TEXTURE_ATLAS_MAX_ENTRY_SIZE && height <= TEXTURE_ATLAS_MAX_ENTRY_SIZE;
+
+    if (!image.atlas) {
+        image.pixels = std::move(baked.pixels);
+        image.ok = true;
+        return;
+    }
+
+    // repeat the edge pixels out into the padding so filtering never picks up a neighbour
+    const int padding = TEXTURE_ATLAS_PADDING;
+    int padded_width = width + padding * 2;
+    int padded_height = height + padding * 2;
+
+    image.levels = 1;
+    image.pixels.resize(static_cast<size_t>(padded_width) * padded_height * 4);
+    for (int y = 0; y < padded_height; y++) {
+        int src_y = std::clamp(y - padding, 0, height - 1);
+        const unsigned char* src_row = &baked.pixels[static_cast<size_t>(src_y) * width * 4];
+        unsigned char* dst_row = &image.pixels[static_cast<size_t>(y) * padded_width * 4];
+
+        for (int x = 0; x < padded_width; x++) {
+            int src_x = std::clamp(x - padding, 0, width - 1);
+            std::memcpy(dst_row + x * 4, src_row + src_x * 4, 4);
+        }
+    }
+
+    image.ok = true;
+}
+
+bool TextureCache::uploadImage(const DecodedImage& image, CachedTexture& texture, bool use_pbo) {
+    if (!image.ok) {
         engine_context->get_debugger()->log(
-            DebugLevel::ERROR, std::string("Failed to load texture from path: ") + path, __FILE__,
-            __LINE__);
+            DebugLevel::ERROR, std::string("Failed to load texture from path: ") + image.path,
+            __FILE__, __LINE__);
         return false;
     }
 
+    int width = image.width;
+    int height = image.height;
+
     texture.dimensions = glm::ivec2(width, height);
-    texture.channels = channels;
+    texture.channels = image.channels;
+
+    // async uploads go through a pixel buffer so the copy into the texture doesnt block us
+    const void* source = image.pixels.data();
+    bool staged = false;
+    if (use_pbo && image.pixels.size() <= TEXTURE_UPLOAD_CHUNK_SIZE) {
+        if (!upload_stream) {
+            upload_stream = std::make_unique<StreamBuffer>(
+                engine_context, GL_PIXEL_UNPACK_BUFFER, TEXTURE_UPLOAD_CHUNK_SIZE, 2);
+        }
+
+        size_t offset;
+        void* dst = upload_stream->map(image.pixels.size(), offset);
+        if (dst) {
+            std::memcpy(dst, image.pixels.data(), image.pixels.size());
+            upload_stream->unmap();
+
+            // with a pixel unpack buffer bound the pointer is an offset into it
+            source = reinterpret_cast<const void*>(offset);
+            staged = true;
+        }
+    }
+
+    if (image.atlas) {
+        int padded_width = width + TEXTURE_ATLAS_PADDING * 2;
+        int padded_height = height + TEXTURE_ATLAS_PADDING * 2;
+
+        int page_index;
+        glm::ivec2 position;
+        if (!placeInAtlas(padded_width, padded_height, page_index, position)) {
+            if (staged) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return false;
+        }
+
+        AtlasPage& page = atlas_pages[page_index];
+        glBindTexture(GL_TEXTURE_2D, page.texture_id);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, position.x, position.y, padded_width, padded_height,
+                        GL_RGBA, GL_UNSIGNED_BYTE, source);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        if (staged) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        page.entry_count++;
+
+        texture.vram_bytes = static_cast<size_t>(padded_width) * padded_height * 4;
+
+        float page_size = static_cast<float>(TEXTURE_ATLAS_PAGE_SIZE);
+        texture.texture_id = page.texture_id;
+        texture.atlas_page = page_index;
+        texture.uv_rect = glm::vec4((position.x + TEXTURE_ATLAS_PADDING) / page_size,
+                                    (position.y + TEXTURE_ATLAS_PADDING) / page_size,
+                                    width / page_size, height / page_size);
+        texture.loaded = true;
+        texture.pending = false;
+
+        engine_context->get_debugger()->log(
+            DebugLevel::INFO,
+            std::string("Packed texture into atlas: ") + image.path + " (" +
+                std::to_string(width) + "x" + std::to_string(height) + ", page " +
+                std::to_string(page_index) + ")",
+            __FILE__, __LINE__);
+
+        return true;
+    }
 
     glGenTextures(1, &texture.texture_id);
     glBindTexture(GL_TEXTURE_2D, texture.texture_id);
 
-    GLenum format = GL_RGB;
-    if (channels == 1)
-        format = GL_RED;
-    else if (channels == 3)
-        format = GL_RGB;
-    else if (channels == 4)
-        format = GL_RGBA;
+    // the levels sit back to back in pixels, same layout as the baked file
+    const unsigned char* level_source = static_cast<const unsigned char*>(source);
+    size_t level_bytes = 0;
+    for (int level = 0; level < image.levels; level++) {
+        int level_width = std::max(width >> level, 1);
+        int level_height = std::max(height >> level, 1);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, level_width, level_height, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, level_source + level_bytes);
+        level_bytes += static_cast<size_t>(level_width) * level_height * 4;
+    }
 
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.levels - 1);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                    image.levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    stbi_image_free(data);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (staged) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
     if (glGetError() != GL_NO_ERROR) {
         engine_context->get_debugger()->log(
-            DebugLevel::ERROR, std::string("OpenGL error while loading texture: ") + path, __FILE__,
-            __LINE__);
+            DebugLevel::ERROR, std::string("OpenGL error while loading texture: ") + image.path,
+            __FILE__, __LINE__);
         glDeleteTextures(1, &texture.texture_id);
         texture.texture_id = 0;
         return false;
     }
 
+    texture.atlas_page = -1;
+    texture.uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
     texture.loaded = true;
-    texture.reference_count = 0;
+    texture.pending = false;
+
+    texture.vram_bytes = level_bytes;
+    stats.vram_bytes += level_bytes;
 
     engine_context->get_debugger()->log(DebugLevel::INFO,
-                                        std::string("Successfully cached texture: ") + path + " (" +
-                                            std::to_string(width) + "x" + std::to_string(height) +
-                                            ")",
+                                        std::string("Successfully cached texture: ") + image.path +
+                                            " (" + std::to_string(width) + "x" +
+                                            std::to_string(height) + ")",
                                         __FILE__, __LINE__);
 
     return true;
 }
 
-CachedTexture* TextureCache::getTexture(const std::string& path) {
+bool TextureCache::createAtlasPage() {
+    AtlasPage page;
+    page.packer.reset(TEXTURE_ATLAS_PAGE_SIZE, TEXTURE_ATLAS_PAGE_SIZE);
+
+    glGenTextures(1, &page.texture_id);
+    glBindTexture(GL_TEXTURE_2D, page.texture_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, TEXTURE_ATLAS_PAGE_SIZE, TEXTURE_ATLAS_PAGE_SIZE, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (glGetError() != GL_NO_ERROR) {
+        engine_context->get_debugger()->log(DebugLevel::ERROR,
+                                            "Failed to create a texture atlas page", __FILE__,
+                                            __LINE__);
+        glDeleteTextures(1, &page.texture_id);
+        return false;
+    }
+
+    atlas_pages.push_back(page);
+    stats.vram_bytes += static_cast<size_t>(TEXTURE_ATLAS_PAGE_SIZE) * TEXTURE_ATLAS_PAGE_SIZE * 4;
+
+    engine_context->get_debugger()->log(
+        DebugLevel::INFO,
+        std::string("Created texture atlas page ") + std::to_string(atlas_pages.size() - 1) +
+            " (" + std::to_string(TEXTURE_ATLAS_PAGE_SIZE) + "x" +
+            std::to_string(TEXTURE_ATLAS_PAGE_SIZE) + ")",
+        __FILE__, __LINE__);
+
+    return true;
+}
+
+bool TextureCache::placeInAtlas(int padded_width, int padded_height, int& page_index,
+                                glm::ivec2& position) {
+    for (size_t i = 0; i < atlas_pages.size(); i++) {
+        if (atlas_pages[i].packer.pack(padded_width, padded_height, position)) {
+            page_index = static_cast<int>(i);
+            return true;
+        }
+    }
+
+    if (!createAtlasPage()) return false;
+    if (!atlas_pages.back().packer.pack(padded_width, padded_height, position)) return false;
+
+    page_index = static_cast<int>(atlas_pages.size()) - 1;
+    return true;
+}
+
+void TextureCache::releaseTexture(CachedTexture& texture) {
+    if (texture.atlas_page >= 0) {
+        // skyline space cant be given back one rect at a time, the page is only reused once
+        // everything in it is gone
+        AtlasPage& page = atlas_pages[texture.atlas_page];
+        if (--page.entry_count <= 0) {
+            page.entry_count = 0;
+            page.packer.reset(TEXTURE_ATLAS_PAGE_SIZE, TEXTURE_ATLAS_PAGE_SIZE);
+        }
+    } else if (texture.texture_id) {
+        glDeleteTextures(1, &texture.texture_id);
+        stats.vram_bytes -= texture.vram_bytes;
+    }
+
+    texture.texture_id = 0;
+    texture.atlas_page = -1;
+}
+
+GLuint TextureCache::getPlaceholderTexture() {
+    if (placeholder_texture) return placeholder_texture;
+
+    // 1x1 transparent, pending sprites just dont show up until their texture is in
+    const unsigned char pixel[4] = {0, 0, 0, 0};
+
+    glGenTextures(1, &placeholder_texture);
+    glBindTexture(GL_TEXTURE_2D, placeholder_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return placeholder_texture;
+}
+
+TextureHandle TextureCache::getHandle(const std::string& path) {
+    auto [it, inserted] = handle_ids.try_emplace(path, static_cast<uint32_t>(handle_paths.size()));
+    if (inserted) {
+        handle_paths.push_back(path);
+
+        auto cached = textures.find(path);
+        handle_textures.push_back(cached != textures.end() ? &cached->second : nullptr);
+    }
+
+    return TextureHandle{it->second};
+}
+
+const std::string& TextureCache::getPath(TextureHandle handle) const {
+    return handle.id < handle_paths.size() ? handle_paths[handle.id] : handle_paths[0];
+}
+
+CachedTexture* TextureCache::getTexture(TextureHandle handle, bool wait_if_pending) {
+    if (!handle.valid() || handle.id >= handle_textures.size()) return nullptr;
+
+    CachedTexture* texture = handle_textures[handle.id];
+    if (texture && (texture->loaded || (texture->pending && !wait_if_pending))) {
+        stats.hits++;
+        texture->last_used = frame_index;
+        return texture;
+    }
+
+    // not cached or has to be waited on, the path version does the loading
+    return getTexture(handle_paths[handle.id], wait_if_pending);
+}
+
+CachedTexture* TextureCache::storeTexture(const std::string& path, const CachedTexture& texture) {
+    auto [it, inserted] = textures.insert_or_assign(path, texture);
+
+    TextureHandle handle = getHandle(path);
+    it->second.handle = handle;
+    it->second.generation = next_generation++;
+    handle_textures[handle.id] = &it->second;
+
+    return &it->second;
+}
+
+std::unordered_map<std::string, CachedTexture>::iterator TextureCache::eraseTexture(
+    std::unordered_map<std::string, CachedTexture>::iterator it) {
+    handle_textures[it->second.handle.id] = nullptr;
+    return textures.erase(it);
+}
+
+CachedTexture* TextureCache::getTexture(const std::string& path, bool wait_if_pending) {
     auto it = textures.find(path);
     if (it != textures.end()) {
+        it->second.last_used = frame_index;
+
         if (it->second.loaded) {
+            stats.hits++;
             return &it->second;
         }
+
+        if (it->second.pending) {
+            stats.hits++;
+            if (!wait_if_pending) return &it->second;
+
+            finishPending(path);
+
+            it = textures.find(path);
+            return (it != textures.end() && it->second.loaded) ? &it->second : nullptr;
+        }
     }
 
+    stats.misses++;
+
+    DecodedImage image;
+    decodeImage(path, image);
+
     CachedTexture new_texture;
-    if (!loadTextureFromFile(path, new_texture)) {
+    if (!uploadImage(image, new_texture, false)) {
         return nullptr;
     }
+    new_texture.last_used = frame_index;
+
+    return storeTexture(path, new_texture);
+}
+
+TextureRequest TextureCache::loadTextureAsync(const std::string& path) {
+    TextureRequest request;
+
+    auto it = textures.find(path);
+    if (it != textures.end() && it->second.loaded) {
+        stats.hits++;
+        it->second.last_used = frame_index;
+
+        request.state = std::make_shared<TextureRequest::State>();
+        request.state->ready.store(true);
+        return request;
+    }
+
+    if (it != textures.end() && it->second.pending) {
+        stats.hits++;
+        request.state = pending_requests[path];
+        return request;
+    }
+
+    stats.misses++;
+
+    CachedTexture placeholder;
+    placeholder.texture_id = getPlaceholderTexture();
+    placeholder.pending = true;
+    placeholder.last_used = frame_index;
+    storeTexture(path, placeholder);
+
+    request.state = std::make_shared<TextureRequest::State>();
+    pending_requests[path] = request.state;
+
+    if (workers.empty()) {
+        unsigned int worker_count = backgroundWorkerCount();
+        for (unsigned int i = 0; i < worker_count; i++) {
+            workers.emplace_back(&TextureCache::workerLoop, this);
+        }
+    }
 
-    auto [inserted_it, success] = textures.insert({path, new_texture});
-    if (success) {
-        return &inserted_it->second;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        decode_queue.push_back(path);
     }
+    queue_condition.notify_one();
 
-    return nullptr;
+    return request;
 }
 
-void TextureCache::addReference(const std::string& path) {
-    auto it = textures.find(path);
-    if (it != textures.end()) {
-        it->second.reference_count++;
+void TextureCache::workerLoop() {
+    while (true) {
+        std::string path;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_condition.wait(lock, [this]() { return stopping || !decode_queue.empty(); });
+            if (stopping) return;
+
+            path = std::move(decode_queue.front());
+            decode_queue.pop_front();
+        }
+
+        DecodedImage image;
+        decodeImage(path, image);
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            decoded.push_back(std::move(image));
+        }
+        decoded_condition.notify_all();
+    }
+}
+
+void TextureCache::finishPending(const std::string& path) {
+    DecodedImage image;
+    bool decode_here = false;
+
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+
+        auto queued = std::find(decode_queue.begin(), decode_queue.end(), path);
+        if (queued != decode_queue.end()) {
+            // nobody started on it yet, quicker to decode it right here than to wait in line
+            decode_queue.erase(queued);
+            decode_here = true;
+        } else {
+            auto find_decoded = [&]() {
+                return std::find_if(decoded.begin(), decoded.end(),
+                                    [&](const DecodedImage& d) { return d.path == path; });
+            };
+
+            decoded_condition.wait(lock, [&]() { return find_decoded() != decoded.end(); });
+
+            auto found = find_decoded();
+            image = std::move(*found);
+            decoded.erase(found);
+        }
+    }
+
+    if (decode_here) decodeImage(path, image);
+
+    completeUpload(image, false);
+}
+
+void TextureCache::completeUpload(DecodedImage& image, bool use_pbo) {
+    std::shared_ptr<TextureRequest::State> state;
+    auto request_it = pending_requests.find(image.path);
+    if (request_it != pending_requests.end()) {
+        state = request_it->second;
+        pending_requests.erase(request_it);
+    }
+
+    // the entry can be gone (or already loaded) if the cache was cleared while this decoded
+    auto it = textures.find(image.path);
+    if (it == textures.end() || !it->second.pending) {
+        if (state) {
+            state->failed.store(true);
+            state->ready.store(true);
+        }
+        return;
     }
+
+    CachedTexture uploaded;
+    uploaded.handle = it->second.handle;
+    uploaded.reference_count = it->second.reference_count;
+    uploaded.generation = it->second.generation;
+    uploaded.last_used = it->second.last_used;
+
+    if (!uploadImage(image, uploaded, use_pbo)) {
+        eraseTexture(it);
+        if (state) {
+            state->failed.store(true);
+            state->ready.store(true);
+        }
+        return;
+    }
+
+    it->second = uploaded;
+    if (state) state->ready.store(true);
 }
 
-void TextureCache::removeReference(const std::string& path) {
+void TextureCache::processUploads() {
+    frame_index++;
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+
+        // always let one through so a single big image still makes progress
+        size_t budget = 0;
+        size_t count = 0;
+        while (count < decoded.size()) {
+            size_t size = decoded[count].pixels.size();
+            if (count > 0 && budget + size > TEXTURE_UPLOAD_BUDGET_BYTES) break;
+
+            budget += size;
+            count++;
+        }
+
+        uploading.clear();
+        std::move(decoded.begin(), decoded.begin() + count, std::back_inserter(uploading));
+        decoded.erase(decoded.begin(), decoded.begin() + count);
+    }
+
+    for (auto& image : uploading) {
+        completeUpload(image, true);
+    }
+    uploading.clear();
+
+    evictToBudget();
+}
+
+bool TextureCache::isEvictable(const CachedTexture& texture) const {
+    // sprites queued in the renderer only hold the texture id until the next flush, so anything
+    // looked up this frame or the last one could still be on its way to the gpu
+    return texture.reference_count <= 0 && !texture.pending && texture.last_used + 1 < frame_index;
+}
+
+void TextureCache::evictToBudget() {
+    if (stats.vram_bytes <= stats.vram_budget) return;
+
+    // atlas entries dont free anything until their whole page empties, only standalone
+    // textures are worth evicting
+    eviction_candidates.clear();
+    for (auto& [path, texture] : textures) {
+        if (texture.atlas_page < 0 && isEvictable(texture)) {
+            eviction_candidates.emplace_back(texture.last_used, path);
+        }
+    }
+
+    std::sort(eviction_candidates.begin(), eviction_candidates.end());
+
+    for (auto& [last_used, path] : eviction_candidates) {
+        if (stats.vram_bytes <= stats.vram_budget) break;
+
+        auto it = textures.find(path);
+        size_t freed = it->second.vram_bytes;
+
+        releaseTexture(it->second);
+        eraseTexture(it);
+        stats.evictions++;
+
+        engine_context->get_debugger()->log(
+            DebugLevel::DEBUG,
+            std::string("Evicted texture: ") + path + " (" + std::to_string(freed / 1024) + " KB)",
+            __FILE__, __LINE__);
+    }
+
+    eviction_candidates.clear();
+}
+
+void TextureCache::setVramBudget(size_t bytes) {
+    stats.vram_budget = bytes;
+    evictToBudget();
+}
+
+TextureRef::TextureRef(TextureCache* cache, const std::string& path) : cache(cache), path(path) {
+    if (cache) generation = cache->addReference(path);
+}
+
+TextureRef::~TextureRef() {
+    reset();
+}
+
+TextureRef::TextureRef(const TextureRef& other) : cache(other.cache), path(other.path) {
+    if (cache) generation = cache->addReference(path);
+}
+
+TextureRef& TextureRef::operator=(const TextureRef& other) {
+    if (this == &other) return *this;
+
+    // add first, the old and new path can be the same entry
+    uint64_t other_generation = other.cache ? other.cache->addReference(other.path) : 0;
+    reset();
+
+    cache = other.cache;
+    path = other.path;
+    generation = other_generation;
+    return *this;
+}
+
+TextureRef::TextureRef(TextureRef&& other) noexcept
+    : cache(std::exchange(other.cache, nullptr)),
+      path(std::move(other.path)),
+      generation(std::exchange(other.generation, 0)) {}
+
+TextureRef& TextureRef::operator=(TextureRef&& other) noexcept {
+    if (this == &other) return *this;
+
+    reset();
+
+    cache = std::exchange(other.cache, nullptr);
+    path = std::move(other.path);
+    generation = std::exchange(other.generation, 0);
+    return *this;
+}
+
+void TextureRef::reset() {
+    if (cache) cache->removeReference(path, generation);
+
+    cache = nullptr;
+    path.clear();
+    generation = 0;
+}
+
+uint64_t TextureCache::addReference(const std::string& path) {
     auto it = textures.find(path);
-    if (it != textures.end()) {
+    if (it == textures.end()) return 0;
+
+    it->second.reference_count++;
+    return it->second.generation;
+}
+
+void TextureCache::removeReference(const std::string& path, uint64_t generation) {
+    // the entry this was added to is gone (failed upload, clearAll), whatever is cached under
+    // the path now never counted it
+    auto it = textures.find(path);
+    if (it != textures.end() && it->second.generation == generation) {
         it->second.reference_count--;
         if (it->second.reference_count < 0) {
             it->second.reference_count = 0;
@@ -120,11 +665,9 @@ void TextureCache::removeReference(const std::string& path) {
 
 void TextureCache::clearUnused() {
     for (auto it = textures.begin(); it != textures.end();) {
-        if (it->second.reference_count <= 0) {
-            if (it->second.texture_id) {
-                glDeleteTextures(1, &it->second.texture_id);
-            }
-            it = textures.erase(it);
+        if (isEvictable(it->second)) {
+            releaseTexture(it->second);
+            it = eraseTexture(it);
         } else {
             ++it;
         }
@@ -133,11 +676,27 @@ void TextureCache::clearUnused() {
 
 void TextureCache::clearAll() {
     for (auto& [path, texture] : textures) {
-        if (texture.texture_id) {
+        // atlas pages and the placeholder are deleted on their own
+        if (texture.texture_id && texture.atlas_page < 0 && !texture.pending) {
             glDeleteTextures(1, &texture.texture_id);
         }
     }
     textures.clear();
+    std::fill(handle_textures.begin(), handle_textures.end(), nullptr);
+
+    // decodes still in flight are dropped when they come back
+    for (auto& [path, state] : pending_requests) {
+        state->failed.store(true);
+        state->ready.store(true);
+    }
+    pending_requests.clear();
+
+    for (auto& page : atlas_pages) {
+        if (page.texture_id) glDeleteTextures(1, &page.texture_id);
+    }
+    atlas_pages.clear();
+
+    stats.vram_bytes = 0;
 }
 
 }  // namespace vsrg
\ No newline at end of file
@@ -17,6 +17,9 @@
 
 #endif
 
+#include <algorithm>
+#include <thread>
+
 using namespace std::chrono;
 
 namespace vsrg {
@@ -96,6 +99,11 @@ std::string getCurrentTimestamp(bool showMs) {
     return ss.str();
 }
 
+unsigned int backgroundWorkerCount() {
+    unsigned int hardware_threads = std::thread::hardware_concurrency();
+    return std::clamp(hardware_threads, 2u, 5u) - 1;
+}
+
 float getFPS(float deltaTime) {
     if (deltaTime <= 0.0) return 0.0;
 
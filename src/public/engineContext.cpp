@@ -3,6 +3,7 @@
 #include "core/app.hpp"
 #include "core/debug.hpp"
 #include "core/engine/audio.hpp"
+#include "core/engine/input.hpp"
 #include "core/engine/plugin.hpp"
 #include "core/engine/screen.hpp"
 #include "core/ui/font.hpp"
@@ -22,21 +23,27 @@ EngineContext::EngineContext(Client* client) : client(client) {
     plugin_manager = new PluginManager(this);
 
     sprite_renderer = new SpriteRenderer(this);
+    input_manager = new InputManager(this);
 }
 
 EngineContext::~EngineContext() {
+    if (input_manager != nullptr) {
+        delete input_manager;
+        input_manager = nullptr;
+    }
     if (plugin_manager != nullptr) {
         delete plugin_manager;
         plugin_manager = nullptr;
     }
-    if (font_manager != nullptr) {
-        delete font_manager;
-        font_manager = nullptr;
-    }
+    // screens hold text that still references glyphs, they go first
     if (screen_manager != nullptr) {
         delete screen_manager;
         screen_manager = nullptr;
     }
+    if (font_manager != nullptr) {
+        delete font_manager;
+        font_manager = nullptr;
+    }
     if (sprite_renderer != nullptr) {
         delete sprite_renderer;
         sprite_renderer = nullptr;
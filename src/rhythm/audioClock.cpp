@@ -0,0 +1,71 @@
+#include "rhythm/audioClock.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace vsrg {
+AudioClock::AudioClock() : origin(clock::now()) {}
+
+void AudioClock::reset(double song_time, clock::time_point now) {
+    origin = now;
+    base_time = song_time;
+    fitted_rate = nominal_rate;
+
+    sample_count = 0;
+    next_sample = 0;
+}
+
+void AudioClock::set_rate(double rate, clock::time_point now) {
+    if (rate <= 0.0) return;
+
+    double current_time = song_time_at(now);
+    nominal_rate = rate;
+    reset(current_time, now);
+}
+
+void AudioClock::add_sample(clock::time_point now, double audio_time) {
+    if (std::abs(audio_time - song_time_at(now)) > RESYNC_THRESHOLD) {
+        reset(audio_time, now);
+    }
+
+    samples[next_sample] = {seconds_since_origin(now), audio_time};
+    next_sample = (next_sample + 1) % MAX_SAMPLES;
+    sample_count = std::min(sample_count + 1, MAX_SAMPLES);
+
+    refit();
+}
+
+double AudioClock::song_time_at(clock::time_point time) const {
+    return base_time + fitted_rate * seconds_since_origin(time);
+}
+
+void AudioClock::refit() {
+    if (sample_count == 0) return;
+
+    double mean_wall = 0.0, mean_audio = 0.0;
+    for (size_t i = 0; i < sample_count; ++i) {
+        mean_wall += samples[i].wall;
+        mean_audio += samples[i].audio;
+    }
+    mean_wall /= sample_count;
+    mean_audio /= sample_count;
+
+    // least squares over the window, with too few samples (or all at once) use the nominal rate
+    double rate = nominal_rate;
+    if (sample_count >= 4) {
+        double covariance = 0.0, variance = 0.0;
+        for (size_t i = 0; i < sample_count; ++i) {
+            double wall_offset = samples[i].wall - mean_wall;
+            covariance += wall_offset * (samples[i].audio - mean_audio);
+            variance += wall_offset * wall_offset;
+        }
+
+        if (variance > 1e-9) rate = covariance / variance;
+    }
+
+    double max_deviation = nominal_rate * MAX_RATE_DEVIATION;
+    fitted_rate = std::clamp(rate, nominal_rate - max_deviation, nominal_rate + max_deviation);
+    base_time = mean_audio - fitted_rate * mean_wall;
+}
+}  // namespace vsrg
@@ -3,22 +3,23 @@
 namespace vsrg {
 Conductor::Conductor(AudioManager* audio_manager, Audio* audio,
                      std::vector<TimingPoint> timing_points)
-    : audio_manager(audio_manager), audio(audio), timing_points(std::move(timing_points)) {
-    song_duration = audio->get_duration();
+    : audio_manager(audio_manager), audio(audio), timing_map(std::move(timing_points)) {
+    // charts without their audio still get a conductor, it just never moves
+    song_duration = audio ? audio->get_duration() : 0.0f;
 
     LatencyInfo latency = audio_manager->get_latency_info();
     if (latency.valid) {
         cached_latency = (float)latency.period_size_in_milliseconds / 1000.0f;
     }
 
-    if (!this->timing_points.empty()) {
-        this->current_point = &this->timing_points[0];
+    if (!timing_map.empty()) {
+        this->current_point = &timing_map.get_points()[0];
         this->current_point_index = 0;
     } else {
         this->current_point = nullptr;
     }
 
-    audio->set_playback_rate(playback_rate);
+    if (audio) audio->set_playback_rate(playback_rate);
 }
 
 Conductor::~Conductor() {
@@ -27,7 +28,11 @@ Conductor::~Conductor() {
 
 void Conductor::play() {
     if (audio_manager && audio) {
-        audio_manager->play_audio(audio);
+        if (audio_manager->play_audio(audio).status != MA_SUCCESS) return;
+
+        // the clock kept running while paused, start the fit over from where the audio is
+        clock.reset(audio->get_precise_position(), std::chrono::steady_clock::now());
+        last_hardware_position = audio->get_precise_position();
     }
 }
 
@@ -43,31 +48,31 @@ void Conductor::seek(float time_in_seconds) {
     audio->set_position(time_in_seconds);
     song_position = time_in_seconds;
 
-    int found_index = 0;
-    for (size_t i = 0; i < timing_points.size(); ++i) {
-        if (song_position >= timing_points[i].time) {
-            found_index = i;
-        } else {
-            break;
-        }
-    }
+    clock.reset(time_in_seconds, std::chrono::steady_clock::now());
+    last_hardware_position = time_in_seconds;
 
-    current_point_index = found_index;
-    current_point = &timing_points[current_point_index];
+    if (timing_map.empty()) return;
+
+    current_point_index = timing_map.get_point_index_at(song_position);
+    current_point = &timing_map.get_points()[current_point_index];
     updateBPM();
 }
 
 void Conductor::update(float delta_time) {
     if (!audio || audio->get_paused()) return;
 
-    float hardware_pos = audio->get_position();
+    // the cursor only moves once per audio period, so instead of snapping to it every time it
+    // changes, feed it to the clock and read the fitted time for this exact moment
+    auto now = std::chrono::steady_clock::now();
+
+    double hardware_pos = audio->get_precise_position();
     if (hardware_pos != last_hardware_position) {
-        song_position = hardware_pos - cached_latency;
+        clock.add_sample(now, hardware_pos);
         last_hardware_position = hardware_pos;
-    } else {
-        song_position += delta_time * playback_rate;
     }
 
+    song_position = (float)song_time_at(now);
+
     if (song_position < 0) song_position = 0;
 
     if (song_duration <= 0.0f) {
@@ -101,6 +106,7 @@ void Conductor::update(float delta_time) {
         }
     }
 
+    const std::vector<TimingPoint>& timing_points = timing_map.get_points();
     if (current_point_index + 1 < timing_points.size()) {
         if (song_position >= timing_points[current_point_index + 1].time) {
             current_point_index++;
@@ -110,21 +116,8 @@ void Conductor::update(float delta_time) {
     }
 }
 
-float Conductor::get_bpm_at_time(float time) {
-    if (timing_points.empty()) {
-        return 120.0f;  // fallback bpm
-    }
-
-    size_t found_index = 0;
-    for (size_t i = 0; i < timing_points.size(); ++i) {
-        if (time >= timing_points[i].time) {
-            found_index = i;
-        } else {
-            break;
-        }
-    }
-
-    return timing_points[found_index].bpm;
+float Conductor::get_bpm_at_time(float time) const {
+    return (float)timing_map.get_bpm_at(time);  // 120 if there are no timing points
 }
 
 void Conductor::updateBPM() {
@@ -0,0 +1,63 @@
+#include "rhythm/timingMap.hpp"
+
+#include <algorithm>
+
+
+namespace vsrg {
+namespace {
+const double FALLBACK_BPM = 120.0;
+}
+
+TimingMap::TimingMap(std::vector<TimingPoint> timing_points) : points(std::move(timing_points)) {
+    std::stable_sort(points.begin(), points.end(),
+                     [](const TimingPoint& a, const TimingPoint& b) { return a.time < b.time; });
+
+    point_beats.resize(points.size());
+
+    double beat = 0.0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (i > 0) {
+            const TimingPoint& previous = points[i - 1];
+            beat += ((double)points[i].time - (double)previous.time) * previous.bpm / 60.0;
+        }
+        point_beats[i] = beat;
+    }
+}
+
+size_t TimingMap::get_point_index_at(double time) const {
+    auto it = std::upper_bound(points.begin(), points.end(), time,
+                               [](double t, const TimingPoint& point) { return t < point.time; });
+    if (it == points.begin()) return 0;
+    return static_cast<size_t>(it - points.begin()) - 1;
+}
+
+const TimingPoint* TimingMap::get_point_at(double time) const {
+    if (points.empty()) return nullptr;
+    return &points[get_point_index_at(time)];
+}
+
+double TimingMap::get_bpm_at(double time) const {
+    if (points.empty()) return FALLBACK_BPM;
+    return points[get_point_index_at(time)].bpm;
+}
+
+double TimingMap::beat_at_time(double time) const {
+    if (points.empty()) return time * FALLBACK_BPM / 60.0;
+
+    size_t index = get_point_index_at(time);
+    const TimingPoint& point = points[index];
+    return point_beats[index] + (time - (double)point.time) * point.bpm / 60.0;
+}
+
+double TimingMap::time_at_beat(double beat) const {
+    if (points.empty()) return beat * 60.0 / FALLBACK_BPM;
+
+    auto it = std::upper_bound(point_beats.begin(), point_beats.end(), beat);
+    size_t index = 0;
+    if (it != point_beats.begin()) index = static_cast<size_t>(it - point_beats.begin()) - 1;
+
+    const TimingPoint& point = points[index];
+    if (point.bpm <= 0.0) return point.time;
+    return (double)point.time + (beat - point_beats[index]) * 60.0 / point.bpm;
+}
+}  // namespace vsrg
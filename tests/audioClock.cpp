@@ -0,0 +1,209 @@
+#include <miniaudio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "rhythm/audioClock.hpp"
+
+using namespace vsrg;
+using test::check;
+using namespace std::chrono;
+
+// the clamp and resync rules are checked with made up cursor samples, then a sine plays on
+// miniaudio's null backend and the frame to frame jitter of the fitted clock is compared with the
+// old snap to the cursor and extrapolate approach. the jitter rides on how well sleep_for keeps
+// time, so it is only printed unless --strict is passed, which fails above the limit
+// usage: vsrg-test-audioClock [--strict]
+
+namespace {
+const AudioClock::clock::time_point START = AudioClock::clock::time_point{} + seconds(100);
+const double SAMPLE_INTERVAL = 0.01;
+
+const double PLAY_SECONDS = 2.0;
+const double WARMUP_SECONDS = 0.25;
+const auto FRAME_INTERVAL = milliseconds(2);
+const double BIN_MS = 0.5;
+const double MAX_CLOCK_JITTER_MS = 1.0;  // 99th percentile, only checked with --strict
+
+AudioClock::clock::time_point at(double seconds) {
+    return START + duration_cast<AudioClock::clock::duration>(duration<double>(seconds));
+}
+
+// a cursor moving at rate for count samples, the clock starts in sync with it
+AudioClock feed(double rate, int count) {
+    AudioClock clock;
+    clock.reset(0.0, START);
+    for (int i = 1; i <= count; i++) {
+        clock.add_sample(at(i * SAMPLE_INTERVAL), i * SAMPLE_INTERVAL * rate);
+    }
+    return clock;
+}
+
+void checkRateClamp() {
+    check(std::abs(feed(1.05, 50).get_rate() - 1.02) < 1e-12, "a 5% fast cursor clamps to +2%");
+    check(std::abs(feed(0.95, 50).get_rate() - 0.98) < 1e-12, "a 5% slow cursor clamps to -2%");
+    check(std::abs(feed(1.01, 50).get_rate() - 1.01) < 1e-6, "a 1% fast cursor is followed");
+}
+
+void checkResync() {
+    double now = 51 * SAMPLE_INTERVAL;
+
+    // under the threshold the jump is one more sample in the fit
+    AudioClock small = feed(1.0, 50);
+    small.add_sample(at(now), now + 0.09);
+    check(small.song_time_at(at(now)) < now + 0.05, "a 90 ms jump is smoothed over");
+
+    // over it the fit starts again from the cursor
+    AudioClock large = feed(1.0, 50);
+    large.add_sample(at(now), now + 0.11);
+    check(large.song_time_at(at(now)) == now + 0.11, "a 110 ms jump resyncs to the cursor");
+}
+
+struct Histogram {
+    std::map<int, int> bins;
+    std::vector<double> magnitudes;
+
+    void add(double jitter_ms) {
+        bins[(int)std::floor(jitter_ms / BIN_MS)]++;
+        magnitudes.push_back(std::abs(jitter_ms));
+    }
+
+    double percentile(double p) {
+        if (magnitudes.empty()) return 0.0;
+        std::sort(magnitudes.begin(), magnitudes.end());
+        return magnitudes[std::min(magnitudes.size() - 1, (size_t)(p * magnitudes.size()))];
+    }
+};
+
+void printHistograms(Histogram& cursor, Histogram& fitted) {
+    int first = std::min(cursor.bins.begin()->first, fitted.bins.begin()->first);
+    int last = std::max(cursor.bins.rbegin()->first, fitted.bins.rbegin()->first);
+
+    std::cout << "  jitter ms   cursor   fitted" << std::endl;
+    for (int bin = first; bin <= last; bin++) {
+        if (!cursor.bins.count(bin) && !fitted.bins.count(bin)) continue;
+        std::cout << std::fixed << std::setprecision(1) << std::setw(11) << bin * BIN_MS
+                  << std::setw(9) << cursor.bins[bin] << std::setw(9) << fitted.bins[bin]
+                  << std::endl;
+    }
+    std::cout << "p99 cursor " << std::setprecision(3) << cursor.percentile(0.99)
+              << " ms, fitted " << fitted.percentile(0.99) << " ms" << std::endl;
+}
+
+// 77, ctest counts it as skipped
+int checkNullBackendJitter(bool strict) {
+    ma_context context;
+    ma_backend backends[] = {ma_backend_null};
+    if (ma_context_init(backends, 1, NULL, &context) != MA_SUCCESS) {
+        std::cerr << "no null backend" << std::endl;
+        return 77;
+    }
+
+    ma_engine_config config = ma_engine_config_init();
+    config.pContext = &context;
+
+    ma_engine engine;
+    if (ma_engine_init(&config, &engine) != MA_SUCCESS) {
+        std::cerr << "could not start an engine on the null backend" << std::endl;
+        ma_context_uninit(&context);
+        return 77;
+    }
+
+    ma_uint32 sample_rate = ma_engine_get_sample_rate(&engine);
+    ma_waveform_config waveform_config =
+        ma_waveform_config_init(ma_format_f32, 2, sample_rate, ma_waveform_type_sine, 0.2, 440);
+    ma_waveform waveform;
+    ma_waveform_init(&waveform_config, &waveform);
+
+    ma_sound sound;
+    ma_sound_init_from_data_source(&engine, &waveform, MA_SOUND_FLAG_NO_SPATIALIZATION, NULL,
+                                   &sound);
+    ma_sound_start(&sound);
+
+    auto cursorSeconds = [&]() {
+        ma_uint64 frames = 0;
+        ma_sound_get_cursor_in_pcm_frames(&sound, &frames);
+        return (double)frames / sample_rate;
+    };
+
+    // nothing to fit until the device has run once
+    auto give_up = AudioClock::clock::now() + seconds(2);
+    while (cursorSeconds() == 0.0 && AudioClock::clock::now() < give_up) {
+        std::this_thread::sleep_for(FRAME_INTERVAL);
+    }
+
+    AudioClock clock;
+    auto start = AudioClock::clock::now();
+    double last_cursor = cursorSeconds();
+    clock.reset(last_cursor, start);
+
+    // what Conductor::update did before the clock: snap to the cursor when it moves and add the
+    // frame time otherwise
+    double extrapolated = last_cursor;
+    double last_extrapolated = extrapolated;
+    double last_fitted = last_cursor;
+    auto last_frame = start;
+
+    Histogram cursor_jitter, fitted_jitter;
+    while (true) {
+        std::this_thread::sleep_for(FRAME_INTERVAL);
+        auto now = AudioClock::clock::now();
+        double wall = duration<double>(now - last_frame).count();
+        double elapsed = duration<double>(now - start).count();
+        if (elapsed > PLAY_SECONDS) break;
+
+        double cursor = cursorSeconds();
+        if (cursor != last_cursor) {
+            clock.add_sample(now, cursor);
+            extrapolated = cursor;
+            last_cursor = cursor;
+        } else {
+            extrapolated += wall;
+        }
+        double fitted = clock.song_time_at(now);
+
+        // jitter is how far a frame's step in song time is from its step in real time
+        if (elapsed > WARMUP_SECONDS) {
+            cursor_jitter.add((extrapolated - last_extrapolated - wall) * 1000.0);
+            fitted_jitter.add((fitted - last_fitted - wall) * 1000.0);
+        }
+
+        last_extrapolated = extrapolated;
+        last_fitted = fitted;
+        last_frame = now;
+    }
+
+    ma_sound_uninit(&sound);
+    ma_waveform_uninit(&waveform);
+    ma_engine_uninit(&engine);
+    ma_context_uninit(&context);
+
+    if (fitted_jitter.magnitudes.empty()) {
+        std::cerr << "no frames measured" << std::endl;
+        return 1;
+    }
+
+    printHistograms(cursor_jitter, fitted_jitter);
+    if (strict) check(fitted_jitter.percentile(0.99) < MAX_CLOCK_JITTER_MS, "fitted clock jitter");
+    return 0;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    bool strict = argc > 1 && std::string(argv[1]) == "--strict";
+
+    checkRateClamp();
+    checkResync();
+
+    int result = checkNullBackendJitter(strict);
+    if (test::failures > 0) return 1;
+    return result;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <iostream>
+
+
+// shared by the tests, a failed check prints what was expected and is counted. main returns non
+// zero once anything failed
+namespace test {
+inline int failures = 0;
+
+inline void check(bool condition, const char* what) {
+    if (condition) return;
+    std::cerr << "failed: " << what << std::endl;
+    failures++;
+}
+}  // namespace test
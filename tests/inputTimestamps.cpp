@@ -0,0 +1,133 @@
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "core/engine/audio.hpp"
+#include "core/engine/input.hpp"
+#include "rhythm/conductor.hpp"
+
+using namespace vsrg;
+using test::check;
+
+// synthetic key events are pushed through sdl at random moments between frames, drained once per
+// frame the way the game does, and each timestamp is compared with the moment the event was
+// pushed. polling once per frame put every key on the frame time instead, that error is printed
+// next to it
+
+namespace {
+const int EVENT_COUNT = 600;
+const auto FRAME_INTERVAL = std::chrono::microseconds(16667);
+const double MAX_TIMESTAMP_ERROR_MS = 1.0;  // 99th percentile
+
+int64_t steadyNanoseconds(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// sdl stamps the event itself when the timestamp is left at 0, the same as for real input
+void pushKey(int scancode, bool down) {
+    SDL_Event event{};
+    event.type = down ? SDL_EVENT_KEY_DOWN : SDL_EVENT_KEY_UP;
+    event.key.scancode = (SDL_Scancode)scancode;
+    event.key.down = down;
+    SDL_PushEvent(&event);
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+}
+
+// events queued before a conductor exists never reach it
+void checkStaleEventsDropped(InputManager& input, Conductor& conductor) {
+    for (int i = 0; i < 8; i++) pushKey(4 + i, true);
+
+    input.set_conductor(&conductor);
+
+    std::vector<InputEvent> events;
+    check(input.drain(events) == 0, "set_conductor drops events queued before it");
+}
+
+void measureTimestampError(InputManager& input, Conductor& conductor) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> gap_us(0, 4000);
+
+    std::vector<int64_t> pushed_at;
+    std::vector<InputEvent> events;
+    std::vector<double> stamped_error, polled_error;
+    double worst_song_time_error = 0.0;
+
+    auto next_frame = std::chrono::steady_clock::now() + FRAME_INTERVAL;
+    while ((int)pushed_at.size() < EVENT_COUNT) {
+        // a few keys somewhere in the frame, then the frame drains them all at once
+        while (std::chrono::steady_clock::now() < next_frame &&
+               (int)pushed_at.size() < EVENT_COUNT) {
+            std::this_thread::sleep_for(std::chrono::microseconds(gap_us(rng)));
+            pushed_at.push_back(steadyNanoseconds(std::chrono::steady_clock::now()));
+            pushKey(4 + pushed_at.size() % 4, pushed_at.size() % 2 == 0);
+        }
+        std::this_thread::sleep_until(next_frame);
+        next_frame += FRAME_INTERVAL;
+
+        size_t first = events.size();
+        input.drain(events);
+        int64_t frame_time = steadyNanoseconds(std::chrono::steady_clock::now());
+
+        for (size_t i = first; i < events.size(); i++) {
+            const InputEvent& event = events[i];
+            stamped_error.push_back(std::abs(event.timestamp_ns - pushed_at[i]) / 1e6);
+            polled_error.push_back((frame_time - pushed_at[i]) / 1e6);
+
+            std::chrono::steady_clock::time_point time{
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::nanoseconds(event.timestamp_ns))};
+            worst_song_time_error = std::max(
+                worst_song_time_error, std::abs(event.song_time - conductor.song_time_at(time)));
+        }
+    }
+
+    check(events.size() == pushed_at.size(), "every pushed event is drained");
+    check(input.get_dropped_count() == 0, "no events dropped");
+
+    std::cout << events.size() << " events" << std::fixed << std::setprecision(3) << std::endl;
+    std::cout << "stamped  p50 " << percentile(stamped_error, 0.5) << " ms  p99 "
+              << percentile(stamped_error, 0.99) << " ms" << std::endl;
+    std::cout << "polled   p50 " << percentile(polled_error, 0.5) << " ms  p99 "
+              << percentile(polled_error, 0.99) << " ms" << std::endl;
+
+    check(percentile(stamped_error, 0.99) < MAX_TIMESTAMP_ERROR_MS, "timestamp error");
+    check(worst_song_time_error < 1e-9, "song time matches the conductor at the timestamp");
+}
+}  // namespace
+
+// 77, ctest counts it as skipped
+int main() {
+    if (!SDL_Init(SDL_INIT_EVENTS)) {
+        std::cerr << "could not init sdl events: " << SDL_GetError() << std::endl;
+        return 77;
+    }
+
+    {
+        // no engine context, it is only used to log dropped events. the conductor has no audio,
+        // its clock just runs from when it was made
+        InputManager input(nullptr);
+        AudioManager audio_manager(nullptr);
+        Conductor conductor(&audio_manager, nullptr, {});
+
+        checkStaleEventsDropped(input, conductor);
+        measureTimestampError(input, conductor);
+
+        input.set_conductor(nullptr);
+    }
+
+    SDL_Quit();
+    return test::failures > 0 ? 1 : 0;
+}
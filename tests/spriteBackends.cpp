@@ -0,0 +1,166 @@
+#include <glad/glad.h>
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/app.hpp"
+#include "core/ui/sprite.hpp"
+#include "core/ui/texture.hpp"
+#include "offscreen.hpp"
+#include "public/engineContext.hpp"
+#include "tempFiles.hpp"
+
+using namespace vsrg;
+
+// draws the same scene through the batched and the instanced sprite backend into an offscreen
+// framebuffer and compares the pixels. meant for mesa's llvmpipe, any gl 3.3 driver works.
+// rotated quads are built with float math on the cpu for one and on the gpu for the other, so
+// pixels along their edges may land differently, everything else has to match exactly
+
+namespace {
+const int WIDTH = 640;
+const int HEIGHT = 360;
+const int SPRITE_COUNT = 1500;
+
+// a rotated quad edge can cover a pixel center in one backend and miss it in the other
+const double MAX_ROTATED_MISMATCH = 0.002;  // fraction of pixels
+
+// a pattern that shows flipped or offset uvs, written to the temp dir as ppm
+std::string writeImage(const std::string& name, int size, int seed) {
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / ("vsrg-test-" + name + ".ppm");
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "P6\n" << size << " " << size << "\n255\n";
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            bool checker = ((x / 8) + (y / 8)) % 2 == 0;
+            unsigned char pixel[3] = {static_cast<unsigned char>(x * 255 / size),
+                                      static_cast<unsigned char>(y * 255 / size),
+                                      static_cast<unsigned char>(checker ? 40 * seed : 255)};
+            file.write(reinterpret_cast<const char*>(pixel), 3);
+        }
+    }
+
+    return path.string();
+}
+
+void drawScene(SpriteRenderer& renderer, const std::vector<TextureHandle>& textures,
+               bool rotated) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    renderer.begin();
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        TextureHandle texture = textures[rng() % textures.size()];
+        glm::vec2 position(unit(rng) * WIDTH, unit(rng) * HEIGHT);
+        int layer = rng() % 4;
+        float rotation = rotated ? 360.0f * unit(rng) : 0.0f;
+
+        // every parameter gets exercised: uv rects, anchors, non uniform scale, opacity
+        if (i % 3 == 0) {
+            renderer.drawSprite(texture, position, glm::vec2(48.0f),
+                                glm::vec4(0.25f, 0.0f, 0.5f, 0.5f), rotation, glm::vec2(0.5f),
+                                glm::vec2(1.2f, 0.7f), 0.8f, layer);
+        } else {
+            renderer.drawSprite(texture, position, glm::vec2(40.0f), i % 2 ? rotation : 0.0f,
+                                glm::vec2(0.0f), glm::vec2(1.0f), (i % 7) / 6.0f, layer);
+        }
+    }
+    renderer.end();
+}
+
+std::vector<unsigned char> readPixels() {
+    glFinish();
+    std::vector<unsigned char> pixels(WIDTH * HEIGHT * 4);
+    glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+
+// pixels that differ in any channel
+size_t countMismatches(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b) {
+    size_t mismatches = 0;
+    for (size_t i = 0; i < a.size(); i += 4) {
+        if (!std::equal(a.begin() + i, a.begin() + i + 4, b.begin() + i)) mismatches++;
+    }
+    return mismatches;
+}
+}  // namespace
+
+// 77, ctest counts it as skipped
+int main() {
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+
+    test::TempFiles images;
+
+    auto client = std::make_unique<Client>(WIDTH, HEIGHT);
+    if (!client->is_initialized()) {
+        std::cerr << "no gl context" << std::endl;
+        return 77;
+    }
+    EngineContext* ctx = client->get_engine_context();
+    std::cout << "renderer: " << glGetString(GL_RENDERER) << std::endl;
+
+    // the window's own framebuffer might not be readable on every driver
+    if (!test::bindOffscreenFramebuffer(WIDTH, HEIGHT)) {
+        std::cerr << "offscreen framebuffer incomplete" << std::endl;
+        return 77;
+    }
+
+    // small ones go into the atlas, the big one is a texture of its own
+    TextureCache* cache = ctx->get_texture_cache();
+    std::vector<TextureHandle> textures;
+    images.paths = {writeImage("small0", 64, 1), writeImage("small1", 32, 2),
+                    writeImage("large", TEXTURE_ATLAS_MAX_ENTRY_SIZE + 44, 3)};
+    for (const auto& path : images.paths) {
+        CachedTexture* texture = cache->getTexture(path);
+        if (!texture || !texture->loaded) {
+            std::cerr << "could not load " << path << std::endl;
+            return 1;
+        }
+        textures.push_back(cache->getHandle(path));
+    }
+
+    SpriteRenderer* renderer = ctx->get_sprite_renderer();
+    int failures = 0;
+
+    for (bool rotated : {false, true}) {
+        renderer->setBackend(SpriteBackend::BATCHED);
+        drawScene(*renderer, textures, rotated);
+        std::vector<unsigned char> batched = readPixels();
+
+        renderer->setBackend(SpriteBackend::INSTANCED);
+        drawScene(*renderer, textures, rotated);
+        std::vector<unsigned char> instanced = readPixels();
+
+        // two empty frames would match too
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        std::vector<unsigned char> cleared = readPixels();
+        if (countMismatches(batched, cleared) < (size_t)(WIDTH * HEIGHT / 4)) {
+            std::cerr << "failed: the scene barely drew anything" << std::endl;
+            failures++;
+        }
+
+        size_t mismatches = countMismatches(batched, instanced);
+        double fraction = (double)mismatches / (WIDTH * HEIGHT);
+        std::cout << (rotated ? "rotated: " : "axis aligned: ") << mismatches << " of "
+                  << WIDTH * HEIGHT << " pixels differ" << std::endl;
+
+        if (rotated ? fraction > MAX_ROTATED_MISMATCH : mismatches > 0) {
+            std::cerr << "failed: backends differ" << std::endl;
+            failures++;
+        }
+    }
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "core/ui/bakedTexture.hpp"
+
+
+namespace test {
+// images a test writes to the temp dir, removed with their baked copies once it is done however
+// it ends. declare it before anything that loads them so it outlives the texture cache
+struct TempFiles {
+    std::vector<std::string> paths;
+
+    // writing the same path twice only removes it once
+    const std::string& add(const std::string& path) {
+        auto it = std::find(paths.begin(), paths.end(), path);
+        if (it != paths.end()) return *it;
+        paths.push_back(path);
+        return paths.back();
+    }
+
+    ~TempFiles() {
+        std::error_code ec;
+        for (const auto& path : paths) {
+            std::filesystem::remove(path, ec);
+            std::filesystem::remove(vsrg::getBakedTexturePath(path), ec);
+        }
+    }
+};
+}  // namespace test
@@ -0,0 +1,213 @@
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "core/ui/bakedTexture.hpp"
+#include "core/ui/texture.hpp"
+#include "public/engineContext.hpp"
+#include "tempFiles.hpp"
+
+using namespace vsrg;
+using test::check;
+
+// the texture cache's bookkeeping without a gpu. glad's function pointers are swapped for stubs
+// that hand out texture names and remember which ones were deleted, so the hit, miss and
+// eviction counters, the lru order and TextureRef can be checked anywhere
+
+namespace {
+const int IMAGE_SIZE = TEXTURE_ATLAS_MAX_ENTRY_SIZE + 64;  // standalone, only those get evicted
+
+namespace mock {
+GLuint next_name = 1;
+std::vector<GLuint> deleted_textures;
+
+// whatever the engine calls that the checks dont care about
+template <typename R, typename... Args>
+R noop(Args...) {
+    return R();
+}
+
+void genNames(GLsizei count, GLuint* names) {
+    for (GLsizei i = 0; i < count; i++) names[i] = next_name++;
+}
+
+void deleteTextures(GLsizei count, const GLuint* names) {
+    deleted_textures.insert(deleted_textures.end(), names, names + count);
+}
+
+GLuint createName() {
+    return next_name++;
+}
+
+// every shader compiles and links
+void getStatus(GLuint, GLenum, GLint* value) {
+    *value = GL_TRUE;
+}
+
+// no buffer storage, so the stream buffers take the orphaning path and never map until used
+void install() {
+    glad_glGenTextures = genNames;
+    glad_glDeleteTextures = deleteTextures;
+    glad_glBindTexture = noop;
+    glad_glTexImage2D = noop;
+    glad_glTexSubImage2D = noop;
+    glad_glTexParameteri = noop;
+    glad_glGetError = noop;
+
+    glad_glGenBuffers = genNames;
+    glad_glDeleteBuffers = noop;
+    glad_glBindBuffer = noop;
+    glad_glBufferData = noop;
+    glad_glGenVertexArrays = genNames;
+    glad_glDeleteVertexArrays = noop;
+    glad_glBindVertexArray = noop;
+    glad_glEnableVertexAttribArray = noop;
+    glad_glVertexAttribPointer = noop;
+    glad_glVertexAttribDivisor = noop;
+
+    glad_glCreateShader = noop;
+    glad_glShaderSource = noop;
+    glad_glCompileShader = noop;
+    glad_glGetShaderiv = getStatus;
+    glad_glDeleteShader = noop;
+    glad_glCreateProgram = createName;
+    glad_glAttachShader = noop;
+    glad_glLinkProgram = noop;
+    glad_glGetProgramiv = getStatus;
+    glad_glDeleteProgram = noop;
+    glad_glGetUniformLocation = noop;
+}
+}  // namespace mock
+
+// removed after main returns, the cache is gone by then
+test::TempFiles images;
+
+std::string writeImage(const std::string& name, bool valid = true) {
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() / ("vsrg-test-cache-" + name + ".ppm");
+
+    // a fresh file every run, so a baked copy from an earlier one is never used
+    std::error_code ec;
+    std::filesystem::remove(getBakedTexturePath(path.string()), ec);
+
+    images.add(path.string());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!valid) {
+        file << "not an image";
+        return path.string();
+    }
+
+    file << "P6\n" << IMAGE_SIZE << " " << IMAGE_SIZE << "\n255\n";
+    std::vector<char> pixels(IMAGE_SIZE * IMAGE_SIZE * 3, static_cast<char>(name[0]));
+    file.write(pixels.data(), pixels.size());
+    return path.string();
+}
+
+void checkCountersAndLru(TextureCache& cache) {
+    std::vector<std::string> paths = {writeImage("a"), writeImage("b"), writeImage("c"),
+                                      writeImage("d")};
+    std::vector<GLuint> names;
+    for (const auto& path : paths) names.push_back(cache.getTexture(path)->texture_id);
+
+    const TextureCacheStats& stats = cache.getStats();
+    check(stats.misses == 4 && stats.hits == 0, "first loads are misses");
+
+    cache.getTexture(paths[0]);
+    cache.getTexture(cache.getHandle(paths[1]));
+    check(stats.misses == 4 && stats.hits == 2, "cached lookups by path and handle are hits");
+
+    // last used order c, a, d, b
+    for (int i : {2, 0, 3, 1}) {
+        cache.processUploads();
+        cache.getTexture(paths[i]);
+    }
+
+    // anything used this frame or the last one is still on its way to the gpu, so with nothing
+    // allowed only c and a can go, oldest first
+    size_t texture_bytes = stats.vram_bytes / paths.size();
+    mock::deleted_textures.clear();
+    cache.setVramBudget(0);
+    check(stats.evictions == 2, "the last two frames are never evicted");
+    check(mock::deleted_textures == std::vector<GLuint>{names[2], names[0]},
+          "evicts in lru order");
+
+    cache.setVramBudget(TEXTURE_VRAM_BUDGET_DEFAULT);
+    cache.processUploads();
+    cache.processUploads();
+
+    mock::deleted_textures.clear();
+    cache.setVramBudget(texture_bytes);
+    check(mock::deleted_textures == std::vector<GLuint>{names[3]}, "evicts down to the budget");
+    check(stats.evictions == 3 && cache.getCachedTextureCount() == 1, "only b is left");
+
+    size_t misses = stats.misses;
+    cache.setVramBudget(TEXTURE_VRAM_BUDGET_DEFAULT);
+    cache.getTexture(paths[2]);
+    check(stats.misses == misses + 1, "an evicted texture loads again");
+
+    cache.clearAll();
+}
+
+void checkReferences(TextureCache& cache) {
+    std::string path = writeImage("ref");
+    cache.getTexture(path);
+
+    {
+        TextureRef ref(&cache, path);
+        TextureRef copy = ref;
+        check(cache.getTexture(path)->reference_count == 2, "refs count on their entry");
+    }
+    check(cache.getTexture(path)->reference_count == 0, "refs take themselves off again");
+
+    // the entry a ref was made on is cleared and the path loads again, the new entry never
+    // counted that ref
+    TextureRef stale(&cache, path);
+    cache.clearAll();
+    cache.getTexture(path);
+    TextureRef fresh(&cache, path);
+    stale.reset();
+    check(cache.getTexture(path)->reference_count == 1, "a ref outliving clearAll is ignored");
+    fresh.reset();
+
+    // same with an async load that fails and is erased, then a good file under the same path
+    std::string broken = writeImage("broken", false);
+    TextureRequest request = cache.loadTextureAsync(broken);
+    TextureRef pending(&cache, broken);
+    for (int frame = 0; frame < 500 && !request.isReady(); frame++) {
+        cache.processUploads();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    check(request.failed(), "a broken image fails to load");
+
+    writeImage("broken");
+    cache.getTexture(broken);
+    TextureRef loaded(&cache, broken);
+    pending.reset();
+    check(cache.getTexture(broken)->reference_count == 1,
+          "a ref outliving a failed upload is ignored");
+}
+}  // namespace
+
+int main() {
+    mock::install();
+
+    {
+        EngineContext context(nullptr);
+        TextureCache cache(&context);
+
+        checkCountersAndLru(cache);
+        checkReferences(cache);
+    }
+
+    if (test::failures == 0) std::cout << "texture cache checks passed" << std::endl;
+    return test::failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/ui/textComponent.hpp"
+
+using namespace vsrg;
+
+// the simd utf-8 decoder against the plain byte at a time one it replaced. short strings, then
+// sequences put right before, on and after the 16 and 32 byte block edges, then random mixes.
+// only the path the engine was built with runs, so the avx2 one needs a build with -mavx2
+
+namespace {
+const size_t MAX_REPORTED = 8;
+const int RANDOM_STRINGS = 100000;
+
+size_t checked = 0;
+size_t failures = 0;
+
+// the scalar decoder, kept as the reference
+std::vector<Charcode> referenceDecode(const std::string& str) {
+    std::vector<Charcode> codepoints;
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(str.data());
+    const unsigned char* end = s + str.size();
+
+    while (s < end) {
+        Charcode codepoint = '?';
+        unsigned char c = *s++;
+
+        if (c < 0x80) {
+            codepoint = c;
+        } else if ((c & 0xE0) == 0xC0) {
+            if (s < end && (s[0] & 0xC0) == 0x80) {
+                codepoint = ((c & 0x1F) << 6) | (s[0] & 0x3F);
+                s += 1;
+            }
+        } else if ((c & 0xF0) == 0xE0) {
+            if (end - s >= 2 && (s[0] & 0xC0) == 0x80 && (s[1] & 0xC0) == 0x80) {
+                codepoint = ((c & 0x0F) << 12) | ((s[0] & 0x3F) << 6) | (s[1] & 0x3F);
+                s += 2;
+            }
+        } else if ((c & 0xF8) == 0xF0) {
+            if (end - s >= 3 && (s[0] & 0xC0) == 0x80 && (s[1] & 0xC0) == 0x80 &&
+                (s[2] & 0xC0) == 0x80) {
+                codepoint = ((c & 0x07) << 18) | ((s[0] & 0x3F) << 12) | ((s[1] & 0x3F) << 6) |
+                            (s[2] & 0x3F);
+                s += 3;
+            }
+        }
+
+        codepoints.push_back(codepoint);
+    }
+    return codepoints;
+}
+
+void report(const std::string& str, const char* what) {
+    if (failures++ >= MAX_REPORTED) return;
+
+    std::cerr << "failed: " << what << " for " << str.size() << " bytes:" << std::hex;
+    for (unsigned char c : str) std::cerr << " " << std::setw(2) << std::setfill('0') << (int)c;
+    std::cerr << std::dec << std::setfill(' ') << std::endl;
+}
+
+// all three overloads. the pointer one gets a buffer with one slot to spare that must stay as it
+// was, the vector one a buffer that already holds something
+void check(const std::string& str) {
+    static std::vector<Charcode> buffer;
+    static std::vector<Charcode> reused = {1, 2, 3};
+    const Charcode SENTINEL = 0xDEAD;
+    checked++;
+
+    std::vector<Charcode> expected = referenceDecode(str);
+
+    buffer.assign(str.size() + 1, SENTINEL);
+    size_t count = TextComponent::decodeUTF8(str, buffer.data());
+    if (count != expected.size() || !std::equal(expected.begin(), expected.end(), buffer.begin())) {
+        report(str, "pointer overload");
+    } else if (buffer[str.size()] != SENTINEL) {
+        report(str, "wrote past str.size() charcodes");
+    }
+
+    TextComponent::decodeUTF8(str, reused);
+    if (reused != expected) report(str, "reused vector overload");
+
+    if (TextComponent::decodeUTF8(str) != expected) report(str, "returning overload");
+}
+
+// a lead below 0xe0 never takes more than the byte after it, the pairs cover those
+void checkShortStrings() {
+    for (int a = 0; a < 256; a++) {
+        check(std::string{(char)a});
+        for (int b = 0; b < 256; b++) {
+            check(std::string{(char)a, (char)b});
+            if (a < 0xE0) continue;
+            for (int c = 0; c < 256; c++) check(std::string{(char)a, (char)b, (char)c});
+        }
+    }
+}
+
+// every piece at every offset from four before to four after the first and second edge of both
+// widths, with the string ending on, just before and just after an edge as well
+void checkBlockEdges() {
+    const std::vector<std::string> pieces = {
+        "\xc3\xa9",          // 2 bytes
+        "\xe3\x81\x82",      // 3 bytes
+        "\xf0\x9f\x8e\xb5",  // 4 bytes
+        "\xc3",              // truncated
+        "\xe3\x81",
+        "\xf0\x9f\x8e",
+        "\x80",              // stray continuation
+        "\xbf\xbf",
+        "\xff",              // never a lead byte
+        "\xf8\x88\x80\x80\x80",
+        "\xc3\x41",          // continuation missing
+        "\xe3\x81\x41",
+        "\xf0\x9f\x8e\x41",
+        "\xe3\x81\x82\xc3\xa9\xf0\x9f\x8e\xb5",
+    };
+
+    for (size_t width : {16, 32}) {
+        for (size_t edge : {width, 2 * width}) {
+            for (size_t offset = edge - 4; offset <= edge + 4; offset++) {
+                for (const auto& piece : pieces) {
+                    std::string str = std::string(offset, 'a') + piece;
+                    check(str);
+                    for (size_t length : {edge - 1, edge, edge + 1, 3 * width, 3 * width + 7}) {
+                        if (length <= str.size()) {
+                            check(str.substr(0, length));
+                        } else {
+                            check(str + std::string(length - str.size(), 'b'));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// every two byte pair right before and across an edge, inside ascii on both sides
+void checkPairsAcrossEdges() {
+    for (size_t edge : {16, 32, 64}) {
+        for (size_t offset : {edge - 2, edge - 1}) {
+            std::string str(edge + 20, 'x');
+            for (int a = 0x80; a < 256; a++) {
+                for (int b = 0; b < 256; b++) {
+                    str[offset] = (char)a;
+                    str[offset + 1] = (char)b;
+                    check(str);
+                }
+            }
+        }
+    }
+}
+
+// ascii runs of any length between valid and broken sequences
+void checkRandomMixes() {
+    const std::vector<std::string> pieces = {"a", "hello world ", "\n", "\xc3\xa9",
+                                             "\xe3\x81\x82", "\xf0\x9f\x8e\xb5", "\x80", "\xff",
+                                             "\xe3\x81", "\xf0\x9f", "\xc3"};
+    std::mt19937 rng(25);
+
+    for (int i = 0; i < RANDOM_STRINGS; i++) {
+        std::string str;
+        int count = rng() % 40;
+        for (int j = 0; j < count; j++) {
+            if (rng() % 3 == 0) {
+                str += std::string(rng() % 70, (char)('A' + rng() % 26));
+            } else {
+                str += pieces[rng() % pieces.size()];
+            }
+        }
+        check(str);
+    }
+}
+}  // namespace
+
+int main() {
+    check("");
+    checkShortStrings();
+    checkBlockEdges();
+    checkPairsAcrossEdges();
+    checkRandomMixes();
+
+    if (failures > 0) {
+        std::cerr << failures << " of " << checked << " strings decoded differently" << std::endl;
+        return 1;
+    }
+    std::cout << checked << " strings decode the same as the scalar reference" << std::endl;
+    return 0;
+}